@@ -0,0 +1,498 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Headless benchmark of the hull force kernel: synthetic hulls in a procedural or recorded wave field, every kernel
+// path the CPU supports, with the results as a table and optionally as JSON for trending.
+
+#include "PerfCounters.h"
+#include "SyntheticHulls.h"
+#include "WaveFields.h"
+#include "HullKernel/HullBVH.h"
+#include "HullKernel/HullForceKernel.h"
+
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace HullBenchmark;
+
+namespace
+{
+	// Wave frames replayed in a loop, at the rate the game ticks buoyancy.
+	const int32_t NumFrames = 32;
+	const float FrameInterval = 1.0f / 60.0f;
+
+	// Recordings made with --record cover an 80 m square at 1 m spacing, enough for every synthetic hull.
+	const HullKernel::FHeightGridLayout RecordingLayout = { -4000.0f, -4000.0f, 100.0f, 81, 81 };
+	const int32_t RecordingFrames = 240;
+	const float RecordingInterval = 1.0f / 30.0f;
+
+	// The synthetic hulls are sampled where they are built.
+	const HullKernel::FAffineTransform IdentityTransform = { { { 1.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f, 0.0f } } };
+
+	struct FOptions
+	{
+		std::vector<EHullShape> Shapes;
+		std::vector<int32_t> Sizes;
+		std::vector<HullKernel::EKernelPath> Paths;
+		std::vector<EForceModel> Models;
+		double MinTime;
+		bool bHierarchy;
+		std::string JsonPath;
+		std::string HeightsPath;
+		std::string RecordPath;
+	};
+
+	struct FResult
+	{
+		EHullShape Shape;
+		int32_t TargetTriangles;
+		int32_t Triangles;
+		int32_t Vertices;
+		HullKernel::EKernelPath Path;
+		EForceModel Model;
+		int64_t Ticks;
+		double Seconds;
+		uint64_t Allocations;
+		uint64_t CacheMisses;
+
+		// Same hull and water for every path and model, so these should agree between the runs of a hull.
+		float SubmergedArea;
+		int32_t AppliedCount;
+	};
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: HullBenchmark [options]\n"
+			"  --shapes box,sphere,ship     Hull shapes to run.\n"
+			"  --sizes 100,1000,...         Approximate triangle counts of every hull.\n"
+			"  --paths scalar,sse,avx2      Kernel paths, the ones the CPU lacks are skipped.\n"
+			"  --models game,buoy,pow       Force models, game by default.\n"
+			"  --min-time <seconds>         Shortest measurement per hull and path, 0.25 by default.\n"
+			"  --no-bvh                     Classify every triangle, without the hierarchy of the hull.\n"
+			"  --quick                      Small hulls and short measurements, to check the build.\n"
+			"  --heights <file>             Replay a recorded wave field instead of the Gerstner ocean.\n"
+			"  --record <file>              Record the Gerstner ocean for --heights and exit.\n"
+			"  --json <file>                Also write the results as JSON, - for stdout.\n");
+	}
+
+	std::vector<std::string> SplitList(const std::string& list)
+	{
+		std::vector<std::string> items;
+		std::stringstream stream(list);
+		std::string item;
+		while (std::getline(stream, item, ','))
+		{
+			if (!item.empty())
+			{
+				items.push_back(item);
+			}
+		}
+		return items;
+	}
+
+	bool ParsePath(const std::string& name, HullKernel::EKernelPath& outPath)
+	{
+		const HullKernel::EKernelPath paths[] = { HullKernel::EKernelPath::Scalar, HullKernel::EKernelPath::SSE, HullKernel::EKernelPath::AVX2 };
+		for (HullKernel::EKernelPath path : paths)
+		{
+			std::string pathName = HullKernel::KernelPathName(path);
+			for (char& c : pathName)
+			{
+				c = static_cast<char>(std::tolower(c));
+			}
+			if (name == pathName)
+			{
+				outPath = path;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool ParseOptions(int argc, char** argv, FOptions& options)
+	{
+		options.Shapes = { EHullShape::Box, EHullShape::Sphere, EHullShape::Ship };
+		options.Sizes = { 100, 1000, 10000, 50000, 200000 };
+		options.Paths = { HullKernel::EKernelPath::Scalar, HullKernel::EKernelPath::SSE, HullKernel::EKernelPath::AVX2 };
+		options.Models = { EForceModel::Game };
+		options.MinTime = 0.25;
+		options.bHierarchy = true;
+
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string option = argv[i];
+			const bool bHasValue = (i + 1) < argc;
+
+			if (option == "--quick")
+			{
+				options.Sizes = { 100, 1000 };
+				options.MinTime = 0.01;
+			}
+			else if (option == "--no-bvh")
+			{
+				options.bHierarchy = false;
+			}
+			else if ((option == "--shapes") && bHasValue)
+			{
+				options.Shapes.clear();
+				for (const std::string& name : SplitList(argv[++i]))
+				{
+					EHullShape shape;
+					if (!ParseHullShape(name, shape))
+					{
+						std::fprintf(stderr, "Unknown hull shape '%s'.\n", name.c_str());
+						return false;
+					}
+					options.Shapes.push_back(shape);
+				}
+			}
+			else if ((option == "--sizes") && bHasValue)
+			{
+				options.Sizes.clear();
+				for (const std::string& size : SplitList(argv[++i]))
+				{
+					const int32_t triangles = std::atoi(size.c_str());
+					if (triangles <= 0)
+					{
+						std::fprintf(stderr, "Invalid hull size '%s'.\n", size.c_str());
+						return false;
+					}
+					options.Sizes.push_back(triangles);
+				}
+			}
+			else if ((option == "--paths") && bHasValue)
+			{
+				options.Paths.clear();
+				for (const std::string& name : SplitList(argv[++i]))
+				{
+					HullKernel::EKernelPath path;
+					if (!ParsePath(name, path))
+					{
+						std::fprintf(stderr, "Unknown kernel path '%s'.\n", name.c_str());
+						return false;
+					}
+					options.Paths.push_back(path);
+				}
+			}
+			else if ((option == "--models") && bHasValue)
+			{
+				options.Models.clear();
+				for (const std::string& name : SplitList(argv[++i]))
+				{
+					EForceModel model;
+					if (!ParseForceModel(name, model))
+					{
+						std::fprintf(stderr, "Unknown force model '%s'.\n", name.c_str());
+						return false;
+					}
+					options.Models.push_back(model);
+				}
+			}
+			else if ((option == "--min-time") && bHasValue)
+			{
+				options.MinTime = std::atof(argv[++i]);
+			}
+			else if ((option == "--heights") && bHasValue)
+			{
+				options.HeightsPath = argv[++i];
+			}
+			else if ((option == "--record") && bHasValue)
+			{
+				options.RecordPath = argv[++i];
+			}
+			else if ((option == "--json") && bHasValue)
+			{
+				options.JsonPath = argv[++i];
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return !options.Shapes.empty() && !options.Sizes.empty() && !options.Paths.empty() && !options.Models.empty();
+	}
+
+	// Per triangle outputs and slamming history the game writes every tick, without the debug only per term forces.
+	struct FForceBuffers
+	{
+		std::vector<uint8_t> Submersion;
+		std::vector<uint8_t> Applied;
+		std::vector<float> Values[10];
+
+		explicit FForceBuffers(int32_t numTriangles) :
+			Submersion(numTriangles), Applied(numTriangles)
+		{
+			for (std::vector<float>& values : Values)
+			{
+				values.resize(numTriangles);
+			}
+		}
+
+		HullKernel::FTriangleForces View()
+		{
+			HullKernel::FTriangleForces out = {};
+			out.Submersion = Submersion.data();
+			out.Applied = Applied.data();
+			out.ForceX = Values[0].data();
+			out.ForceY = Values[1].data();
+			out.ForceZ = Values[2].data();
+			out.CentroidX = Values[3].data();
+			out.CentroidY = Values[4].data();
+			out.CentroidZ = Values[5].data();
+			out.SubmergedAreaHistory = Values[6].data();
+			out.VelocityHistoryX = Values[7].data();
+			out.VelocityHistoryY = Values[8].data();
+			out.VelocityHistoryZ = Values[9].data();
+			return out;
+		}
+	};
+
+	FResult RunCase(EHullShape shape, int32_t targetTriangles, const HullKernel::FHullData& hull, const std::vector<float>& frameHeights,
+		HullKernel::EKernelPath path, EForceModel model, bool bHierarchy, double minTime, FCacheMissCounter& cacheMisses)
+	{
+		HullKernel::FHullView view = { hull.X.data(), hull.Y.data(), hull.Z.data(), hull.Indices.data(),
+			hull.NumVertices(), hull.NumTriangles(), nullptr, nullptr, 0, { 0.0f, 0.0f, 0.0f, 0.0f }, 0.0f, 0.0f };
+		const HullKernel::FBodyState body = CruisingBody(hull);
+		const HullKernel::FForceCoefficients coefficients = ForceModelCoefficients(model);
+		FForceBuffers buffers(hull.NumTriangles());
+		const HullKernel::FTriangleForces out = buffers.View();
+
+		// One pass over the frames first, so the buffers are in cache like in a running game.
+		HullKernel::FKernelSummary summary = {};
+		for (int32_t frame = 0; frame < NumFrames; ++frame)
+		{
+			const float* heights = &frameHeights[static_cast<size_t>(frame) * hull.NumVertices()];
+			if (bHierarchy)
+			{
+				HullKernel::BindHullBVH(view, hull, IdentityTransform, heights);
+			}
+			summary = HullKernel::ComputeHullForces(view, heights, body, coefficients, out, path);
+		}
+
+		// Whole passes over the frames until the minimum time is reached, the clock is only read between passes.
+		// Bounding the water for the hierarchy is part of every tick in the game, so it is measured too.
+		typedef std::chrono::steady_clock FClock;
+		const uint64_t allocationsBefore = AllocationCount();
+		cacheMisses.Start();
+		const FClock::time_point start = FClock::now();
+
+		int64_t ticks = 0;
+		double seconds = 0.0;
+		do
+		{
+			for (int32_t frame = 0; frame < NumFrames; ++frame)
+			{
+				const float* heights = &frameHeights[static_cast<size_t>(frame) * hull.NumVertices()];
+				if (bHierarchy)
+				{
+					HullKernel::BindHullBVH(view, hull, IdentityTransform, heights);
+				}
+				summary = HullKernel::ComputeHullForces(view, heights, body, coefficients, out, path);
+			}
+			ticks += NumFrames;
+			seconds = std::chrono::duration<double>(FClock::now() - start).count();
+		} while (seconds < minTime);
+
+		FResult result;
+		result.CacheMisses = cacheMisses.Stop();
+		result.Allocations = AllocationCount() - allocationsBefore;
+		result.Shape = shape;
+		result.TargetTriangles = targetTriangles;
+		result.Triangles = hull.NumTriangles();
+		result.Vertices = hull.NumVertices();
+		result.Path = path;
+		result.Model = model;
+		result.Ticks = ticks;
+		result.Seconds = seconds;
+		result.SubmergedArea = summary.SubmergedArea;
+		result.AppliedCount = summary.AppliedCount;
+		return result;
+	}
+
+	double TrianglesPerSecond(const FResult& result)
+	{
+		return (static_cast<double>(result.Triangles) * result.Ticks) / result.Seconds;
+	}
+
+	std::string JsonEscape(const std::string& text)
+	{
+		std::string escaped;
+		for (char c : text)
+		{
+			if ((c == '"') || (c == '\\'))
+			{
+				escaped += '\\';
+			}
+			escaped += c;
+		}
+		return escaped;
+	}
+
+	std::string CompilerName()
+	{
+#if defined(__clang__)
+		return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+		return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+		return "msvc " + std::to_string(_MSC_VER);
+#else
+		return "unknown";
+#endif
+	}
+
+	bool WriteJson(const std::string& path, const std::string& waveField, double minTime, bool bHierarchy, bool bCacheMissesAvailable,
+		const std::vector<FResult>& results)
+	{
+		FILE* file = (path == "-") ? stdout : std::fopen(path.c_str(), "w");
+		if (!file)
+		{
+			return false;
+		}
+
+		char timestamp[32];
+		const std::time_t now = std::time(nullptr);
+		std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+		// Cache misses are null rather than zero where the counters cannot be read, so dashboards skip them.
+		std::fprintf(file, "{\n");
+		std::fprintf(file, "  \"benchmark\": \"hull_force_kernel\",\n");
+		std::fprintf(file, "  \"schema\": 2,\n");
+		std::fprintf(file, "  \"timestamp\": \"%s\",\n", timestamp);
+		std::fprintf(file, "  \"compiler\": \"%s\",\n", JsonEscape(CompilerName()).c_str());
+		std::fprintf(file, "  \"best_path\": \"%s\",\n", HullKernel::KernelPathName(HullKernel::DetectKernelPath()));
+		std::fprintf(file, "  \"wave_field\": \"%s\",\n", JsonEscape(waveField).c_str());
+		std::fprintf(file, "  \"min_time_s\": %g,\n", minTime);
+		std::fprintf(file, "  \"hierarchy\": %s,\n", bHierarchy ? "true" : "false");
+		std::fprintf(file, "  \"cache_misses_available\": %s,\n", bCacheMissesAvailable ? "true" : "false");
+		std::fprintf(file, "  \"results\": [\n");
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const FResult& result = results[i];
+			const double trianglesPerSecond = TrianglesPerSecond(result);
+			const double triangles = static_cast<double>(result.Triangles) * result.Ticks;
+
+			std::fprintf(file, "    {\"hull\": \"%s\", \"target_triangles\": %d, \"triangles\": %d, \"vertices\": %d, \"path\": \"%s\", \"model\": \"%s\", ",
+				HullShapeName(result.Shape), result.TargetTriangles, result.Triangles, result.Vertices, HullKernel::KernelPathName(result.Path),
+				ForceModelName(result.Model));
+			std::fprintf(file, "\"ticks\": %lld, \"seconds\": %.6f, \"triangles_per_second\": %.0f, \"ns_per_triangle\": %.4f, \"allocations\": %llu, ",
+				static_cast<long long>(result.Ticks), result.Seconds, trianglesPerSecond, 1e9 / trianglesPerSecond,
+				static_cast<unsigned long long>(result.Allocations));
+			if (bCacheMissesAvailable)
+			{
+				std::fprintf(file, "\"cache_misses\": %llu, \"cache_misses_per_triangle\": %.6f, ",
+					static_cast<unsigned long long>(result.CacheMisses), result.CacheMisses / triangles);
+			}
+			else
+			{
+				std::fprintf(file, "\"cache_misses\": null, \"cache_misses_per_triangle\": null, ");
+			}
+			std::fprintf(file, "\"submerged_area_m2\": %.4f, \"applied_triangles\": %d}%s\n",
+				result.SubmergedArea, result.AppliedCount, ((i + 1) < results.size()) ? "," : "");
+		}
+		std::fprintf(file, "  ]\n}\n");
+
+		return (file == stdout) || (std::fclose(file) == 0);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	FOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	std::unique_ptr<FWaveField> field;
+	if (options.HeightsPath.empty())
+	{
+		field.reset(new FProceduralWaveField());
+	}
+	else
+	{
+		FRecordedWaveField* recorded = new FRecordedWaveField();
+		field.reset(recorded);
+		if (!recorded->Load(options.HeightsPath))
+		{
+			std::fprintf(stderr, "Could not load the wave field recording '%s'.\n", options.HeightsPath.c_str());
+			return 1;
+		}
+	}
+
+	if (!options.RecordPath.empty())
+	{
+		if (!RecordWaveField(*field, RecordingLayout, RecordingFrames, RecordingInterval, options.RecordPath))
+		{
+			std::fprintf(stderr, "Could not write the wave field recording '%s'.\n", options.RecordPath.c_str());
+			return 1;
+		}
+		std::printf("Recorded %d frames of %s to %s.\n", RecordingFrames, field->Name().c_str(), options.RecordPath.c_str());
+		return 0;
+	}
+
+	FCacheMissCounter cacheMisses;
+	const HullKernel::EKernelPath bestPath = HullKernel::DetectKernelPath();
+	std::printf("Wave field %s, best kernel path %s, hierarchy %s, cache misses %s.\n", field->Name().c_str(), HullKernel::KernelPathName(bestPath),
+		options.bHierarchy ? "on" : "off", cacheMisses.IsAvailable() ? "counted" : "unavailable");
+	std::printf("%-7s %9s %9s %-7s %-5s %12s %10s %8s %12s\n", "hull", "triangles", "vertices", "path", "model", "tris/s", "ns/tri", "allocs", "misses/tri");
+
+	std::vector<FResult> results;
+	for (EHullShape shape : options.Shapes)
+	{
+		for (int32_t size : options.Sizes)
+		{
+			HullKernel::FHullData hull;
+			BuildSyntheticHull(shape, size, hull);
+
+			// Water under every vertex for every frame, sampled up front so only the kernel is measured.
+			const int32_t numVertices = hull.NumVertices();
+			std::vector<float> frameHeights(static_cast<size_t>(NumFrames) * numVertices);
+			for (int32_t frame = 0; frame < NumFrames; ++frame)
+			{
+				field->SampleHeights(hull.X.data(), hull.Y.data(), numVertices, frame * static_cast<double>(FrameInterval),
+					&frameHeights[static_cast<size_t>(frame) * numVertices]);
+			}
+
+			for (HullKernel::EKernelPath path : options.Paths)
+			{
+				if (static_cast<uint8_t>(path) > static_cast<uint8_t>(bestPath))
+				{
+					continue;
+				}
+
+				for (EForceModel model : options.Models)
+				{
+					const FResult result = RunCase(shape, size, hull, frameHeights, path, model, options.bHierarchy, options.MinTime, cacheMisses);
+					results.push_back(result);
+
+					const double trianglesPerSecond = TrianglesPerSecond(result);
+					char misses[16] = "-";
+					if (cacheMisses.IsAvailable())
+					{
+						std::snprintf(misses, sizeof(misses), "%.4f", result.CacheMisses / (static_cast<double>(result.Triangles) * result.Ticks));
+					}
+					std::printf("%-7s %9d %9d %-7s %-5s %12.4g %10.3f %8llu %12s\n", HullShapeName(shape), result.Triangles, result.Vertices,
+						HullKernel::KernelPathName(path), ForceModelName(model), trianglesPerSecond, 1e9 / trianglesPerSecond,
+						static_cast<unsigned long long>(result.Allocations), misses);
+				}
+			}
+		}
+	}
+
+	if (!options.JsonPath.empty() && !WriteJson(options.JsonPath, field->Name(), options.MinTime, options.bHierarchy, cacheMisses.IsAvailable(), results))
+	{
+		std::fprintf(stderr, "Could not write the results to '%s'.\n", options.JsonPath.c_str());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,627 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Headless replay of a buoyancy.Capture recording: every captured step goes through the vertex transform and the hull
+// kernel again, on every kernel path the CPU supports, and the forces are compared against the ones the game got.
+
+#include "MappedFile.h"
+#include "PerfCounters.h"
+#include "SyntheticHulls.h"
+#include "WaveFields.h"
+#include "HullKernel/HullBVH.h"
+#include "HullKernel/HullCapture.h"
+#include "HullKernel/HullForceBatch.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace HullBenchmark;
+
+namespace
+{
+	// Synthetic captures made with --synthesize: a few boats drifting through the Gerstner ocean at the game's step rate.
+	const int32_t SyntheticSteps = 240;
+	const double SyntheticStepInterval = 1.0 / 60.0;
+
+	struct FOptions
+	{
+		std::string CapturePath;
+		std::string SynthesizePath;
+		std::vector<HullKernel::EKernelPath> Paths;
+		double MinTime;
+		double Tolerance;
+	};
+
+	struct FStepRef
+	{
+		const HullKernel::FCaptureStep* Step;
+		const float* WaterHeights;
+
+		// Triangle history a seed step left, the replay takes it over instead of running the step.
+		const float* SeedHistory;
+	};
+
+	// Slamming history of one body, carried from step to step like the game does.
+	struct FBodyHistory
+	{
+		uint32_t Hull;
+		std::vector<float> Values[4];
+
+		void Reset(uint32_t hull)
+		{
+			Hull = hull;
+			for (std::vector<float>& values : Values)
+			{
+				std::fill(values.begin(), values.end(), 0.0f);
+			}
+		}
+	};
+
+	struct FCapture
+	{
+		HullKernel::FCaptureHeader Header;
+		std::map<uint32_t, std::string> BodyNames;
+		std::map<uint32_t, HullKernel::FHullData> Hulls;
+		std::vector<FStepRef> Steps;
+		int32_t SeedSteps;
+		int64_t Triangles;
+		int32_t MaxVertices;
+		int32_t MaxTriangles;
+		int32_t Invalid;
+		bool bTruncated;
+	};
+
+	struct FReplayResult
+	{
+		HullKernel::EKernelPath Path;
+		int32_t ExactSteps;
+		int32_t CountMismatches;
+		double MaxForceError;
+		double MaxTorqueError;
+		double MaxAreaError;
+
+		// First step that is not bit exact, -1 when there is none.
+		int32_t FirstDivergence;
+
+		int32_t Passes;
+		double Seconds;
+	};
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: HullReplay <capture> [options]\n"
+			"  --paths scalar,sse,avx2      Kernel paths to replay with, the ones the CPU lacks are skipped.\n"
+			"  --min-time <seconds>         Replay the capture until this much time passed per path, 0 by default.\n"
+			"  --tolerance <fraction>       Largest relative force difference of a path other than the recorded one, 1e-4 by default.\n"
+			"  --synthesize <file>          Write a capture of synthetic hulls in the Gerstner ocean instead, and exit.\n"
+			"Exits with 2 when the recorded path does not reproduce the capture bit for bit, or another path strays past the tolerance.\n");
+	}
+
+	std::vector<std::string> SplitList(const std::string& list)
+	{
+		std::vector<std::string> items;
+		std::stringstream stream(list);
+		std::string item;
+		while (std::getline(stream, item, ','))
+		{
+			if (!item.empty())
+			{
+				items.push_back(item);
+			}
+		}
+		return items;
+	}
+
+	bool ParsePath(const std::string& name, HullKernel::EKernelPath& outPath)
+	{
+		const HullKernel::EKernelPath paths[] = { HullKernel::EKernelPath::Scalar, HullKernel::EKernelPath::SSE, HullKernel::EKernelPath::AVX2 };
+		for (HullKernel::EKernelPath path : paths)
+		{
+			std::string pathName = HullKernel::KernelPathName(path);
+			for (char& c : pathName)
+			{
+				c = static_cast<char>(std::tolower(c));
+			}
+			if (name == pathName)
+			{
+				outPath = path;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool ParseOptions(int argc, char** argv, FOptions& options)
+	{
+		options.Paths = { HullKernel::EKernelPath::Scalar, HullKernel::EKernelPath::SSE, HullKernel::EKernelPath::AVX2 };
+		options.MinTime = 0.0;
+		options.Tolerance = 1e-4;
+
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string option = argv[i];
+			const bool bHasValue = (i + 1) < argc;
+
+			if ((option == "--paths") && bHasValue)
+			{
+				options.Paths.clear();
+				for (const std::string& name : SplitList(argv[++i]))
+				{
+					HullKernel::EKernelPath path;
+					if (!ParsePath(name, path))
+					{
+						std::fprintf(stderr, "Unknown kernel path '%s'.\n", name.c_str());
+						return false;
+					}
+					options.Paths.push_back(path);
+				}
+			}
+			else if ((option == "--min-time") && bHasValue)
+			{
+				options.MinTime = std::atof(argv[++i]);
+			}
+			else if ((option == "--tolerance") && bHasValue)
+			{
+				options.Tolerance = std::atof(argv[++i]);
+			}
+			else if ((option == "--synthesize") && bHasValue)
+			{
+				options.SynthesizePath = argv[++i];
+			}
+			else if ((option[0] != '-') && options.CapturePath.empty())
+			{
+				options.CapturePath = option;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return (!options.CapturePath.empty() || !options.SynthesizePath.empty()) && !options.Paths.empty();
+	}
+
+	// Per triangle outputs of the kernel, without the debug only per term forces.
+	struct FForceBuffers
+	{
+		std::vector<uint8_t> Submersion;
+		std::vector<uint8_t> Applied;
+		std::vector<float> Values[6];
+
+		explicit FForceBuffers(int32_t numTriangles) :
+			Submersion(numTriangles), Applied(numTriangles)
+		{
+			for (std::vector<float>& values : Values)
+			{
+				values.resize(numTriangles);
+			}
+		}
+
+		HullKernel::FTriangleForces View()
+		{
+			HullKernel::FTriangleForces out = {};
+			out.Submersion = Submersion.data();
+			out.Applied = Applied.data();
+			out.ForceX = Values[0].data();
+			out.ForceY = Values[1].data();
+			out.ForceZ = Values[2].data();
+			out.CentroidX = Values[3].data();
+			out.CentroidY = Values[4].data();
+			out.CentroidZ = Values[5].data();
+			return out;
+		}
+	};
+
+	// Vertices of the body in the world, and the buffers the kernel writes, sized for the largest hull of the capture.
+	struct FReplayBuffers
+	{
+		std::vector<float> X;
+		std::vector<float> Y;
+		std::vector<float> Z;
+		FForceBuffers Forces;
+
+		FReplayBuffers(int32_t numVertices, int32_t numTriangles) :
+			X(numVertices), Y(numVertices), Z(numVertices), Forces(numTriangles)
+		{
+		}
+	};
+
+	// The pipeline of one step the way the game ran it. Chunked steps are summed chunk by chunk in chunk order,
+	// exactly like ComputeHullChunk and ReduceHullChunks do for the scheduler, but on the requested path.
+	// The body's history starts over when its hull changes, like the game does on a LOD switch.
+	HullKernel::FKernelSummary ReplayStep(const HullKernel::FCaptureStep& step, const float* waterHeights, const HullKernel::FHullData& hull,
+		HullKernel::EKernelPath path, FReplayBuffers& buffers, FBodyHistory& history)
+	{
+		if (history.Hull != step.Hull)
+		{
+			history.Reset(step.Hull);
+		}
+
+		const int32_t numVertices = step.NumVertices;
+		HullKernel::TransformVertices(step.Transform, hull.X.data(), hull.Y.data(), hull.Z.data(), numVertices,
+			buffers.X.data(), buffers.Y.data(), buffers.Z.data(), path);
+
+		HullKernel::FHullJob job;
+		job.Hull = { buffers.X.data(), buffers.Y.data(), buffers.Z.data(), hull.Indices.data(),
+			numVertices, hull.NumTriangles(), nullptr, nullptr, 0, { 0.0f, 0.0f, 0.0f, 0.0f }, 0.0f, 0.0f };
+		job.WaterHeights = waterHeights;
+		HullKernel::BindHullBVH(job.Hull, hull, step.Transform, waterHeights);
+		job.Body = step.BodyState;
+		job.Coefficients = step.Coefficients;
+		job.Out = buffers.Forces.View();
+		job.Out.SubmergedAreaHistory = history.Values[0].data();
+		job.Out.VelocityHistoryX = history.Values[1].data();
+		job.Out.VelocityHistoryY = history.Values[2].data();
+		job.Out.VelocityHistoryZ = history.Values[3].data();
+
+		if ((step.Flags & HullKernel::CaptureStepChunked) == 0)
+		{
+			return HullKernel::ComputeHullForces(job.Hull, job.WaterHeights, job.Body, job.Coefficients, job.Out, path);
+		}
+
+		HullKernel::FKernelSummary summary = {};
+		for (int32_t begin = 0; begin < job.Hull.NumTriangles; begin += HullKernel::HullChunkTriangles)
+		{
+			HullKernel::FKernelSummary chunk = {};
+			HullKernel::ComputeHullForcesRange(job.Hull, job.WaterHeights, job.Body, job.Coefficients, job.Out, begin,
+				std::min(begin + HullKernel::HullChunkTriangles, job.Hull.NumTriangles), chunk, path);
+			HullKernel::AccumulateSummary(summary, chunk);
+		}
+		return summary;
+	}
+
+	bool LoadCapture(const FMappedFile& file, FCapture& outCapture)
+	{
+		HullKernel::FHullCaptureReader reader;
+		if (!reader.Open(file.Data(), file.Size()))
+		{
+			return false;
+		}
+
+		outCapture.Header = reader.Header();
+		outCapture.Triangles = 0;
+		outCapture.MaxVertices = 0;
+		outCapture.MaxTriangles = 0;
+		outCapture.Invalid = 0;
+		outCapture.SeedSteps = 0;
+
+		// Latest step of every body, a History chunk belongs to it.
+		std::map<uint32_t, size_t> lastSteps;
+
+		while (reader.Next())
+		{
+			uint32_t id;
+			switch (reader.Type())
+			{
+			case HullKernel::ECaptureChunk::Body:
+			{
+				std::string name;
+				if (reader.ReadBody(id, name))
+				{
+					outCapture.BodyNames[id] = name;
+				}
+				break;
+			}
+			case HullKernel::ECaptureChunk::Hull:
+			{
+				HullKernel::FHullData hull;
+				if (reader.ReadHull(id, hull))
+				{
+					outCapture.MaxVertices = std::max(outCapture.MaxVertices, hull.NumVertices());
+					outCapture.MaxTriangles = std::max(outCapture.MaxTriangles, hull.NumTriangles());
+					outCapture.Hulls[id] = std::move(hull);
+				}
+				break;
+			}
+			case HullKernel::ECaptureChunk::Step:
+			{
+				// Steps whose hull is missing or does not match are counted and left out of the replay.
+				FStepRef step;
+				const auto hull = reader.ReadStep(step.Step, step.WaterHeights) ? outCapture.Hulls.find(step.Step->Hull) : outCapture.Hulls.end();
+				if ((hull == outCapture.Hulls.end()) || (hull->second.NumVertices() != step.Step->NumVertices))
+				{
+					++outCapture.Invalid;
+					break;
+				}
+				step.SeedHistory = nullptr;
+				lastSteps[step.Step->Body] = outCapture.Steps.size();
+				outCapture.Steps.push_back(step);
+				if ((step.Step->Flags & HullKernel::CaptureStepSeed) != 0)
+				{
+					++outCapture.SeedSteps;
+				}
+				else
+				{
+					outCapture.Triangles += hull->second.NumTriangles();
+				}
+				break;
+			}
+			case HullKernel::ECaptureChunk::History:
+			{
+				const HullKernel::FCaptureHistory* history;
+				const float* arrays;
+				const auto last = reader.ReadHistory(history, arrays) ? lastSteps.find(history->Body) : lastSteps.end();
+				if (last != lastSteps.end())
+				{
+					FStepRef& step = outCapture.Steps[last->second];
+					if (outCapture.Hulls.at(step.Step->Hull).NumTriangles() == history->NumTriangles)
+					{
+						step.SeedHistory = arrays;
+					}
+				}
+				break;
+			}
+			default:
+				break;
+			}
+		}
+
+		outCapture.bTruncated = reader.IsTruncated();
+		return true;
+	}
+
+	// Length of the difference of two 3 vectors relative to the length of the recorded one, absolute below 1.
+	double RelativeError(const float* recorded, const float* replayed)
+	{
+		double difference = 0.0;
+		double length = 0.0;
+		for (int32_t axis = 0; axis < 3; ++axis)
+		{
+			const double delta = static_cast<double>(replayed[axis]) - recorded[axis];
+			difference += delta * delta;
+			length += static_cast<double>(recorded[axis]) * recorded[axis];
+		}
+		return std::sqrt(difference) / std::max(std::sqrt(length), 1.0);
+	}
+
+	FReplayResult Replay(const FCapture& capture, HullKernel::EKernelPath path, double minTime, FReplayBuffers& buffers,
+		std::map<uint32_t, FBodyHistory>& histories)
+	{
+		FReplayResult result = {};
+		result.Path = path;
+		result.FirstDivergence = -1;
+
+		// The first pass compares, the ones after it only repeat the work for a steadier time.
+		typedef std::chrono::steady_clock FClock;
+		const FClock::time_point start = FClock::now();
+		do
+		{
+			const bool bCompare = (result.Passes == 0);
+			for (std::pair<const uint32_t, FBodyHistory>& history : histories)
+			{
+				history.second.Reset(UINT32_MAX);
+			}
+
+			for (size_t i = 0; i < capture.Steps.size(); ++i)
+			{
+				const HullKernel::FCaptureStep& step = *capture.Steps[i].Step;
+				const HullKernel::FHullData& hull = capture.Hulls.at(step.Hull);
+				FBodyHistory& history = histories.at(step.Body);
+
+				// A seed step only hands its history on, the one it started from was never recorded.
+				if ((step.Flags & HullKernel::CaptureStepSeed) != 0)
+				{
+					history.Reset(step.Hull);
+					const size_t numTriangles = static_cast<size_t>(hull.NumTriangles());
+					for (size_t array = 0; capture.Steps[i].SeedHistory && (array < 4); ++array)
+					{
+						std::copy(capture.Steps[i].SeedHistory + (array * numTriangles), capture.Steps[i].SeedHistory + ((array + 1) * numTriangles),
+							history.Values[array].begin());
+					}
+					continue;
+				}
+
+				const HullKernel::FKernelSummary summary = ReplayStep(step, capture.Steps[i].WaterHeights, hull, path, buffers, history);
+				if (!bCompare)
+				{
+					continue;
+				}
+
+				if (std::memcmp(&summary, &step.Summary, sizeof(summary)) == 0)
+				{
+					++result.ExactSteps;
+					continue;
+				}
+				if (result.FirstDivergence < 0)
+				{
+					result.FirstDivergence = static_cast<int32_t>(i);
+				}
+
+				result.MaxForceError = std::max(result.MaxForceError, RelativeError(step.Summary.Wrench.Force, summary.Wrench.Force));
+				result.MaxTorqueError = std::max(result.MaxTorqueError, RelativeError(step.Summary.Wrench.Torque, summary.Wrench.Torque));
+				result.MaxAreaError = std::max(result.MaxAreaError, std::fabs(static_cast<double>(summary.SubmergedArea) - step.Summary.SubmergedArea));
+				if ((std::memcmp(summary.SubmersionCounts, step.Summary.SubmersionCounts, sizeof(summary.SubmersionCounts)) != 0)
+					|| (summary.AppliedCount != step.Summary.AppliedCount))
+				{
+					++result.CountMismatches;
+				}
+			}
+			++result.Passes;
+			result.Seconds = std::chrono::duration<double>(FClock::now() - start).count();
+		} while (result.Seconds < minTime);
+
+		return result;
+	}
+
+	// A box, a sphere and a ship of increasing detail, heaving, rolling and drifting through the Gerstner ocean.
+	// The box floats with the buoy model, the others with the game's.
+	bool Synthesize(const std::string& path)
+	{
+		const EHullShape shapes[] = { EHullShape::Box, EHullShape::Sphere, EHullShape::Ship };
+		const int32_t sizes[] = { 1000, 5000, 20000 };
+		const int32_t numBodies = 3;
+
+		HullKernel::FHullCaptureWriter writer;
+		if (!writer.Open(path.c_str(), HullKernel::DetectKernelPath()))
+		{
+			return false;
+		}
+
+		HullKernel::FHullData hulls[numBodies];
+		for (int32_t body = 0; body < numBodies; ++body)
+		{
+			BuildSyntheticHull(shapes[body], sizes[body], hulls[body]);
+			writer.WriteBody(body, (std::string(HullShapeName(shapes[body])) + std::to_string(body)).c_str());
+			writer.WriteHull(body, hulls[body]);
+		}
+
+		const FProceduralWaveField field;
+		FReplayBuffers buffers(hulls[numBodies - 1].NumVertices(), hulls[numBodies - 1].NumTriangles());
+		std::vector<float> waterHeights(hulls[numBodies - 1].NumVertices());
+		FBodyHistory histories[numBodies];
+		for (FBodyHistory& history : histories)
+		{
+			for (std::vector<float>& values : history.Values)
+			{
+				values.resize(hulls[numBodies - 1].NumTriangles());
+			}
+			history.Reset(UINT32_MAX);
+		}
+
+		for (int32_t stepIndex = 0; stepIndex < SyntheticSteps; ++stepIndex)
+		{
+			const double time = stepIndex * SyntheticStepInterval;
+			for (int32_t body = 0; body < numBodies; ++body)
+			{
+				const HullKernel::FHullData& hull = hulls[body];
+
+				// Yaw plus a little roll, 2000 cm apart along Y, moving along X at 5 m/s.
+				const float yaw = 0.3f * body + (0.05f * static_cast<float>(time));
+				const float roll = 0.08f * std::sin(static_cast<float>(time) * 1.3f + body);
+				const float cosYaw = std::cos(yaw);
+				const float sinYaw = std::sin(yaw);
+				const float cosRoll = std::cos(roll);
+				const float sinRoll = std::sin(roll);
+
+				HullKernel::FCaptureStep step = {};
+				step.Time = time;
+				step.Body = body;
+				step.Hull = body;
+				step.Transform = { {
+					{ cosYaw, -sinYaw * cosRoll, sinYaw * sinRoll, 500.0f * static_cast<float>(time) },
+					{ sinYaw, cosYaw * cosRoll, -cosYaw * sinRoll, 4000.0f * body },
+					{ 0.0f, sinRoll, cosRoll, 20.0f * std::sin(static_cast<float>(time) * 0.7f) } } };
+				step.BodyState = CruisingBody(hull);
+				step.Coefficients = ForceModelCoefficients((body == 0) ? EForceModel::Buoy : EForceModel::Game);
+				step.BodyState.TimeStep = (stepIndex > 0) ? static_cast<float>(SyntheticStepInterval) : 0.0f;
+				step.BodyState.CenterOfMass[0] = step.Transform.M[0][3];
+				step.BodyState.CenterOfMass[1] = step.Transform.M[1][3];
+				step.BodyState.CenterOfMass[2] = step.Transform.M[2][3];
+				step.NumVertices = hull.NumVertices();
+				step.Flags = (body != 0) ? HullKernel::CaptureStepChunked : 0;
+
+				HullKernel::TransformVertices(step.Transform, hull.X.data(), hull.Y.data(), hull.Z.data(), step.NumVertices,
+					buffers.X.data(), buffers.Y.data(), buffers.Z.data());
+				field.SampleHeights(buffers.X.data(), buffers.Y.data(), step.NumVertices, time, waterHeights.data());
+
+				step.Summary = ReplayStep(step, waterHeights.data(), hull, HullKernel::EKernelPath::Auto, buffers, histories[body]);
+				writer.WriteStep(step, waterHeights.data());
+			}
+		}
+		return writer.Close();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	FOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	if (!options.SynthesizePath.empty())
+	{
+		if (!Synthesize(options.SynthesizePath))
+		{
+			std::fprintf(stderr, "Could not write the capture '%s'.\n", options.SynthesizePath.c_str());
+			return 1;
+		}
+		std::printf("Synthesized %d steps to %s.\n", SyntheticSteps, options.SynthesizePath.c_str());
+		return 0;
+	}
+
+	FMappedFile file;
+	FCapture capture;
+	if (!file.Open(options.CapturePath.c_str()) || !LoadCapture(file, capture))
+	{
+		std::fprintf(stderr, "Could not load the capture '%s'.\n", options.CapturePath.c_str());
+		return 1;
+	}
+
+	const HullKernel::EKernelPath recordedPath = static_cast<HullKernel::EKernelPath>(capture.Header.Path);
+	const HullKernel::EKernelPath bestPath = HullKernel::DetectKernelPath();
+	std::printf("Capture %s: %.1f MB, %zu steps of %zu bodies on %zu hulls, %lld triangles, recorded with %s.\n",
+		options.CapturePath.c_str(), file.Size() / (1024.0 * 1024.0), capture.Steps.size(), capture.BodyNames.size(), capture.Hulls.size(),
+		static_cast<long long>(capture.Triangles), HullKernel::KernelPathName(recordedPath));
+	if (capture.SeedSteps > 0)
+	{
+		std::printf("%d steps only seed the slamming history of their body, the first one of each body in the capture.\n", capture.SeedSteps);
+	}
+	if (capture.Invalid > 0)
+	{
+		std::printf("%d steps skipped, their hull is missing or does not match.\n", capture.Invalid);
+	}
+	if (capture.bTruncated)
+	{
+		std::printf("The capture is cut short, the steps up to the cut are replayed.\n");
+	}
+	if (capture.Steps.empty())
+	{
+		return 0;
+	}
+
+	std::printf("%-7s %9s %9s %12s %12s %12s %10s %10s %10s\n", "path", "exact", "counts", "force err", "torque err", "area err", "us/step", "ns/tri", "steps/s");
+
+	FReplayBuffers buffers(capture.MaxVertices, capture.MaxTriangles);
+	std::map<uint32_t, FBodyHistory> histories;
+	for (const FStepRef& step : capture.Steps)
+	{
+		FBodyHistory& history = histories[step.Step->Body];
+		for (std::vector<float>& values : history.Values)
+		{
+			values.resize(capture.MaxTriangles);
+		}
+	}
+	const uint64_t allocationsBefore = AllocationCount();
+	bool bDiverged = false;
+	for (HullKernel::EKernelPath path : options.Paths)
+	{
+		if (static_cast<uint8_t>(path) > static_cast<uint8_t>(bestPath))
+		{
+			continue;
+		}
+
+		const FReplayResult result = Replay(capture, path, options.MinTime, buffers, histories);
+		const double steps = static_cast<double>(capture.Steps.size() - capture.SeedSteps) * result.Passes;
+		const double triangles = static_cast<double>(capture.Triangles) * result.Passes;
+		std::printf("%-7s %9d %9d %12.3g %12.3g %12.3g %10.3f %10.3f %10.0f\n", HullKernel::KernelPathName(path), result.ExactSteps,
+			result.CountMismatches, result.MaxForceError, result.MaxTorqueError, result.MaxAreaError, (result.Seconds * 1e6) / steps,
+			(result.Seconds * 1e9) / triangles, steps / result.Seconds);
+
+		// The recorded path on the same kind of CPU has to give back exactly what the game got.
+		const bool bPathDiverged = (path == recordedPath) ? (result.FirstDivergence >= 0)
+			: ((result.MaxForceError > options.Tolerance) || (result.MaxTorqueError > options.Tolerance));
+		if (bPathDiverged)
+		{
+			const HullKernel::FCaptureStep& step = *capture.Steps[result.FirstDivergence].Step;
+			const auto name = capture.BodyNames.find(step.Body);
+			std::printf("  diverges from step %d, %s at %.4f s: force recorded %g %g %g\n", result.FirstDivergence,
+				(name != capture.BodyNames.end()) ? name->second.c_str() : "?", step.Time,
+				step.Summary.Wrench.Force[0], step.Summary.Wrench.Force[1], step.Summary.Wrench.Force[2]);
+			bDiverged = true;
+		}
+	}
+
+	std::printf("%llu heap allocations during the replays.\n", static_cast<unsigned long long>(AllocationCount() - allocationsBefore));
+	return bDiverged ? 2 : 0;
+}
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace HullBenchmark
+{
+#if defined(_WIN32)
+	FMappedFile::FMappedFile() :
+		mData(nullptr), mSize(0), mFile(INVALID_HANDLE_VALUE), mMapping(nullptr)
+	{
+	}
+
+	bool FMappedFile::Open(const char* path)
+	{
+		Close();
+
+		mFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		LARGE_INTEGER size;
+		if ((mFile == INVALID_HANDLE_VALUE) || !GetFileSizeEx(mFile, &size) || (size.QuadPart == 0))
+		{
+			Close();
+			return false;
+		}
+
+		mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		mData = mMapping ? static_cast<const uint8_t*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+		if (!mData)
+		{
+			Close();
+			return false;
+		}
+		mSize = static_cast<size_t>(size.QuadPart);
+		return true;
+	}
+
+	void FMappedFile::Close()
+	{
+		if (mData)
+		{
+			UnmapViewOfFile(mData);
+		}
+		if (mMapping)
+		{
+			CloseHandle(mMapping);
+		}
+		if (mFile != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(mFile);
+		}
+		mData = nullptr;
+		mSize = 0;
+		mFile = INVALID_HANDLE_VALUE;
+		mMapping = nullptr;
+	}
+#else
+	FMappedFile::FMappedFile() :
+		mData(nullptr), mSize(0), mFile(-1)
+	{
+	}
+
+	bool FMappedFile::Open(const char* path)
+	{
+		Close();
+
+		mFile = open(path, O_RDONLY);
+		struct stat status;
+		if ((mFile < 0) || (fstat(mFile, &status) != 0) || (status.st_size == 0))
+		{
+			Close();
+			return false;
+		}
+
+		void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, mFile, 0);
+		if (data == MAP_FAILED)
+		{
+			Close();
+			return false;
+		}
+
+		// The chunks are read front to back.
+		madvise(data, static_cast<size_t>(status.st_size), MADV_SEQUENTIAL);
+
+		mData = static_cast<const uint8_t*>(data);
+		mSize = static_cast<size_t>(status.st_size);
+		return true;
+	}
+
+	void FMappedFile::Close()
+	{
+		if (mData)
+		{
+			munmap(const_cast<uint8_t*>(mData), mSize);
+		}
+		if (mFile >= 0)
+		{
+			close(mFile);
+		}
+		mData = nullptr;
+		mSize = 0;
+		mFile = -1;
+	}
+#endif
+
+	FMappedFile::~FMappedFile()
+	{
+		Close();
+	}
+}
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace HullBenchmark
+{
+	/**
+	 * Read only memory mapping of a whole file, so large captures are paged in as they are read instead of loaded.
+	 * The mapping starts page aligned.
+	 */
+	class FMappedFile
+	{
+	public:
+		FMappedFile();
+		~FMappedFile();
+
+		FMappedFile(const FMappedFile&) = delete;
+		FMappedFile& operator=(const FMappedFile&) = delete;
+
+		// Returns false if the file is missing, empty or cannot be mapped.
+		bool Open(const char* path);
+		void Close();
+
+		const uint8_t* Data() const { return mData; }
+		size_t Size() const { return mSize; }
+
+	private:
+		const uint8_t* mData;
+		size_t mSize;
+
+#if defined(_WIN32)
+		void* mFile;
+		void* mMapping;
+#else
+		int mFile;
+#endif
+	};
+}
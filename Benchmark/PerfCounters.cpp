@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PerfCounters.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static std::atomic<uint64_t> Allocations(0);
+
+// Every allocation of the program goes through here, including the ones of the standard library.
+void* operator new(std::size_t size)
+{
+	Allocations.fetch_add(1, std::memory_order_relaxed);
+	void* memory = std::malloc((size > 0) ? size : 1);
+	if (!memory)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+namespace HullBenchmark
+{
+	uint64_t AllocationCount()
+	{
+		return Allocations.load(std::memory_order_relaxed);
+	}
+
+#if defined(__linux__)
+	FCacheMissCounter::FCacheMissCounter()
+	{
+		perf_event_attr attributes;
+		std::memset(&attributes, 0, sizeof(attributes));
+		attributes.type = PERF_TYPE_HARDWARE;
+		attributes.size = sizeof(attributes);
+		attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+		attributes.disabled = 1;
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+
+		// This thread on any CPU.
+		mFile = static_cast<int>(syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0));
+	}
+
+	FCacheMissCounter::~FCacheMissCounter()
+	{
+		if (mFile >= 0)
+		{
+			close(mFile);
+		}
+	}
+
+	void FCacheMissCounter::Start()
+	{
+		if (mFile >= 0)
+		{
+			ioctl(mFile, PERF_EVENT_IOC_RESET, 0);
+			ioctl(mFile, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+
+	uint64_t FCacheMissCounter::Stop()
+	{
+		uint64_t misses = 0;
+		if (mFile >= 0)
+		{
+			ioctl(mFile, PERF_EVENT_IOC_DISABLE, 0);
+			if (read(mFile, &misses, sizeof(misses)) != sizeof(misses))
+			{
+				misses = 0;
+			}
+		}
+		return misses;
+	}
+#else
+	FCacheMissCounter::FCacheMissCounter() :
+		mFile(-1)
+	{
+	}
+
+	FCacheMissCounter::~FCacheMissCounter()
+	{
+	}
+
+	void FCacheMissCounter::Start()
+	{
+	}
+
+	uint64_t FCacheMissCounter::Stop()
+	{
+		return 0;
+	}
+#endif
+}
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+
+namespace HullBenchmark
+{
+	// Calls to the global operator new since the program started, on any thread.
+	uint64_t AllocationCount();
+
+	/**
+	 * Last level cache misses of the calling thread, read from the Linux perf counters.
+	 * Unavailable on other platforms, in containers without perf access and when perf_event_paranoid forbids it.
+	 */
+	class FCacheMissCounter
+	{
+	public:
+		FCacheMissCounter();
+		~FCacheMissCounter();
+
+		FCacheMissCounter(const FCacheMissCounter&) = delete;
+		FCacheMissCounter& operator=(const FCacheMissCounter&) = delete;
+
+		bool IsAvailable() const { return mFile >= 0; }
+
+		// Misses between Start and Stop, zero when unavailable.
+		void Start();
+		uint64_t Stop();
+
+	private:
+		int mFile;
+	};
+}
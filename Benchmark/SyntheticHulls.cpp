@@ -0,0 +1,336 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SyntheticHulls.h"
+#include "HullKernel/HullBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace HullBenchmark
+{
+	static const float Pi = 3.14159265f;
+
+	// Box and ship dimensions (cm), the sphere radius.
+	static const float BoxLength = 2000.0f;
+	static const float BoxWidth = 600.0f;
+	static const float BoxHeight = 300.0f;
+	static const float SphereRadius = 300.0f;
+	static const float ShipLength = 3000.0f;
+	static const float ShipBeam = 600.0f;
+	static const float ShipDepth = 300.0f;
+	static const float ShipDeckHeight = 100.0f;
+
+	namespace
+	{
+		/**
+		 * Grid of (numU + 1) x (numV + 1) points from a parametric surface, two triangles per cell.
+		 * Cells collapsed to a line or a point (poles, pointed bows) lose their degenerate triangles.
+		 */
+		class FSurface
+		{
+		public:
+			template <typename TFunction>
+			FSurface(int32_t numU, int32_t numV, TFunction surface)
+			{
+				for (int32_t v = 0; v <= numV; ++v)
+				{
+					for (int32_t u = 0; u <= numU; ++u)
+					{
+						float point[3];
+						surface(static_cast<float>(u) / numU, static_cast<float>(v) / numV, point);
+						mVertices.insert(mVertices.end(), point, point + 3);
+					}
+				}
+
+				for (int32_t v = 0; v < numV; ++v)
+				{
+					for (int32_t u = 0; u < numU; ++u)
+					{
+						const int32_t corner = (v * (numU + 1)) + u;
+						AddTriangle(corner, corner + 1, corner + numU + 2);
+						AddTriangle(corner, corner + numU + 2, corner + numU + 1);
+					}
+				}
+			}
+
+			// Flips the winding if the normals, as the hull data computes them, point towards center.
+			void OrientOutwards(const float center[3])
+			{
+				double outwards = 0.0;
+				for (size_t i = 0; i < mIndices.size(); i += 3)
+				{
+					float normal[3];
+					float centroid[3];
+					Triangle(i, normal, centroid);
+					outwards += (normal[0] * (centroid[0] - center[0])) + (normal[1] * (centroid[1] - center[1])) + (normal[2] * (centroid[2] - center[2]));
+				}
+
+				if (outwards < 0.0)
+				{
+					for (size_t i = 0; i < mIndices.size(); i += 3)
+					{
+						std::swap(mIndices[i + 1], mIndices[i + 2]);
+					}
+				}
+			}
+
+			void AppendTo(HullKernel::FHullBuilder& builder) const
+			{
+				builder.AppendMesh(mVertices.data(), 3 * sizeof(float), static_cast<int32_t>(mVertices.size() / 3),
+					mIndices.data(), HullKernel::EIndexWidth::Bits32, static_cast<int32_t>(mIndices.size() / 3));
+			}
+
+		private:
+			void AddTriangle(int32_t index1, int32_t index2, int32_t index3)
+			{
+				mIndices.push_back(index1);
+				mIndices.push_back(index2);
+				mIndices.push_back(index3);
+
+				float normal[3];
+				float centroid[3];
+				const float doubleArea = Triangle(mIndices.size() - 3, normal, centroid);
+				if (doubleArea < 1e-3f)
+				{
+					mIndices.resize(mIndices.size() - 3);
+				}
+			}
+
+			// Unnormalized normal in the winding FinalizeHullData uses, returns its length.
+			float Triangle(size_t first, float outNormal[3], float outCentroid[3]) const
+			{
+				const float* v1 = &mVertices[mIndices[first + 0] * 3];
+				const float* v2 = &mVertices[mIndices[first + 1] * 3];
+				const float* v3 = &mVertices[mIndices[first + 2] * 3];
+
+				const float edge1[3] = { v1[0] - v2[0], v1[1] - v2[1], v1[2] - v2[2] };
+				const float edge2[3] = { v2[0] - v3[0], v2[1] - v3[1], v2[2] - v3[2] };
+				outNormal[0] = (edge1[1] * edge2[2]) - (edge1[2] * edge2[1]);
+				outNormal[1] = (edge1[2] * edge2[0]) - (edge1[0] * edge2[2]);
+				outNormal[2] = (edge1[0] * edge2[1]) - (edge1[1] * edge2[0]);
+
+				for (int32_t axis = 0; axis < 3; ++axis)
+				{
+					outCentroid[axis] = (v1[axis] + v2[axis] + v3[axis]) / 3.0f;
+				}
+				return std::sqrt((outNormal[0] * outNormal[0]) + (outNormal[1] * outNormal[1]) + (outNormal[2] * outNormal[2]));
+			}
+
+			std::vector<float> mVertices;
+			std::vector<int32_t> mIndices;
+		};
+
+		int32_t Resolution(double triangles)
+		{
+			return std::max(1, static_cast<int32_t>(std::lround(std::sqrt(triangles))));
+		}
+
+		void BuildBox(int32_t targetTriangles, HullKernel::FHullBuilder& builder)
+		{
+			// Six faces of n x n cells, two triangles each.
+			const int32_t n = Resolution(targetTriangles / 12.0);
+			const float half[3] = { 0.5f * BoxLength, 0.5f * BoxWidth, 0.5f * BoxHeight };
+			const float center[3] = { 0.0f, 0.0f, 0.0f };
+
+			for (int32_t axis = 0; axis < 3; ++axis)
+			{
+				for (int32_t side = -1; side <= 1; side += 2)
+				{
+					const int32_t axisU = (axis + 1) % 3;
+					const int32_t axisV = (axis + 2) % 3;
+					FSurface face(n, n, [&](float u, float v, float* point)
+					{
+						point[axis] = side * half[axis];
+						point[axisU] = ((2.0f * u) - 1.0f) * half[axisU];
+						point[axisV] = ((2.0f * v) - 1.0f) * half[axisV];
+					});
+					face.OrientOutwards(center);
+					face.AppendTo(builder);
+				}
+			}
+		}
+
+		void BuildSphere(int32_t targetTriangles, HullKernel::FHullBuilder& builder)
+		{
+			// Twice as many cells around as from pole to pole, two triangles each minus the pole ones.
+			const int32_t rings = Resolution(targetTriangles / 4.0);
+			const float center[3] = { 0.0f, 0.0f, 0.0f };
+
+			FSurface sphere(2 * rings, rings, [](float u, float v, float* point)
+			{
+				const float azimuth = 2.0f * Pi * u;
+				const float polar = Pi * v;
+				point[0] = SphereRadius * std::sin(polar) * std::cos(azimuth);
+				point[1] = SphereRadius * std::sin(polar) * std::sin(azimuth);
+				point[2] = SphereRadius * std::cos(polar);
+			});
+			sphere.OrientOutwards(center);
+			sphere.AppendTo(builder);
+		}
+
+		// 0 at the bow and the stern, 1 amidships. Clamped, sin(pi) comes out slightly negative in float.
+		float ShipFullness(float u, float power)
+		{
+			return std::pow(std::max(std::sin(Pi * u), 0.0f), power);
+		}
+
+		// Half beam of the ship at u along its length, pointed at the bow and the stern.
+		float ShipHalfBeam(float u)
+		{
+			return 0.5f * ShipBeam * ShipFullness(u, 0.6f);
+		}
+
+		void BuildShip(int32_t targetTriangles, HullKernel::FHullBuilder& builder)
+		{
+			// Hull cells are four times longer than around the section, the deck is a quarter as fine across.
+			// Triangles: 2 * 4n * n for the hull plus 2 * 4n * n / 4 for the deck.
+			const int32_t n = Resolution(targetTriangles / 10.0);
+			const int32_t numLength = 4 * n;
+			const int32_t numDeck = std::max(1, n / 4);
+			const float center[3] = { 0.0f, 0.0f, ShipDeckHeight - (0.5f * ShipDepth) };
+
+			// Round bilge section from the port gunwale down to the keel and up to the starboard one.
+			FSurface hull(numLength, n, [](float u, float v, float* point)
+			{
+				const float angle = Pi * v;
+				const float halfBeam = ShipHalfBeam(u);
+				const float depth = ShipDepth * ShipFullness(u, 0.2f);
+				point[0] = (u - 0.5f) * ShipLength;
+				point[1] = -halfBeam * std::cos(angle);
+				point[2] = ShipDeckHeight - (depth * std::sqrt(std::max(std::sin(angle), 0.0f)));
+			});
+			hull.OrientOutwards(center);
+			hull.AppendTo(builder);
+
+			FSurface deck(numLength, numDeck, [](float u, float v, float* point)
+			{
+				point[0] = (u - 0.5f) * ShipLength;
+				point[1] = ((2.0f * v) - 1.0f) * ShipHalfBeam(u);
+				point[2] = ShipDeckHeight;
+			});
+			deck.OrientOutwards(center);
+			deck.AppendTo(builder);
+		}
+	}
+
+	const char* HullShapeName(EHullShape shape)
+	{
+		switch (shape)
+		{
+		case EHullShape::Box:
+			return "box";
+		case EHullShape::Sphere:
+			return "sphere";
+		case EHullShape::Ship:
+			return "ship";
+		}
+		return "unknown";
+	}
+
+	const char* ForceModelName(EForceModel model)
+	{
+		switch (model)
+		{
+		case EForceModel::Game:
+			return "game";
+		case EForceModel::Buoy:
+			return "buoy";
+		case EForceModel::Pow:
+			return "pow";
+		}
+		return "unknown";
+	}
+
+	bool ParseHullShape(const std::string& name, EHullShape& outShape)
+	{
+		const EHullShape shapes[] = { EHullShape::Box, EHullShape::Sphere, EHullShape::Ship };
+		for (EHullShape shape : shapes)
+		{
+			if (name == HullShapeName(shape))
+			{
+				outShape = shape;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool ParseForceModel(const std::string& name, EForceModel& outModel)
+	{
+		const EForceModel models[] = { EForceModel::Game, EForceModel::Buoy, EForceModel::Pow };
+		for (EForceModel model : models)
+		{
+			if (name == ForceModelName(model))
+			{
+				outModel = model;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void BuildSyntheticHull(EHullShape shape, int32_t targetTriangles, HullKernel::FHullData& outHull)
+	{
+		HullKernel::FHullBuilder builder;
+		switch (shape)
+		{
+		case EHullShape::Box:
+			BuildBox(targetTriangles, builder);
+			break;
+		case EHullShape::Sphere:
+			BuildSphere(targetTriangles, builder);
+			break;
+		case EHullShape::Ship:
+			BuildShip(targetTriangles, builder);
+			break;
+		}
+		builder.Finish(outHull);
+	}
+
+	HullKernel::FForceCoefficients ForceModelCoefficients(EForceModel model)
+	{
+		HullKernel::FForceCoefficients coefficients;
+		coefficients.Terms = HullKernel::ForceTermsAll;
+		coefficients.DensityOfWater = 0.00001f;
+		coefficients.LinearPressureDrag = 2500.0f;
+		coefficients.QuadraticPressureDrag = 2500.0f;
+		coefficients.PressureFalloffPower = 0.5f;
+		coefficients.LinearSuctionDrag = 2500.0f;
+		coefficients.QuadraticSuctionDrag = 2500.0f;
+		coefficients.SuctionFalloffPower = 0.5f;
+		coefficients.SlammingScale = 0.03f;
+		coefficients.SlammingMaxAcceleration = 2000.0f;
+		coefficients.SlammingRampPower = 2.0f;
+
+		if (model == EForceModel::Buoy)
+		{
+			coefficients.Terms = HullKernel::ForceTermViscous;
+		}
+		else if (model == EForceModel::Pow)
+		{
+			coefficients.PressureFalloffPower = 0.6f;
+			coefficients.SuctionFalloffPower = 0.4f;
+		}
+		return coefficients;
+	}
+
+	HullKernel::FBodyState CruisingBody(const HullKernel::FHullData& hull)
+	{
+		HullKernel::FBodyState body = {};
+		body.LinearVelocity[0] = 500.0f;
+		body.LinearVelocity[1] = 20.0f;
+		body.AngularVelocity[0] = 0.05f;
+		body.AngularVelocity[2] = 0.02f;
+		body.Mass = 10000.0f;
+		body.Weight = -980.0f * body.Mass;
+		body.SurfaceArea = hull.SurfaceArea;
+		body.TimeStep = 1.0f / 60.0f;
+
+		// BoatPhysicsUtil::ResistanceCoefficient
+		const float reynoldsNumber = (body.LinearVelocity[0] * hull.LengthOfBoat) / 0.00001002f;
+		const float logReynolds = std::log10(reynoldsNumber) - 2.0f;
+		body.ResistanceCoefficient = 0.075f / (logReynolds * logReynolds);
+		return body;
+	}
+}
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernel/HullData.h"
+#include "HullKernel/HullKernelTypes.h"
+
+#include <string>
+
+namespace HullBenchmark
+{
+	enum class EHullShape : uint8_t
+	{
+		Box,
+		Sphere,
+		Ship
+	};
+
+	// Force terms and falloffs the kernel is specialized on.
+	enum class EForceModel : uint8_t
+	{
+		// Every term with the game's falloff powers of 0.5.
+		Game,
+
+		// Hydrostatic and viscous forces only, like a cheap floating prop.
+		Buoy,
+
+		// Every term with falloff powers that have no fast path.
+		Pow
+	};
+
+	const char* HullShapeName(EHullShape shape);
+	const char* ForceModelName(EForceModel model);
+
+	// Return false for an unknown name.
+	bool ParseHullShape(const std::string& name, EHullShape& outShape);
+	bool ParseForceModel(const std::string& name, EForceModel& outModel);
+
+	/**
+	 * Closed hull of the given shape tessellated to about targetTriangles triangles, with outward facing normals.
+	 * Sizes are in cm around the origin, roughly a 30 m boat, and the origin sits near the waterline so that
+	 * waves cut through the hull instead of leaving it fully dry or submerged.
+	 */
+	void BuildSyntheticHull(EHullShape shape, int32_t targetTriangles, HullKernel::FHullData& outHull);
+
+	// The Game model has the same coefficients as BoatPhysicsUtil, so the kernel takes the branches it takes in game.
+	HullKernel::FForceCoefficients ForceModelCoefficients(EForceModel model);
+
+	// A 10 t boat at 5 m/s, rolling and yawing a little, evaluated at 60 Hz.
+	HullKernel::FBodyState CruisingBody(const HullKernel::FHullData& hull);
+}
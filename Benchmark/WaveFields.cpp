@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveFields.h"
+
+#include <cmath>
+#include <cstdio>
+
+namespace HullBenchmark
+{
+	static const uint32_t RecordingMagic = 0x46485757; // "WWHF"
+	static const uint32_t RecordingVersion = 1;
+
+	// The Gerstner ocean works in metres.
+	static const float CentimetresPerMetre = 100.0f;
+
+	FProceduralWaveField::FProceduralWaveField()
+	{
+		mOcean.Build(HullKernel::DefaultGerstnerSettings());
+	}
+
+	std::string FProceduralWaveField::Name() const
+	{
+		return "gerstner";
+	}
+
+	void FProceduralWaveField::SampleHeights(const float* x, const float* y, int32_t count, double time, float* outHeights) const
+	{
+		// Height at the undisplaced position, like the per vertex WaveWorks queries of the component.
+		std::vector<float> metresX(count);
+		std::vector<float> metresY(count);
+		for (int32_t i = 0; i < count; ++i)
+		{
+			metresX[i] = x[i] / CentimetresPerMetre;
+			metresY[i] = y[i] / CentimetresPerMetre;
+		}
+
+		mOcean.SampleDisplacements(metresX.data(), metresY.data(), count, time, nullptr, nullptr, outHeights);
+		for (int32_t i = 0; i < count; ++i)
+		{
+			outHeights[i] *= CentimetresPerMetre;
+		}
+	}
+
+	FRecordedWaveField::FRecordedWaveField() :
+		mLayout(), mFrameInterval(0.0f), mNumFrames(0)
+	{
+	}
+
+	template <typename T>
+	static bool ReadValue(FILE* file, T& outValue)
+	{
+		return std::fread(&outValue, sizeof(T), 1, file) == 1;
+	}
+
+	template <typename T>
+	static bool WriteValue(FILE* file, const T& value)
+	{
+		return std::fwrite(&value, sizeof(T), 1, file) == 1;
+	}
+
+	bool FRecordedWaveField::Load(const std::string& path)
+	{
+		FILE* file = std::fopen(path.c_str(), "rb");
+		if (!file)
+		{
+			return false;
+		}
+
+		uint32_t magic = 0;
+		uint32_t version = 0;
+		HullKernel::FHeightGridLayout layout;
+		int32_t numFrames = 0;
+		float frameInterval = 0.0f;
+		bool bValid = ReadValue(file, magic) && ReadValue(file, version) && ReadValue(file, layout) && ReadValue(file, numFrames) && ReadValue(file, frameInterval);
+		bValid = bValid && (magic == RecordingMagic) && (version == RecordingVersion) && !layout.IsPerPoint() && (layout.NumX > 0) && (layout.NumY > 0)
+			&& (numFrames > 0) && (frameInterval > 0.0f);
+
+		std::vector<float> frames;
+		if (bValid)
+		{
+			frames.resize(static_cast<size_t>(layout.NumNodes()) * numFrames);
+			bValid = std::fread(frames.data(), sizeof(float), frames.size(), file) == frames.size();
+		}
+		std::fclose(file);
+
+		if (!bValid)
+		{
+			return false;
+		}
+
+		mPath = path;
+		mLayout = layout;
+		mFrameInterval = frameInterval;
+		mNumFrames = numFrames;
+		mFrames.swap(frames);
+		return true;
+	}
+
+	std::string FRecordedWaveField::Name() const
+	{
+		return "recorded:" + mPath;
+	}
+
+	void FRecordedWaveField::SampleHeights(const float* x, const float* y, int32_t count, double time, float* outHeights) const
+	{
+		// Loops over the recording, the last frame blends back into the first.
+		const double position = std::fmod(time / mFrameInterval, static_cast<double>(mNumFrames));
+		const int32_t frame = static_cast<int32_t>(position);
+		const float alpha = static_cast<float>(position - frame);
+		const int32_t frames[2] = { frame, (frame + 1) % mNumFrames };
+
+		std::vector<float> next(count);
+		HullKernel::InterpolateHeightGrid(mLayout, FrameHeights(frames[0]), x, y, count, outHeights);
+		HullKernel::InterpolateHeightGrid(mLayout, FrameHeights(frames[1]), x, y, count, next.data());
+		for (int32_t i = 0; i < count; ++i)
+		{
+			outHeights[i] += alpha * (next[i] - outHeights[i]);
+		}
+	}
+
+	bool RecordWaveField(const FWaveField& field, const HullKernel::FHeightGridLayout& layout, int32_t numFrames, float frameInterval,
+		const std::string& path)
+	{
+		const int32_t numNodes = layout.NumNodes();
+		std::vector<float> nodeX(numNodes);
+		std::vector<float> nodeY(numNodes);
+		std::vector<float> nodeHeights(numNodes);
+		HullKernel::HeightGridNodePositions(layout, nodeX.data(), nodeY.data());
+
+		FILE* file = std::fopen(path.c_str(), "wb");
+		if (!file)
+		{
+			return false;
+		}
+
+		bool bWritten = WriteValue(file, RecordingMagic) && WriteValue(file, RecordingVersion) && WriteValue(file, layout)
+			&& WriteValue(file, numFrames) && WriteValue(file, frameInterval);
+		for (int32_t frame = 0; bWritten && (frame < numFrames); ++frame)
+		{
+			field.SampleHeights(nodeX.data(), nodeY.data(), numNodes, frame * static_cast<double>(frameInterval), nodeHeights.data());
+			bWritten = std::fwrite(nodeHeights.data(), sizeof(float), numNodes, file) == static_cast<size_t>(numNodes);
+		}
+
+		return (std::fclose(file) == 0) && bWritten;
+	}
+}
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernel/GerstnerOcean.h"
+#include "HullKernel/HeightGrid.h"
+
+#include <string>
+#include <vector>
+
+namespace HullBenchmark
+{
+	// Water surface the benchmark hulls float in. Heights and positions are in cm, like the hull kernel.
+	class FWaveField
+	{
+	public:
+		virtual ~FWaveField() {}
+
+		virtual std::string Name() const = 0;
+
+		virtual void SampleHeights(const float* x, const float* y, int32_t count, double time, float* outHeights) const = 0;
+	};
+
+	// The CPU Gerstner ocean the game falls back to without WaveWorks, with its default sea state.
+	class FProceduralWaveField : public FWaveField
+	{
+	public:
+		FProceduralWaveField();
+
+		virtual std::string Name() const override;
+		virtual void SampleHeights(const float* x, const float* y, int32_t count, double time, float* outHeights) const override;
+
+	private:
+		HullKernel::FGerstnerOcean mOcean;
+	};
+
+	/**
+	 * Height grid frames captured at a fixed interval, e.g. from the GPU ocean, played back in a loop.
+	 * Heights are bilinear within a frame and linear between frames.
+	 *
+	 * File layout, native endianness: magic "WWHF", version, FHeightGridLayout, frame count, frame interval (s),
+	 * then NumX * NumY floats per frame, row by row along X.
+	 */
+	class FRecordedWaveField : public FWaveField
+	{
+	public:
+		FRecordedWaveField();
+
+		// Returns false and leaves the field empty if the file is missing or not a recording of this version.
+		bool Load(const std::string& path);
+
+		virtual std::string Name() const override;
+		virtual void SampleHeights(const float* x, const float* y, int32_t count, double time, float* outHeights) const override;
+
+	private:
+		const float* FrameHeights(int32_t frame) const { return &mFrames[static_cast<size_t>(frame) * mLayout.NumNodes()]; }
+
+		std::string mPath;
+		HullKernel::FHeightGridLayout mLayout;
+		float mFrameInterval;
+		int32_t mNumFrames;
+		std::vector<float> mFrames;
+	};
+
+	// Samples field on the nodes of layout every frameInterval seconds and writes the frames in the recorded format.
+	bool RecordWaveField(const FWaveField& field, const HullKernel::FHeightGridLayout& layout, int32_t numFrames, float frameInterval,
+		const std::string& path);
+}
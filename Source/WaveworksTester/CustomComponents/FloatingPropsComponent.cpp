@@ -0,0 +1,336 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "FloatingPropsComponent.h"
+#include "HullKernel/HeightHandoff.h"
+#include "Utility/BuoyancyStats.h"
+
+/**
+ * Hands the displacements of all props from the thread the ocean answers on to the game thread.
+ * Owned through a thread safe shared pointer, so an answer arriving after the component is gone is harmless.
+ */
+class FFloatingPropReadback : public TSharedFromThis<FFloatingPropReadback, ESPMode::ThreadSafe>
+{
+public:
+	// Three displacements (cm) per prop, tagged with the serial of the request.
+	HullKernel::FHeightHandoff Handoff;
+
+	// Serial the next synchronous answer is published with, only touched on the game thread.
+	uint32 SynchronousSerial;
+
+	FFloatingPropReadback() : SynchronousSerial(0)
+	{
+	}
+
+	void OnDisplacements(const FVector4* displacements, int32 num, uint32 serial)
+	{
+		float* out = Handoff.BeginWrite(num * 3);
+		for (int32 i = 0; i < num; ++i)
+		{
+			out[(i * 3) + 0] = displacements[i].X * 100.0f;
+			out[(i * 3) + 1] = displacements[i].Y * 100.0f;
+			out[(i * 3) + 2] = displacements[i].Z * 100.0f;
+		}
+		Handoff.Publish(serial);
+	}
+
+	void OnDisplacementArray(const TArray<FVector4>& displacements)
+	{
+		OnDisplacements(displacements.GetData(), displacements.Num(), SynchronousSerial);
+	}
+};
+
+// Sets default values for this component's properties
+UFloatingPropsComponent::UFloatingPropsComponent()
+{
+	bWantsBeginPlay = true;
+	PrimaryComponentTick.bCanEverTick = true;
+
+	// The instance transforms are written directly every frame, instance bodies would not follow them.
+	SetMobility(EComponentMobility::Movable);
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	WaveWorksActor = nullptr;
+	mNumScatteredProps = 0;
+	mScatterRadius = 5000.0f;
+	mScatterScaleRange = FVector2D(0.8f, 1.2f);
+	mScatterSeed = 0;
+	mDraft = 0.0f;
+	mResponsiveness = 4.0f;
+	mDampingRatio = 0.7f;
+	mFollowHorizontalDisplacement = true;
+
+	mBatcherHandle = INDEX_NONE;
+	mNextSerial = 1;
+	mLastSequence = 0;
+	mPropsVersion = 0;
+	mSamplePointsDirty = true;
+
+	for (FPendingRequest& request : mPendingRequests)
+	{
+		request.Serial = 0;
+		request.PropsVersion = 0;
+	}
+}
+
+void UFloatingPropsComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	mOcean = IOceanQuery::Create(GetWorld(), WaveWorksActor);
+	mReadback = MakeShareable(new FFloatingPropReadback);
+
+	// Asynchronous oceans get every prop in the shared batch of the frame, as one range.
+	if (mOcean->IsSynchronous())
+	{
+		mOnSynchronousDisplacements = FVectorArrayDelegate::CreateThreadSafeSP(mReadback.ToSharedRef(), &FFloatingPropReadback::OnDisplacementArray);
+	}
+	else if (WaveWorksActor)
+	{
+		mBatcher = FOceanSampleBatcher::Get(GetWorld(), WaveWorksActor);
+		mBatcherHandle = mBatcher->Register(FOceanSampleRangeDelegate::CreateThreadSafeSP(mReadback.ToSharedRef(), &FFloatingPropReadback::OnDisplacements));
+	}
+
+	// Instances placed in the editor float from where they were put.
+	const int32 numPlaced = GetInstanceCount();
+	for (int32 i = 0; i < numPlaced; ++i)
+	{
+		const FTransform world = FTransform(PerInstanceSMData[i].Transform) * GetComponentTransform();
+		AddPropState(world.GetLocation(), world.GetRotation(), world.GetScale3D());
+	}
+
+	FRandomStream stream(mScatterSeed);
+	const FVector center = GetComponentLocation();
+	const float seaLevel = mOcean->GetSeaLevel();
+	for (int32 i = 0; i < mNumScatteredProps; ++i)
+	{
+		// Uniform over the disc.
+		const float radius = mScatterRadius * FMath::Sqrt(stream.GetFraction());
+		const float angle = stream.FRandRange(0.0f, 2.0f * PI);
+		const FVector location(center.X + (radius * FMath::Cos(angle)), center.Y + (radius * FMath::Sin(angle)), seaLevel - mDraft);
+		const FQuat rotation(FRotator(0.0f, stream.FRandRange(0.0f, 360.0f), 0.0f));
+		const float scale = stream.FRandRange(mScatterScaleRange.X, mScatterScaleRange.Y);
+		AddProp(FTransform(rotation, location, FVector(scale)));
+	}
+
+	mReadback->Handoff.Reserve(GetNumProps() * 3);
+}
+
+void UFloatingPropsComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (mBatcher.IsValid())
+	{
+		mBatcher->Unregister(mBatcherHandle);
+		mBatcher.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+int32 UFloatingPropsComponent::AddProp(const FTransform& worldTransform)
+{
+	AddInstanceWorldSpace(worldTransform);
+	AddPropState(worldTransform.GetLocation(), worldTransform.GetRotation(), worldTransform.GetScale3D());
+	return GetNumProps() - 1;
+}
+
+void UFloatingPropsComponent::AddPropState(const FVector& location, const FQuat& rotation, const FVector& scale)
+{
+	mRestX.Add(location.X);
+	mRestY.Add(location.Y);
+	mDisplacementX.Add(0.0f);
+	mDisplacementY.Add(0.0f);
+	mDisplacementZ.Add(0.0f);
+	mPositionX.Add(location.X);
+	mPositionY.Add(location.Y);
+	mPositionZ.Add(location.Z);
+	mVelocityX.Add(0.0f);
+	mVelocityY.Add(0.0f);
+	mVelocityZ.Add(0.0f);
+	mRotations.Add(rotation);
+	mScales.Add(scale);
+
+	++mPropsVersion;
+	mSamplePointsDirty = true;
+}
+
+void UFloatingPropsComponent::RemoveProp(int32 index)
+{
+	if (!mRestX.IsValidIndex(index))
+	{
+		return;
+	}
+
+	// Same order as the instances, which shift down as well.
+	RemoveInstance(index);
+	mRestX.RemoveAt(index, 1, false);
+	mRestY.RemoveAt(index, 1, false);
+	mDisplacementX.RemoveAt(index, 1, false);
+	mDisplacementY.RemoveAt(index, 1, false);
+	mDisplacementZ.RemoveAt(index, 1, false);
+	mPositionX.RemoveAt(index, 1, false);
+	mPositionY.RemoveAt(index, 1, false);
+	mPositionZ.RemoveAt(index, 1, false);
+	mVelocityX.RemoveAt(index, 1, false);
+	mVelocityY.RemoveAt(index, 1, false);
+	mVelocityZ.RemoveAt(index, 1, false);
+	mRotations.RemoveAt(index, 1, false);
+	mScales.RemoveAt(index, 1, false);
+
+	++mPropsVersion;
+	mSamplePointsDirty = true;
+}
+
+void UFloatingPropsComponent::AddPropImpulse(int32 index, const FVector& velocityChange)
+{
+	if (mRestX.IsValidIndex(index))
+	{
+		mVelocityX[index] += velocityChange.X;
+		mVelocityY[index] += velocityChange.Y;
+		mVelocityZ[index] += velocityChange.Z;
+	}
+}
+
+FVector UFloatingPropsComponent::GetPropLocation(int32 index) const
+{
+	return mRestX.IsValidIndex(index) ? FVector(mPositionX[index], mPositionY[index], mPositionZ[index]) : FVector::ZeroVector;
+}
+
+// Called every frame
+void UFloatingPropsComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const int32 numProps = GetNumProps();
+	if (!mOcean.IsValid() || (numProps == 0))
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_BuoyancyProps);
+	INC_DWORD_STAT_BY(STAT_BuoyancyPropCount, numProps);
+
+	// The CPU ocean answers right away, so its props follow the water of this frame.
+	RequestDisplacements();
+	ReceiveDisplacements();
+	Integrate(DeltaTime);
+	WriteInstanceTransforms();
+}
+
+void UFloatingPropsComponent::RequestDisplacements()
+{
+	const int32 numProps = GetNumProps();
+	if (mSamplePointsDirty || !mFollowHorizontalDisplacement)
+	{
+		// Props held in place sample where the water above them was carried from by the choppy waves, moved by the
+		// last answer's horizontal displacement: one fixed point iteration of the inversion per request.
+		const float offsetScale = mFollowHorizontalDisplacement ? 0.0f : 1.0f;
+		mSamplePoints.SetNumUninitialized(numProps, false);
+		for (int32 i = 0; i < numProps; ++i)
+		{
+			const float sampleX = mRestX[i] - (offsetScale * mDisplacementX[i]);
+			const float sampleY = mRestY[i] - (offsetScale * mDisplacementY[i]);
+			mSamplePoints[i] = FVector2D(sampleX / 100.0f, sampleY / 100.0f);
+		}
+		mSamplePointsDirty = !mFollowHorizontalDisplacement;
+	}
+
+	uint32 serial;
+	if (mBatcher.IsValid())
+	{
+		FVector2D* points = mBatcher->WritePoints(mBatcherHandle, numProps, serial);
+		FMemory::Memcpy(points, mSamplePoints.GetData(), numProps * sizeof(FVector2D));
+	}
+	else
+	{
+		serial = mNextSerial++;
+		mReadback->SynchronousSerial = serial;
+		mOcean->SampleDisplacements(mSamplePoints, mOnSynchronousDisplacements);
+	}
+
+	FPendingRequest& request = mPendingRequests[serial % PendingRequestSlots];
+	request.Serial = serial;
+	request.PropsVersion = mPropsVersion;
+}
+
+void UFloatingPropsComponent::ReceiveDisplacements()
+{
+	const HullKernel::FHeightSnapshot snapshot = mReadback->Handoff.Acquire();
+	if (snapshot.Sequence == mLastSequence)
+	{
+		return;
+	}
+	mLastSequence = snapshot.Sequence;
+
+	// Answers for a set of props that has changed since would land on the wrong props.
+	const FPendingRequest& request = mPendingRequests[snapshot.Tag % PendingRequestSlots];
+	const int32 numProps = GetNumProps();
+	if ((request.Serial != snapshot.Tag) || (request.PropsVersion != mPropsVersion) || (snapshot.Num != (numProps * 3)))
+	{
+		return;
+	}
+
+	const float* displacements = snapshot.Heights;
+	for (int32 i = 0; i < numProps; ++i)
+	{
+		mDisplacementX[i] = displacements[(i * 3) + 0];
+		mDisplacementY[i] = displacements[(i * 3) + 1];
+		mDisplacementZ[i] = displacements[(i * 3) + 2];
+	}
+}
+
+void UFloatingPropsComponent::Integrate(float DeltaTime)
+{
+	// Implicit Euler on a damped spring towards the displaced water point, stable at any frame time:
+	// v' = (v + dt k (target - p)) / (1 + dt c + dt^2 k), p' = p + dt v'.
+	const float dt = DeltaTime;
+	const float stiffness = mResponsiveness * mResponsiveness;
+	const float damping = 2.0f * mDampingRatio * mResponsiveness;
+	const float velocityScale = 1.0f / (1.0f + (dt * damping) + (dt * dt * stiffness));
+	const float pull = dt * stiffness;
+	const float horizontalScale = mFollowHorizontalDisplacement ? 1.0f : 0.0f;
+	const float surfaceZ = mOcean->GetSeaLevel() - mDraft;
+
+	const int32 numProps = GetNumProps();
+	float* positionX = mPositionX.GetData();
+	float* positionY = mPositionY.GetData();
+	float* positionZ = mPositionZ.GetData();
+	float* velocityX = mVelocityX.GetData();
+	float* velocityY = mVelocityY.GetData();
+	float* velocityZ = mVelocityZ.GetData();
+	const float* restX = mRestX.GetData();
+	const float* restY = mRestY.GetData();
+	const float* displacementX = mDisplacementX.GetData();
+	const float* displacementY = mDisplacementY.GetData();
+	const float* displacementZ = mDisplacementZ.GetData();
+
+	for (int32 i = 0; i < numProps; ++i)
+	{
+		const float targetX = restX[i] + (horizontalScale * displacementX[i]);
+		const float targetY = restY[i] + (horizontalScale * displacementY[i]);
+		const float targetZ = surfaceZ + displacementZ[i];
+
+		velocityX[i] = (velocityX[i] + (pull * (targetX - positionX[i]))) * velocityScale;
+		velocityY[i] = (velocityY[i] + (pull * (targetY - positionY[i]))) * velocityScale;
+		velocityZ[i] = (velocityZ[i] + (pull * (targetZ - positionZ[i]))) * velocityScale;
+
+		positionX[i] += dt * velocityX[i];
+		positionY[i] += dt * velocityY[i];
+		positionZ[i] += dt * velocityZ[i];
+	}
+}
+
+void UFloatingPropsComponent::WriteInstanceTransforms()
+{
+	// Straight into the instance data, one render state update for the whole set instead of one per instance.
+	const FMatrix worldToComponent = GetComponentTransform().ToInverseMatrixWithScale();
+	const int32 numProps = FMath::Min(GetNumProps(), PerInstanceSMData.Num());
+	for (int32 i = 0; i < numProps; ++i)
+	{
+		const FTransform world(mRotations[i], FVector(mPositionX[i], mPositionY[i], mPositionZ[i]), mScales[i]);
+		PerInstanceSMData[i].Transform = world.ToMatrixWithScale() * worldToComponent;
+	}
+
+	UpdateBounds();
+	MarkRenderStateDirty();
+}
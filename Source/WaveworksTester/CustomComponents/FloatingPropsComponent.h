@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Utility/OceanSampleBatcher.h"
+#include "FloatingPropsComponent.generated.h"
+
+class FFloatingPropReadback;
+
+/**
+ * Thousands of small floating props (buoys, debris, flotsam) of one mesh, as instances of this component.
+ * The props have no actors or components of their own. Their state lives in structure-of-arrays, all of them are
+ * sampled as one request per frame and the results go straight into the instance transforms, with one tick and
+ * one render state update for the whole set. Instances placed in the editor float as well.
+ * The props follow the water with a damped spring and ignore each other, use UFloatingSphere or
+ * UWaterPhysicsComponent for anything that has to collide or carry a real hull.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class WAVEWORKSTESTER_API UFloatingPropsComponent : public UInstancedStaticMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UFloatingPropsComponent();
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Adds a prop floating at the world position of the transform, its height is taken from the water. Returns its index.
+	UFUNCTION(BlueprintCallable, Category = "Floating Props")
+	int32 AddProp(const FTransform& worldTransform);
+
+	// Props after it move down one index, like the instances.
+	UFUNCTION(BlueprintCallable, Category = "Floating Props")
+	void RemoveProp(int32 index);
+
+	// Adds velocity (cm/s) to a prop, e.g. from an explosion or a bow wave.
+	UFUNCTION(BlueprintCallable, Category = "Floating Props")
+	void AddPropImpulse(int32 index, const FVector& velocityChange);
+
+	UFUNCTION(BlueprintCallable, Category = "Floating Props")
+	int32 GetNumProps() const { return mRestX.Num(); }
+
+	UFUNCTION(BlueprintCallable, Category = "Floating Props")
+	FVector GetPropLocation(int32 index) const;
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = WaveWorks)
+	AActor* WaveWorksActor;
+
+protected:
+	// Props scattered at random around the component when play begins, on top of the instances placed in the editor.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Floating Props", DisplayName = "Scattered Props", Meta = (ClampMin = "0"))
+	int32 mNumScatteredProps;
+
+	// Radius (cm) of the disc the props are scattered over.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Floating Props", DisplayName = "Scatter Radius", Meta = (ClampMin = "0.0"))
+	float mScatterRadius;
+
+	// Range of the uniform scale of scattered props.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Floating Props", DisplayName = "Scatter Scale Range")
+	FVector2D mScatterScaleRange;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Floating Props", DisplayName = "Scatter Seed")
+	int32 mScatterSeed;
+
+	// Depth (cm) of the prop origins below the surface.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Floating Props", DisplayName = "Draft")
+	float mDraft;
+
+	// Natural frequency (1/s) of the spring pulling the props onto the water, higher follows the waves more closely.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Floating Props", DisplayName = "Responsiveness", Meta = (ClampMin = "0.1"))
+	float mResponsiveness;
+
+	// 1 settles without overshooting, lower values bob.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Floating Props", DisplayName = "Damping Ratio", Meta = (ClampMin = "0.0"))
+	float mDampingRatio;
+
+	// Lets the props drift with the horizontal motion of choppy waves, not only bob up and down. Props that stay put
+	// follow the height of the water right above them instead.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Floating Props", DisplayName = "Follow Horizontal Displacement")
+	bool mFollowHorizontalDisplacement;
+
+private:
+	void AddPropState(const FVector& location, const FQuat& rotation, const FVector& scale);
+
+	// Sends the sample points of every prop, synchronously to the CPU ocean or into the WaveWorks batch.
+	void RequestDisplacements();
+
+	// Takes in the newest displacements, as long as they were requested for the current set of props.
+	void ReceiveDisplacements();
+
+	void Integrate(float DeltaTime);
+
+	void WriteInstanceTransforms();
+
+	struct FPendingRequest
+	{
+		uint32 Serial;
+		uint32 PropsVersion;
+	};
+
+	// More than the batcher can have in flight, so an answer always finds its request.
+	static const int32 PendingRequestSlots = 16;
+
+	TSharedPtr<IOceanQuery> mOcean;
+	TSharedPtr<FOceanSampleBatcher, ESPMode::ThreadSafe> mBatcher;
+	int32 mBatcherHandle;
+	TSharedPtr<FFloatingPropReadback, ESPMode::ThreadSafe> mReadback;
+	FVectorArrayDelegate mOnSynchronousDisplacements;
+
+	FPendingRequest mPendingRequests[PendingRequestSlots];
+	uint32 mNextSerial;
+	uint64 mLastSequence;
+
+	// Bumped whenever props are added or removed, answers for an older set are dropped.
+	uint32 mPropsVersion;
+
+	// Per prop structure-of-arrays. The rest position is the undisplaced point (cm) of the water the prop floats on.
+	TArray<float> mRestX;
+	TArray<float> mRestY;
+
+	// Displacement (cm) of the water at the rest position, from the latest answer.
+	TArray<float> mDisplacementX;
+	TArray<float> mDisplacementY;
+	TArray<float> mDisplacementZ;
+
+	TArray<float> mPositionX;
+	TArray<float> mPositionY;
+	TArray<float> mPositionZ;
+
+	// cm/s
+	TArray<float> mVelocityX;
+	TArray<float> mVelocityY;
+	TArray<float> mVelocityZ;
+
+	TArray<FQuat> mRotations;
+	TArray<FVector> mScales;
+
+	// Sample points (m) of the props, rebuilt when props are added or removed.
+	TArray<FVector2D> mSamplePoints;
+	bool mSamplePointsDirty;
+};
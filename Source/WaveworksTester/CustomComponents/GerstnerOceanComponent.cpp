@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "GerstnerOceanComponent.h"
+
+// Sets default values for this component's properties
+UGerstnerOceanComponent::UGerstnerOceanComponent() :
+	mWindDirection(0.0f), mWindSpeed(8.0f), mDirectionalSpread(45.0f), mAmplitudeScale(1.0f), mChoppiness(0.6f), mSeed(1), mSeaLevel(0.0f), mPreferOverWaveWorks(false)
+{
+	// Only holds data, the ocean is evaluated by whoever samples it.
+	PrimaryComponentTick.bCanEverTick = false;
+
+	mNumWaves = HullKernel::DefaultGerstnerSettings().NumWaves;
+}
+
+TSharedPtr<const HullKernel::FGerstnerOcean> UGerstnerOceanComponent::GetOcean()
+{
+	if (!mOcean.IsValid())
+	{
+		HullKernel::FGerstnerSettings settings;
+		settings.NumWaves = mNumWaves;
+		settings.WindDirection = mWindDirection;
+		settings.WindSpeed = mWindSpeed;
+		settings.DirectionalSpread = mDirectionalSpread;
+		settings.AmplitudeScale = mAmplitudeScale;
+		settings.Choppiness = mChoppiness;
+		settings.Seed = static_cast<uint32>(mSeed);
+
+		mOcean = MakeShareable(new HullKernel::FGerstnerOcean);
+		mOcean->Build(settings);
+	}
+
+	return mOcean;
+}
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "HullKernel/GerstnerOcean.h"
+#include "GerstnerOceanComponent.generated.h"
+
+/**
+ * Sea state of the CPU ocean used instead of WaveWorks where there is no GPU.
+ * Put it next to the WaveWorks component on the ocean actor, the same WaveWorksActor reference then picks it up.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class WAVEWORKSTESTER_API UGerstnerOceanComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UGerstnerOceanComponent();
+
+	// Built on first use, so it does not depend on the BeginPlay order of the actors sampling it.
+	TSharedPtr<const HullKernel::FGerstnerOcean> GetOcean();
+
+	float GetSeaLevel() const { return mSeaLevel; }
+
+	bool PrefersOverWaveWorks() const { return mPreferOverWaveWorks; }
+
+protected:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ocean", DisplayName = "Number Of Waves", Meta = (ClampMin = "1", ClampMax = "64"))
+	int32 mNumWaves;
+
+	// Degrees around Z from the X axis.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ocean", DisplayName = "Wind Direction")
+	float mWindDirection;
+
+	// m/s, sets the dominant wavelength and height.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ocean", DisplayName = "Wind Speed", Meta = (ClampMin = "0.5"))
+	float mWindSpeed;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ocean", DisplayName = "Directional Spread", Meta = (ClampMin = "0.0", ClampMax = "180.0"))
+	float mDirectionalSpread;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ocean", DisplayName = "Amplitude Scale", Meta = (ClampMin = "0.0"))
+	float mAmplitudeScale;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ocean", DisplayName = "Choppiness", Meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float mChoppiness;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ocean", DisplayName = "Seed")
+	int32 mSeed;
+
+	// World height (cm) of the undisturbed surface.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ocean", DisplayName = "Sea Level")
+	float mSeaLevel;
+
+	// Use the CPU ocean even where WaveWorks could run, e.g. for deterministic tests on a workstation.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ocean", DisplayName = "Prefer Over WaveWorks")
+	bool mPreferOverWaveWorks;
+
+private:
+	TSharedPtr<HullKernel::FGerstnerOcean> mOcean;
+};
@@ -1,234 +1,488 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#include "WaveworksTester.h"
-#include "WaterPhysicsComponent.h"
-#include "Utility/BoatPhysicsUtil.h"
-
-//PhysX includes
-#include "PhysicsPublic.h"
-#include "PhysXPublic.h"
-#include "PhysXIncludes.h"
-#include "ThirdParty/PhysX/PhysX_3.4/Include/geometry/PxTriangleMesh.h"
-#include "ThirdParty/PhysX/PxShared/include/foundation/PxSimpleTypes.h"
-
-#include "Components/StaticMeshComponent.h"
-#include "PhysicsEngine/BodySetup.h"
-
-UWaterPhysicsComponent::Tri::Tri(int32 index1, int32 index2, int32 index3) :
-	Index1(index1), Index2(index2), Index3(index3), Submerged(Submersion::None), Area(0.0f)
-{
-}
-
-// Sets default values for this component's properties
-UWaterPhysicsComponent::UWaterPhysicsComponent() :
-	mWaveWorksDisplacementLock(new FCriticalSection), mSurfaceAreaOfBoat(0.0f), mLengthOfBoat(0.0f), mLengthOfSubmerged(0.0f)
-{
-	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
-	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = true;
-	// ...
-}
-
-UWaterPhysicsComponent::~UWaterPhysicsComponent()
-{
-	delete mWaveWorksDisplacementLock;
-}
-
-// Called when the game starts
-void UWaterPhysicsComponent::BeginPlay()
-{
-	Super::BeginPlay();
-
-	UActorComponent* component = WaveWorksActor->GetComponentByClass(UWaveWorksComponent::StaticClass());
-	mWaveWorksComponent = Cast<UWaveWorksComponent>(component);
-
-	mWaveworksDisplacementDelegate = FVectorArrayDelegate::CreateUObject(this, &UWaterPhysicsComponent::OnRecievedWaveWorksDisplacement);
-
-	// Get array of triangles and the number of triangles in the mesh.
-	PxTriangleMesh* triMesh = mMeshComponent->GetBodySetup()->TriMeshes[0];
-
-	const void* triangles = triMesh->getTriangles();
-	const int32 numTris = triMesh->getNbTriangles();
-
-	// Create an array of all triangles present on the mesh.
-	for (int32 triIndex = 0; triIndex < numTris; ++triIndex)
-	{
-		const PxU16* indices = static_cast<const PxU16*>(triangles);
-
-		int32 index1 = indices[(triIndex * 3) + 0];
-		int32 index2 = indices[(triIndex * 3) + 1];
-		int32 index3 = indices[(triIndex * 3) + 2];
-		mTriLocations.Add(Tri(index1, index2, index3));
-	}
-
-	// Calculate total surface area of mesh.
-	CalculateVertexLocations();
-
-	if (mVertices.Num() > 0)
-	{
-		for (auto& tri : mTriLocations)
-		{
-			tri.Area = BoatPhysicsUtil::TriangleArea(mVertices[tri.Index1], mVertices[tri.Index2], mVertices[tri.Index3]) * 1e-4f; // convert area from cm2 to m2 for our calculations
-			mSurfaceAreaOfBoat += tri.Area;
-		}
-	}
-
-	mLengthOfBoat = FVector::Dist(mVertices[mTriLocations[0].Index1], mVertices[mTriLocations[mTriLocations.Num() - 1].Index3]);
-}
-
-// Called every frame
-void UWaterPhysicsComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-{
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-	CalculateWaterIntersection();
-}
-
-void UWaterPhysicsComponent::CalculateWaterIntersection()
-{
-	CalculateVertexLocations();
-	MarkSubmergedTriangles();
-
-#ifdef DRAW_DEBUG
-	for (auto& tri : mTriLocations)
-	{
-#ifdef DRAW_MESH_DEBUG
-		DrawDebugLine(GetWorld(), mVertices[tri.Index1], mVertices[tri.Index2], FColor::Red, false, -1, 0, 1.0f);
-		DrawDebugLine(GetWorld(), mVertices[tri.Index2], mVertices[tri.Index3], FColor::Red, false, -1, 0, 1.0f);
-		DrawDebugLine(GetWorld(), mVertices[tri.Index3], mVertices[tri.Index1], FColor::Red, false, -1, 0, 1.0f);
-
-		// Normals
-		FVector triNormal = ((mVertices[tri.Index1] - mVertices[tri.Index2]) ^ (mVertices[tri.Index2] - mVertices[tri.Index3])).GetSafeNormal();
-
-		FVector centroid((mVertices[tri.Index1].X + mVertices[tri.Index2].X + mVertices[tri.Index3].X) / 3,
-			(mVertices[tri.Index1].Y + mVertices[tri.Index2].Y + mVertices[tri.Index3].Y) / 3,
-			(mVertices[tri.Index1].Z + mVertices[tri.Index2].Z + mVertices[tri.Index3].Z) / 3);
-
-		DrawDebugLine(GetWorld(), centroid, centroid + (100 * triNormal), FColor::Red, false, -1, 0, 2.0f);
-#endif
-
-#ifdef DRAW_PROJECTION_DEBUG
-		if (mWaveworksDisplacements.Num() > 0)
-		{
-			if (tri.Submerged == Submersion::Full)
-			{
-				DrawDebugLine(GetWorld(), FVector(mVertices[tri.Index1].X, mVertices[tri.Index1].Y, mWaveworksDisplacements[tri.Index1]), FVector(mVertices[tri.Index2].X, mVertices[tri.Index2].Y, mWaveworksDisplacements[tri.Index2]), FColor::Red, false, -1, 0, 2.0f);
-				DrawDebugLine(GetWorld(), FVector(mVertices[tri.Index2].X, mVertices[tri.Index2].Y, mWaveworksDisplacements[tri.Index2]), FVector(mVertices[tri.Index3].X, mVertices[tri.Index3].Y, mWaveworksDisplacements[tri.Index3]), FColor::Red, false, -1, 0, 2.0f);
-				DrawDebugLine(GetWorld(), FVector(mVertices[tri.Index3].X, mVertices[tri.Index3].Y, mWaveworksDisplacements[tri.Index3]), FVector(mVertices[tri.Index1].X, mVertices[tri.Index1].Y, mWaveworksDisplacements[tri.Index1]), FColor::Red, false, -1, 0, 2.0f);
-			}
-		}
-#endif
-	}
-#endif
-}
-
-void UWaterPhysicsComponent::CalculateVertexLocations()
-{
-	check(mMeshComponent);
-	check(mMeshComponent->IsValidLowLevel());
-
-	FTransform meshTransform = mMeshComponent->GetComponentTransform();
-
-	// Get the reference to the Triangle Mesh of the MeshComponent.
-	auto triMesh = mMeshComponent->GetBodySetup()->TriMeshes[0];
-	check(triMesh);
-
-	mVertices.Reset();
-	TArray<FVector2D> vertexXYPositions;
-
-	// Get the number of vertices and the pointer to vertices array.
-	PxU32 vertexCount = triMesh->getNbVertices();
-	const PxVec3* vertices = triMesh->getVertices();
-
-	// For each vertex, transform the position to match the component Transform 
-	for (PxU32 i = 0; i < vertexCount; i++)
-	{
-		mVertices.Add(meshTransform.TransformPosition(P2UVector(vertices[i])));
-		vertexXYPositions.Add(FVector2D(mVertices[i].X / 100, mVertices[i].Y / 100));
-	}
-
-	mWaveWorksComponent->SampleDisplacements(vertexXYPositions, mWaveworksDisplacementDelegate);
-}
-
-void UWaterPhysicsComponent::OnRecievedWaveWorksDisplacement(TArray<FVector4> OutDisplacements)
-{
-	FScopeLock scopeLock(mWaveWorksDisplacementLock);
-	mWaveworksDisplacements.Reset();
-	for (int32 i = 0; (i < OutDisplacements.Num()); ++i)
-	{
-		mWaveworksDisplacements.Add((OutDisplacements[i].Z * 100.0f) + mWaveWorksComponent->SeaLevel);
-	}
-}
-
-void UWaterPhysicsComponent::MarkSubmergedTriangles()
-{
-	if (mWaveworksDisplacements.Num() > 0)
-	{
-		FScopeLock scopeLock(mWaveWorksDisplacementLock);
-		float submergedArea = 0.0f;
-
-		for (auto& tri : mTriLocations)
-		{
-			TArray<float> heights;
-			heights.Reserve(3);
-			heights.Add(mVertices[tri.Index1].Z - mWaveworksDisplacements[tri.Index1]);
-			heights.Add(mVertices[tri.Index2].Z - mWaveworksDisplacements[tri.Index2]);
-			heights.Add(mVertices[tri.Index3].Z - mWaveworksDisplacements[tri.Index3]);
-
-			// If all vertices are submerged
-			if ((heights[0] < 0.0f) && (heights[1] < 0.0f) && (heights[2] < 0.0f))
-			{
-				tri.Submerged = Submersion::Full;
-				ApplyHydrostaticForce(tri, heights);
-				submergedArea += tri.Area;
-			}
-			// If any two vertices are submerged
-			else if (((heights[0] < 0.0f) && (heights[1] < 0.0f)) || ((heights[1] < 0.0f) && (heights[2] < 0.0f)) || ((heights[2] < 0.0f) && (heights[0] < 0.0f)))
-			{
-				tri.Submerged = Submersion::PartialTwoVertices;
-			}
-			// If any one vertex is submerged
-			else if ((heights[0] < 0.0f) || (heights[1] < 0.0f) || (heights[2] < 0.0f))
-			{
-				tri.Submerged = Submersion::PartialSingleVertex;
-			}
-			// If no vertices are submerged
-			else
-			{
-				tri.Submerged = Submersion::None;
-			}
-		}
-
-		float ratioOfSubmergedArea = submergedArea / mSurfaceAreaOfBoat;
-		mLengthOfSubmerged = ratioOfSubmergedArea * mLengthOfBoat;
-	}
-}
-
-inline void UWaterPhysicsComponent::ApplyHydrostaticForce(const Tri& submergedTri, TArray<float>& heights)
-{
-	// Calculate the normal of the triangle by getting the cross product of two edges
-	FVector triNormal = BoatPhysicsUtil::TriangleNormal(mVertices[submergedTri.Index1], mVertices[submergedTri.Index2], mVertices[submergedTri.Index3]);
-
-	// If the normal is pointing downwards, apply the force.
-	if (triNormal.Z < 0)
-	{
-		FVector centroid = BoatPhysicsUtil::CentroidOfTriangle(mVertices[submergedTri.Index1], mVertices[submergedTri.Index2], mVertices[submergedTri.Index3]);
-		FVector triangleVelocity = BoatPhysicsUtil::TriangleVelocity(mMeshComponent, centroid);
-
-		FVector hydrostaticForce = BoatPhysicsUtil::HydrostaticForce(GetWorld()->GetGravityZ() * mMeshComponent->GetBodyInstance()->GetBodyMass(), heights, submergedTri.Area, triNormal);
-
-		FVector viscousWaterResistance = BoatPhysicsUtil::ViscousWaterResistanceForce(triangleVelocity, triNormal, submergedTri.Area, BoatPhysicsUtil::ResistanceCoefficient(mMeshComponent->GetComponentVelocity().Size(), mLengthOfSubmerged));
-
-		float cosVelocityAndNormal = FVector::DotProduct(triangleVelocity.GetSafeNormal(), triNormal);
-		FVector pressureDragForce = BoatPhysicsUtil::PressureDragForce(cosVelocityAndNormal, triNormal, submergedTri.Area);
-
-#ifdef DRAW_DEBUG
-#ifdef DRAW_FORCES_DEBUG
-		DrawDebugLine(GetWorld(), centroid, centroid + (0.01 * hydrostaticForce), FColor::Red, false, -1, 0, 2.0f);
-		DrawDebugLine(GetWorld(), centroid, centroid + (0.01 * viscousWaterResistance), FColor::Green, false, -1, 0, 2.0f);
-		DrawDebugLine(GetWorld(), centroid, centroid + (0.01 * pressureDragForce), FColor::Blue, false, -1, 0, 2.0f);
-#endif
-#endif
-		mMeshComponent->AddImpulseAtLocation(hydrostaticForce + viscousWaterResistance + pressureDragForce, centroid);
-	}
-}
\ No newline at end of file
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "WaterPhysicsComponent.h"
+#include "HullKernel/HullBVH.h"
+#include "Utility/BoatPhysicsUtil.h"
+#include "Utility/BuoyancyCapture.h"
+#include "Utility/BuoyancyDebugDraw.h"
+#include "Utility/BuoyancyScheduler.h"
+#include "Utility/BuoyancyStats.h"
+#include "Utility/HullDataCache.h"
+#include "Utility/HullForceModel.h"
+
+#include "Components/StaticMeshComponent.h"
+
+// Sets default values for this component's properties
+UWaterPhysicsComponent::UWaterPhysicsComponent() :
+	mApplyPerTriangleImpulses(false), mIncludeInCapture(true), mLODHysteresis(0.1f), mForcedLOD(-1), mWaterSampleSpacing(100.0f), mWaterSampleInterval(0.05f), mAllowSleep(true), mSleepLinearSpeed(5.0f), mSleepAngularSpeed(2.0f), mSleepResidual(0.05f), mSleepDelay(2.0f), mSleepCheckInterval(0.5f), mWakeForceChange(0.1f), mWakeDistance(3000.0f), mForceModel(nullptr), mTransformedLOD(INDEX_NONE), mHasWaterHeights(false), mCurrentLOD(0), mLastWrench(), mBodyAsleep(false), mWakeRequested(false), mViewerNearby(false), mBodyMass(0.0f), mBodyWeight(0.0f), mLocalCenterOfMass(FVector::ZeroVector), mForceCoefficients(), mLastEvaluationTime(0.0), mHistoryLOD(INDEX_NONE), mLinearSpeed(0.0f), mAngularSpeed(0.0f), mScheduler(nullptr), mPhysicsSteps(0), mTraceId(INDEX_NONE), mSurfaceAreaOfBoat(0.0f), mLengthOfBoat(0.0f), mLengthOfSubmerged(0.0f)
+{
+	// The buoyancy scheduler ticks every floating component of the world, and steps them together inside the physics steps.
+	PrimaryComponentTick.bCanEverTick = false;
+
+	mLODDistances.Add(5000.0f);
+	mLODDistances.Add(20000.0f);
+	mLODDistances.Add(60000.0f);
+}
+
+// Called when the game starts
+void UWaterPhysicsComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Topology is built once per mesh and shared with every other boat using it.
+	for (int32 lod = 0; lod < HullKernel::HullLODCount; ++lod)
+	{
+		mHullLODs.Add(HullDataCache::Get(mMeshComponent, lod));
+	}
+
+	// Buffers are sized for the full hull, coarser LODs use the front of them.
+	mCurrentLOD = 0;
+	mHull = mHullLODs[0];
+	const int32 numTris = mHull->NumTriangles();
+	if (numTris == 0)
+	{
+		// Nothing to float, HullDataCache already reported why.
+		return;
+	}
+
+	mTriForces.SetNum(numTris, false);
+
+	// Take the surface area and length of the shared mesh to the scale of this component.
+	const FVector scale = mMeshComponent->GetComponentTransform().GetScale3D().GetAbs();
+	mSurfaceAreaOfBoat = CalculateSurfaceArea();
+	mLengthOfBoat = mHull->LengthOfBoat * scale.GetMax();
+
+	// Whatever the rotation, the hull stays inside the sphere around its pivot that holds every vertex.
+	float radiusSquared = 0.0f;
+	for (int32 i = 0; i < mHull->NumVertices(); ++i)
+	{
+		radiusSquared = FMath::Max(radiusSquared, FVector(mHull->X[i], mHull->Y[i], mHull->Z[i]).SizeSquared());
+	}
+	const float extent = 2.0f * FMath::Sqrt(radiusSquared) * scale.GetMax();
+
+	// Size every buffer of the tick up front, so neither the game thread nor the render thread callback allocates
+	// in steady state. The vertex arrays are sized by CalculateVertexLocations for the full hull.
+	mWaterSampler = MakeShareable(new FWaterHeightSampler(GetWorld(), WaveWorksActor));
+	mWaterSampler->SetQuality(mWaterSampleSpacing, mWaterSampleInterval);
+	mWaterSampler->Initialize(mHull->NumVertices(), extent);
+	mVertexWaterHeights.SetNumUninitialized(mHull->NumVertices());
+
+	CalculateVertexLocations(mMeshComponent->GetComponentTransform());
+
+	mTraceId = FBuoyancyTrace::RegisterBoat(GetOwner()->GetName());
+	mOnPhysicsStep = FCalculateCustomPhysics::CreateUObject(this, &UWaterPhysicsComponent::OnPhysicsStep);
+	mScheduler = FBuoyancyScheduler::Register(this);
+}
+
+void UWaterPhysicsComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FBuoyancyScheduler::Unregister(this);
+	mScheduler = nullptr;
+
+	if (mWaterSampler.IsValid())
+	{
+		mWaterSampler->Unregister();
+		mWaterSampler.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool UWaterPhysicsComponent::PrepareFrame(double time)
+{
+	BUOYANCY_SCOPE(PrepareFrame, mTraceId);
+
+	const bool bCheckSleeping = UpdateSleep(time);
+	UpdateBuoyancyLOD();
+
+	// Samples for where the hull is now, the physics steps interpolate them over the frame.
+	const FTransform transform = mMeshComponent->GetComponentTransform();
+	CalculateVertexLocations(transform);
+	RequestWaterSamples(time);
+	{
+		BUOYANCY_SCOPE(WaterUpdate, mTraceId);
+		mWaterSampler->Update();
+	}
+
+	mBodyMass = mMeshComponent->GetBodyInstance()->GetBodyMass();
+	mBodyWeight = GetWorld()->GetGravityZ() * mBodyMass;
+	mLocalCenterOfMass = transform.InverseTransformPosition(mMeshComponent->GetCenterOfMass());
+	mPhysicsSteps = 0;
+
+	// The model can be swapped at runtime. A history kept from before slamming was enabled is stale, like after a LOD change.
+	const HullKernel::FForceCoefficients coefficients = mForceModel ? mForceModel->ForceCoefficients() : BoatPhysicsUtil::ForceCoefficients();
+	if ((coefficients.Terms & ~mForceCoefficients.Terms & HullKernel::ForceTermSlamming) != 0)
+	{
+		mHistoryLOD = INDEX_NONE;
+	}
+	mForceCoefficients = coefficients;
+
+	// PhysX does not step a sleeping body, so its occasional check runs here, in the pose it sleeps in.
+	if (bCheckSleeping)
+	{
+		HullKernel::FHullJob job;
+		if (PrepareStep(time, transform, FVector::ZeroVector, FVector::ZeroVector, job))
+		{
+			const HullKernel::FKernelSummary summary = HullKernel::ComputeHullForces(job.Hull, job.WaterHeights, job.Body, job.Coefficients, job.Out);
+			FinishStep(time, job, summary, false);
+		}
+	}
+
+	SyncBodySleep();
+	return !mBodyAsleep;
+}
+
+bool UWaterPhysicsComponent::PrepareStep(double time, const FTransform& transform, const FVector& linearVelocity, const FVector& angularVelocity, HullKernel::FHullJob& outJob)
+{
+	BUOYANCY_SCOPE(PrepareStep, mTraceId);
+
+	// Gone with EndPlay.
+	if (!mWaterSampler.IsValid())
+	{
+		return false;
+	}
+
+	CalculateVertexLocations(transform);
+
+	// Heights under this step's vertices, interpolated and extrapolated from the latest water samples.
+	// Per vertex samples in flight may still belong to the previous LOD, the last forces are held until they catch up.
+	mHasWaterHeights = mWaterSampler->Evaluate(mVertexX.GetData(), mVertexY.GetData(), mVertexX.Num(), time, mVertexWaterHeights.GetData());
+	if (!mHasWaterHeights)
+	{
+		return false;
+	}
+
+	mLinearSpeed = linearVelocity.Size();
+	mAngularSpeed = angularVelocity.Size();
+
+	// The slamming history belongs to the triangles of one LOD, a new one starts over without slamming.
+	float timeStep = static_cast<float>(time - mLastEvaluationTime);
+	if (mHistoryLOD != mCurrentLOD)
+	{
+		mTriForces.ResetHistory();
+		mHistoryLOD = mCurrentLOD;
+		timeStep = 0.0f;
+	}
+	mLastEvaluationTime = time;
+
+	outJob.Hull = HullKernelAdapter::MakeHullView(mVertexX, mVertexY, mVertexZ, *mHull);
+	outJob.WaterHeights = mVertexWaterHeights.GetData();
+	HullKernel::BindHullBVH(outJob.Hull, *mHull, mVertexTransform, outJob.WaterHeights);
+	outJob.Body = HullKernelAdapter::MakeBodyState(linearVelocity, angularVelocity, transform.TransformPosition(mLocalCenterOfMass), mBodyWeight, mLengthOfSubmerged,
+		mBodyMass, mSurfaceAreaOfBoat, timeStep);
+	outJob.Coefficients = mForceCoefficients;
+	outJob.Out = mTriForces.View();
+	return true;
+}
+
+void UWaterPhysicsComponent::FinishStep(double time, const HullKernel::FHullJob& job, const HullKernel::FKernelSummary& summary, bool bChunked)
+{
+	BUOYANCY_SCOPE(FinishStep, mTraceId);
+
+	if (mIncludeInCapture && FBuoyancyCapture::IsCapturing())
+	{
+		FBuoyancyCapture::RecordStep(mTraceId, GetOwner(), mHull, time, mVertexTransform, job, summary, bChunked);
+	}
+
+	INC_DWORD_STAT_BY(STAT_BuoyancyTriangles, mHull->NumTriangles());
+	INC_DWORD_STAT_BY(STAT_BuoyancyTrianglesDry, summary.SubmersionCounts[static_cast<int32>(Submersion::None)]);
+	INC_DWORD_STAT_BY(STAT_BuoyancyTrianglesOneUnder, summary.SubmersionCounts[static_cast<int32>(Submersion::PartialSingleVertex)]);
+	INC_DWORD_STAT_BY(STAT_BuoyancyTrianglesTwoUnder, summary.SubmersionCounts[static_cast<int32>(Submersion::PartialTwoVertices)]);
+	INC_DWORD_STAT_BY(STAT_BuoyancyTrianglesSubmerged, summary.SubmersionCounts[static_cast<int32>(Submersion::Full)]);
+	INC_DWORD_STAT_BY(STAT_BuoyancyTrianglesApplied, summary.AppliedCount);
+
+	mLastWrench = summary.Wrench;
+
+	float ratioOfSubmergedArea = summary.SubmergedArea / mSurfaceAreaOfBoat;
+	mLengthOfSubmerged = ratioOfSubmergedArea * mLengthOfBoat;
+
+	// Boats near a viewer stay awake, so what the player looks at never freezes.
+	// The body itself is only sent to sleep before the next frame's physics.
+	if (mAllowSleep && !mViewerNearby)
+	{
+		// Weighed against gravity as the force and torque ApplyWrench pushes the body with.
+		HullKernel::FWrench appliedWrench = summary.Wrench;
+		for (int32 axis = 0; axis < 3; ++axis)
+		{
+			appliedWrench.Force[axis] *= HullKernelAdapter::TunedStepRate;
+			appliedWrench.Torque[axis] *= HullKernelAdapter::TunedStepRate;
+		}
+		mEquilibrium.AddEvaluation(GetSleepSettings(), time, appliedWrench, mBodyWeight, mLengthOfBoat, mLinearSpeed, mAngularSpeed);
+	}
+}
+
+void UWaterPhysicsComponent::ApplyStep(FBodyInstance* body)
+{
+	if (mBodyAsleep)
+	{
+		return;
+	}
+
+	BUOYANCY_SCOPE(ApplyForces, mTraceId);
+
+	if (!mApplyPerTriangleImpulses)
+	{
+		// One net force and torque per step instead of going through the body instance for every triangle.
+		HullKernelAdapter::ApplyWrench(body, mLastWrench);
+		return;
+	}
+
+	for (int32 tri = 0; tri < mHull->NumTriangles(); ++tri)
+	{
+		// Only the submerged parts of triangles facing downwards have a force, acting on their own centroid.
+		if (mTriForces.Applied[tri] != 0)
+		{
+			const FVector centroid = HullKernelAdapter::ToVector(mTriForces.CentroidX.GetData(), mTriForces.CentroidY.GetData(), mTriForces.CentroidZ.GetData(), tri);
+			const FVector force = HullKernelAdapter::ToVector(mTriForces.ForceX.GetData(), mTriForces.ForceY.GetData(), mTriForces.ForceZ.GetData(), tri);
+			HullKernelAdapter::ApplyForceAtPosition(body, force, centroid);
+		}
+	}
+}
+
+void UWaterPhysicsComponent::OnPhysicsStep(float DeltaTime, FBodyInstance* BodyInstance)
+{
+	if (mScheduler)
+	{
+		mScheduler->OnPhysicsStep(this, DeltaTime, BodyInstance);
+	}
+}
+
+void UWaterPhysicsComponent::WakeBuoyancy()
+{
+	// Picked up before the next physics steps, the physics thread may be reading the sleep state right now.
+	mWakeRequested = true;
+}
+
+bool UWaterPhysicsComponent::IsBuoyancyAsleep() const
+{
+	return mBodyAsleep;
+}
+
+bool UWaterPhysicsComponent::UpdateSleep(double time)
+{
+	float viewerDistance;
+	mViewerNearby = GetClosestViewerDistance(viewerDistance) && (viewerDistance < mWakeDistance);
+
+	// PhysX wakes the body itself on contacts, e.g. when something hits the boat. That only counts once the body was
+	// actually put to sleep, right after settling it is still awake until SyncBodySleep at the end of PrepareFrame.
+	const bool bContactWake = mBodyAsleep && mMeshComponent->RigidBodyIsAwake();
+	if (mEquilibrium.IsAsleep() && (mWakeRequested || !mAllowSleep || mViewerNearby || bContactWake))
+	{
+		mEquilibrium.Wake(time);
+	}
+	mWakeRequested = false;
+
+	if (!mEquilibrium.IsAsleep())
+	{
+		return false;
+	}
+	return mEquilibrium.NeedsEvaluation(GetSleepSettings(), time, mMeshComponent->GetComponentVelocity().Size(), mMeshComponent->GetPhysicsAngularVelocity().Size());
+}
+
+void UWaterPhysicsComponent::SyncBodySleep()
+{
+	if (mEquilibrium.IsAsleep() == mBodyAsleep)
+	{
+		return;
+	}
+
+	// Settled, PhysX stops integrating the body until something touches it or it is woken up.
+	mBodyAsleep = mEquilibrium.IsAsleep();
+	if (mBodyAsleep)
+	{
+		mMeshComponent->PutRigidBodyToSleep();
+	}
+	else
+	{
+		mMeshComponent->WakeRigidBody();
+	}
+}
+
+HullKernel::FSleepSettings UWaterPhysicsComponent::GetSleepSettings() const
+{
+	HullKernel::FSleepSettings settings;
+	settings.LinearSpeed = mSleepLinearSpeed;
+	settings.AngularSpeed = mSleepAngularSpeed;
+	settings.Residual = mSleepResidual;
+	settings.SleepDelay = mSleepDelay;
+	settings.CheckInterval = mSleepCheckInterval;
+	settings.WakeForceChange = mWakeForceChange;
+	return settings;
+}
+
+void UWaterPhysicsComponent::DrawHullDebug(uint32 views, FBuoyancyDebugDraw& draw)
+{
+	BUOYANCY_SCOPE(DebugDraw, mTraceId);
+
+	// The forces and submersion are the ones of the last evaluation, drawn at the vertices it ran with.
+	const bool bMesh = (views & FBuoyancyDebugDraw::ViewMesh) != 0;
+	const bool bProjection = mHasWaterHeights && ((views & FBuoyancyDebugDraw::ViewProjection) != 0);
+	const bool bForces = mHasWaterHeights && mTriForces.HasForceTerms() && ((views & FBuoyancyDebugDraw::ViewForces) != 0);
+	const bool bSubmersion = mHasWaterHeights && ((views & FBuoyancyDebugDraw::ViewSubmersion) != 0);
+
+	// Indexed by the number of vertices under the water.
+	static const FColor SubmersionColors[4] = { FColor::Black, FColor::Yellow, FColor::Orange, FColor::Cyan };
+
+	const int32* indices = mHull->Indices.data();
+	for (int32 tri = 0; tri < mHull->NumTriangles(); ++tri)
+	{
+		const int32 index1 = indices[(tri * 3) + 0];
+		const int32 index2 = indices[(tri * 3) + 1];
+		const int32 index3 = indices[(tri * 3) + 2];
+		const uint8 submersion = mTriForces.Submersion[tri];
+
+		if (bMesh)
+		{
+			draw.AddLine(GetVertex(index1), GetVertex(index2), FColor::Red, 1.0f);
+			draw.AddLine(GetVertex(index2), GetVertex(index3), FColor::Red, 1.0f);
+			draw.AddLine(GetVertex(index3), GetVertex(index1), FColor::Red, 1.0f);
+
+			// Normals
+			const FVector triNormal = BoatPhysicsUtil::TriangleNormal(GetVertex(index1), GetVertex(index2), GetVertex(index3));
+			const FVector centroid = BoatPhysicsUtil::CentroidOfTriangle(GetVertex(index1), GetVertex(index2), GetVertex(index3));
+			draw.AddLine(centroid, centroid + (100 * triNormal), FColor::Red, 2.0f);
+		}
+
+		if (bProjection && (static_cast<Submersion>(submersion) == Submersion::Full))
+		{
+			const FVector projected1(mVertexX[index1], mVertexY[index1], mVertexWaterHeights[index1]);
+			const FVector projected2(mVertexX[index2], mVertexY[index2], mVertexWaterHeights[index2]);
+			const FVector projected3(mVertexX[index3], mVertexY[index3], mVertexWaterHeights[index3]);
+			draw.AddLine(projected1, projected2, FColor::Red, 2.0f);
+			draw.AddLine(projected2, projected3, FColor::Red, 2.0f);
+			draw.AddLine(projected3, projected1, FColor::Red, 2.0f);
+		}
+
+		if (bSubmersion && (static_cast<Submersion>(submersion) != Submersion::None))
+		{
+			const FColor& color = SubmersionColors[submersion & 3];
+			draw.AddLine(GetVertex(index1), GetVertex(index2), color, 1.0f);
+			draw.AddLine(GetVertex(index2), GetVertex(index3), color, 1.0f);
+			draw.AddLine(GetVertex(index3), GetVertex(index1), color, 1.0f);
+		}
+
+		if (bForces && (mTriForces.Applied[tri] != 0))
+		{
+			const FVector centroid = HullKernelAdapter::ToVector(mTriForces.CentroidX.GetData(), mTriForces.CentroidY.GetData(), mTriForces.CentroidZ.GetData(), tri);
+			const FVector hydrostaticForce = HullKernelAdapter::ToVector(mTriForces.HydrostaticX.GetData(), mTriForces.HydrostaticY.GetData(), mTriForces.HydrostaticZ.GetData(), tri);
+			const FVector viscousWaterResistance = HullKernelAdapter::ToVector(mTriForces.ViscousX.GetData(), mTriForces.ViscousY.GetData(), mTriForces.ViscousZ.GetData(), tri);
+			const FVector pressureDragForce = HullKernelAdapter::ToVector(mTriForces.PressureDragX.GetData(), mTriForces.PressureDragY.GetData(), mTriForces.PressureDragZ.GetData(), tri);
+			const FVector slammingForce = HullKernelAdapter::ToVector(mTriForces.SlammingX.GetData(), mTriForces.SlammingY.GetData(), mTriForces.SlammingZ.GetData(), tri);
+
+			draw.AddLine(centroid, centroid + (0.01 * hydrostaticForce), FColor::Red, 2.0f);
+			draw.AddLine(centroid, centroid + (0.01 * viscousWaterResistance), FColor::Green, 2.0f);
+			draw.AddLine(centroid, centroid + (0.01 * pressureDragForce), FColor::Blue, 2.0f);
+			draw.AddLine(centroid, centroid + (0.01 * slammingForce), FColor::Magenta, 2.0f);
+		}
+	}
+}
+
+void UWaterPhysicsComponent::UpdateBuoyancyLOD()
+{
+	int32 lod = mCurrentLOD;
+	if (mForcedLOD >= 0)
+	{
+		lod = FMath::Min(mForcedLOD, mHullLODs.Num() - 1);
+	}
+	else
+	{
+		float viewerDistance;
+		if (GetClosestViewerDistance(viewerDistance))
+		{
+			lod = SelectBuoyancyLOD(viewerDistance);
+		}
+	}
+
+	if (lod != mCurrentLOD)
+	{
+		mCurrentLOD = lod;
+		mHull = mHullLODs[lod];
+		mSurfaceAreaOfBoat = CalculateSurfaceArea();
+	}
+}
+
+float UWaterPhysicsComponent::CalculateSurfaceArea() const
+{
+	const FVector scale = mMeshComponent->GetComponentTransform().GetScale3D().GetAbs();
+	const float scaleArray[3] = { scale.X, scale.Y, scale.Z };
+	return HullKernel::ScaledSurfaceArea(*mHull, scaleArray);
+}
+
+int32 UWaterPhysicsComponent::SelectBuoyancyLOD(float viewerDistance) const
+{
+	const int32 maxLOD = FMath::Min(mHullLODs.Num() - 1, mLODDistances.Num());
+	int32 lod = FMath::Min(mCurrentLOD, maxLOD);
+
+	// Only leave the current LOD once the viewer is clearly past the threshold on either side.
+	while ((lod < maxLOD) && (viewerDistance > (mLODDistances[lod] * (1.0f + mLODHysteresis))))
+	{
+		++lod;
+	}
+	while ((lod > 0) && (viewerDistance < (mLODDistances[lod - 1] * (1.0f - mLODHysteresis))))
+	{
+		--lod;
+	}
+
+	return lod;
+}
+
+bool UWaterPhysicsComponent::GetClosestViewerDistance(float& outDistance) const
+{
+	const FVector location = mMeshComponent->GetComponentLocation();
+	bool bFoundViewer = false;
+	outDistance = MAX_FLT;
+
+	// Player view points also exist on dedicated servers, where they follow the pawns.
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		const APlayerController* playerController = it->Get();
+		if (playerController)
+		{
+			FVector viewLocation;
+			FRotator viewRotation;
+			playerController->GetPlayerViewPoint(viewLocation, viewRotation);
+
+			outDistance = FMath::Min(outDistance, FVector::Dist(location, viewLocation));
+			bFoundViewer = true;
+		}
+	}
+
+	return bFoundViewer;
+}
+
+void UWaterPhysicsComponent::CalculateVertexLocations(const FTransform& transform)
+{
+	const HullKernel::FAffineTransform meshTransform = HullKernelAdapter::MakeAffineTransform(transform);
+	const int32 vertexCount = mHull->NumVertices();
+
+	if ((mTransformedLOD != mCurrentLOD) || (meshTransform != mVertexTransform))
+	{
+		BUOYANCY_SCOPE(VertexTransform, mTraceId);
+
+		// Never shrink, so switching to a coarser LOD and back does not reallocate.
+		mVertexX.SetNumUninitialized(vertexCount, false);
+		mVertexY.SetNumUninitialized(vertexCount, false);
+		mVertexZ.SetNumUninitialized(vertexCount, false);
+
+		// The local space vertices of the shared hull in one batched pass.
+		HullKernel::TransformVertices(meshTransform, mHull->X.data(), mHull->Y.data(), mHull->Z.data(), vertexCount, mVertexX.GetData(), mVertexY.GetData(), mVertexZ.GetData());
+
+		mVertexTransform = meshTransform;
+		mTransformedLOD = mCurrentLOD;
+	}
+}
+
+void UWaterPhysicsComponent::RequestWaterSamples(double time)
+{
+	BUOYANCY_SCOPE(WaterRequest, mTraceId);
+
+	// Samples a coarse grid under the hull, and only when the hull left it or the samples got old.
+	mWaterSampler->SetQuality(mWaterSampleSpacing, mWaterSampleInterval);
+	mWaterSampler->Request(mVertexX.GetData(), mVertexY.GetData(), mVertexX.Num(), time);
+}
+
+FVector UWaterPhysicsComponent::GetVertex(int32 index) const
+{
+	return HullKernelAdapter::ToVector(mVertexX.GetData(), mVertexY.GetData(), mVertexZ.GetData(), index);
+}
@@ -1,84 +1,223 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "Misc/ScopeLock.h"
-#include "Components/ActorComponent.h"
-#include "WaterPhysicsComponent.generated.h"
-
-
-UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
-class WAVEWORKSTESTER_API UWaterPhysicsComponent : public UActorComponent
-{
-#define DRAW_DEBUG
-//#define DRAW_MESH_DEBUG
-//#define DRAW_PROJECTION_DEBUG
-#define DRAW_FORCES_DEBUG
-	GENERATED_BODY()
-
-public:	
-	// Sets default values for this component's properties
-	UWaterPhysicsComponent();
-
-	~UWaterPhysicsComponent();
-
-protected:
-	// Called when the game starts
-	virtual void BeginPlay() override;
-
-	UPROPERTY(BlueprintReadWrite, Category = "Debug", DisplayName = "Log Data")
-	bool mLogEnable;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = WaveWorks)
-	AActor* WaveWorksActor;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = WaterInteraction, Meta = (DisplayName = "BoatHull"))
-	class UStaticMeshComponent* mMeshComponent;
-
-public:	
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-
-private:
-	enum class Submersion
-	{
-		None,
-		PartialSingleVertex,
-		PartialTwoVertices,
-		Full
-	};
-
-	struct Tri
-	{
-		int32 Index1;
-		int32 Index2;
-		int32 Index3;
-
-		Submersion Submerged;
-		float Area;
-
-		Tri(int32 index1, int32 index2, int32 index3);
-	};
-
-	void CalculateWaterIntersection();
-
-	void CalculateVertexLocations();
-
-	void OnRecievedWaveWorksDisplacement(TArray<FVector4> OutDisplacements);
-
-	void MarkSubmergedTriangles();
-
-	void ApplyHydrostaticForce(const Tri& submergedTriangle, TArray<float>& heights);
-
-	TArray<FVector> mVertices;
-	TArray<float> mWaveworksDisplacements;
-	TArray<Tri> mTriLocations;
-
-	FVectorArrayDelegate mWaveworksDisplacementDelegate;
-	class UWaveWorksComponent* mWaveWorksComponent;
-	FCriticalSection* mWaveWorksDisplacementLock;
-
-	float mSurfaceAreaOfBoat;
-	float mLengthOfBoat;
-	float mLengthOfSubmerged;
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "Utility/HullKernelAdapter.h"
+#include "HullKernel/Equilibrium.h"
+#include "HullKernel/HullForceBatch.h"
+#include "Utility/WaterHeightSampler.h"
+#include "WaterPhysicsComponent.generated.h"
+
+class FBuoyancyDebugDraw;
+class FBuoyancyScheduler;
+class UHullForceModel;
+
+
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class WAVEWORKSTESTER_API UWaterPhysicsComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:	
+	// Sets default values for this component's properties
+	UWaterPhysicsComponent();
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Debug", DisplayName = "Log Data")
+	bool mLogEnable;
+
+	// Applies one force per submerged triangle instead of the summed wrench. Much slower, only meant to inspect the force distribution.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug", DisplayName = "Apply Per Triangle Impulses")
+	bool mApplyPerTriangleImpulses;
+
+	// Records this boat's hull kernel evaluations while buoyancy.Capture runs.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug", DisplayName = "Include In Capture")
+	bool mIncludeInCapture;
+
+	// Distances (cm) from the closest viewer past which the next coarser buoyancy hull is used, one per LOD switch.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy LOD", DisplayName = "LOD Distances")
+	TArray<float> mLODDistances;
+
+	// Fraction of a distance threshold the viewer has to move past it before the LOD switches, avoids flickering.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy LOD", DisplayName = "LOD Hysteresis", Meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float mLODHysteresis;
+
+	// Buoyancy hull LOD to always use, -1 picks it from the viewer distance. Lets gameplay pin important boats to full detail.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy LOD", DisplayName = "Forced LOD")
+	int32 mForcedLOD;
+
+	// Spacing (cm) of the grid the water is sampled on under the hull, 0 samples at every vertex.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Water Sampling", DisplayName = "Sample Spacing", Meta = (ClampMin = "0.0"))
+	float mWaterSampleSpacing;
+
+	// Seconds between water samples while the hull stays over the same grid, the heights are extrapolated in between.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Water Sampling", DisplayName = "Sample Interval", Meta = (ClampMin = "0.0"))
+	float mWaterSampleInterval;
+
+	// Lets the boat sleep once it floats still, it is then only checked every few tenths of a second.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sleep", DisplayName = "Allow Sleep")
+	bool mAllowSleep;
+
+	// Speed (cm/s) below which the boat counts as at rest.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sleep", DisplayName = "Sleep Linear Speed", Meta = (ClampMin = "0.0"))
+	float mSleepLinearSpeed;
+
+	// Rotation speed (deg/s) below which the boat counts as at rest.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sleep", DisplayName = "Sleep Angular Speed", Meta = (ClampMin = "0.0"))
+	float mSleepAngularSpeed;
+
+	// Net force of water and gravity, as a fraction of the weight, below which the boat counts as balanced.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sleep", DisplayName = "Sleep Residual", Meta = (ClampMin = "0.0"))
+	float mSleepResidual;
+
+	// Seconds the boat has to stay at rest before it sleeps.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sleep", DisplayName = "Sleep Delay", Meta = (ClampMin = "0.0"))
+	float mSleepDelay;
+
+	// Seconds between the checks of a sleeping boat against the water.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sleep", DisplayName = "Sleep Check Interval", Meta = (ClampMin = "0.0"))
+	float mSleepCheckInterval;
+
+	// Change of the water force under a sleeping boat, as a fraction of its weight, that wakes it up.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sleep", DisplayName = "Wake Force Change", Meta = (ClampMin = "0.0"))
+	float mWakeForceChange;
+
+	// Boats closer than this (cm) to a viewer never sleep.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sleep", DisplayName = "Wake Distance", Meta = (ClampMin = "0.0"))
+	float mWakeDistance;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = WaveWorks)
+	AActor* WaveWorksActor;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = WaterInteraction, Meta = (DisplayName = "BoatHull"))
+	class UStaticMeshComponent* mMeshComponent;
+
+	// Force terms and coefficients of this kind of hull, none uses the BoatPhysicsUtil defaults.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = WaterInteraction, Meta = (DisplayName = "Force Model"))
+	UHullForceModel* mForceModel;
+
+public:
+	// Wakes the boat up if it sleeps, e.g. when gameplay is about to push it.
+	UFUNCTION(BlueprintCallable, Category = "Sleep")
+	void WakeBuoyancy();
+
+	UFUNCTION(BlueprintCallable, Category = "Sleep")
+	bool IsBuoyancyAsleep() const;
+
+private:
+	// Ticked by the scheduler of its world, which runs the kernel of every hull at once inside the physics steps.
+	friend class FBuoyancyScheduler;
+
+	typedef HullKernel::ESubmersion Submersion;
+
+	// Game thread, before physics. Updates the LOD, sleep state and water samples for the frame.
+	// True when the boat is simulated in this frame's physics steps, false while it sleeps.
+	bool PrepareFrame(double time);
+
+	// Physics steps. Fills in the kernel job for the pose PhysX is at, false when there are no water heights yet.
+	bool PrepareStep(double time, const FTransform& transform, const FVector& linearVelocity, const FVector& angularVelocity, HullKernel::FHullJob& outJob);
+
+	// Takes in the forces computed for the job, in chunks by the scheduler or in one call for a sleeping boat.
+	void FinishStep(double time, const HullKernel::FHullJob& job, const HullKernel::FKernelSummary& summary, bool bChunked);
+
+	// Pushes the latest forces, every physics step whether they were evaluated in it or not.
+	void ApplyStep(FBodyInstance* body);
+
+	// Custom physics callback, once per physics step.
+	void OnPhysicsStep(float DeltaTime, FBodyInstance* BodyInstance);
+
+	// True when a sleeping boat has to be checked against the water this frame.
+	bool UpdateSleep(double time);
+
+	// Sends the body to sleep or wakes it, following the equilibrium detector.
+	void SyncBodySleep();
+
+	HullKernel::FSleepSettings GetSleepSettings() const;
+
+	// Debug lines of the hull for the FBuoyancyDebugDraw views, outside the allocation free part of the tick.
+	void DrawHullDebug(uint32 views, FBuoyancyDebugDraw& draw);
+
+	void UpdateBuoyancyLOD();
+
+	// Surface area (m2) of mHull at the scale of this component.
+	float CalculateSurfaceArea() const;
+
+	int32 SelectBuoyancyLOD(float viewerDistance) const;
+
+	bool GetClosestViewerDistance(float& outDistance) const;
+
+	void CalculateVertexLocations(const FTransform& transform);
+
+	void RequestWaterSamples(double time);
+
+	FVector GetVertex(int32 index) const;
+
+	// World space hull vertices as structure-of-arrays, in cm.
+	TArray<float> mVertexX;
+	TArray<float> mVertexY;
+	TArray<float> mVertexZ;
+
+	// Transform and LOD the vertices were computed for, a boat that did not move keeps them as they are.
+	HullKernel::FAffineTransform mVertexTransform;
+	int32 mTransformedLOD;
+
+	// Absolute water height under every vertex, valid when mHasWaterHeights is set.
+	TArray<float> mVertexWaterHeights;
+	bool mHasWaterHeights;
+
+	// Topology, areas and local space vertices shared by every component using the same mesh, one per buoyancy LOD.
+	TArray<TSharedPtr<const HullKernel::FHullData>> mHullLODs;
+
+	// LOD currently simulated, mHull points to it.
+	TSharedPtr<const HullKernel::FHullData> mHull;
+	int32 mCurrentLOD;
+
+	// Reused while the heights of a newly selected LOD are still in flight.
+	HullKernel::FWrench mLastWrench;
+
+	HullKernel::FEquilibriumDetector mEquilibrium;
+
+	// Whether the body was sent to sleep, only changed before physics so the steps can read it.
+	bool mBodyAsleep;
+	bool mWakeRequested;
+	bool mViewerNearby;
+
+	// Sampled before physics, constant over the frame.
+	float mBodyMass;
+	float mBodyWeight;
+	FVector mLocalCenterOfMass;
+	HullKernel::FForceCoefficients mForceCoefficients;
+
+	// Time of the latest evaluation and the LOD whose triangles the slamming history in mTriForces holds.
+	double mLastEvaluationTime;
+	int32 mHistoryLOD;
+
+	// Sampled in the latest evaluated physics step, for the equilibrium detector.
+	float mLinearSpeed;
+	float mAngularSpeed;
+
+	FCalculateCustomPhysics mOnPhysicsStep;
+
+	// Set while registered, and the number of this frame's physics steps the boat has had.
+	FBuoyancyScheduler* mScheduler;
+	int32 mPhysicsSteps;
+
+	// Tells this boat's stages apart in buoyancy.Trace captures.
+	int32 mTraceId;
+
+	FHullForceBuffers mTriForces;
+
+	// Water heights from WaveWorks, or the CPU ocean where there is no GPU.
+	TSharedPtr<FWaterHeightSampler, ESPMode::ThreadSafe> mWaterSampler;
+
+	// Of mHull at the scale of this component.
+	float mSurfaceAreaOfBoat;
+	float mLengthOfBoat;
+	float mLengthOfSubmerged;
 };
\ No newline at end of file
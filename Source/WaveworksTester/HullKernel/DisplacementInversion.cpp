@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DisplacementInversion.h"
+
+#include <algorithm>
+
+namespace HullKernel
+{
+	FDisplacementInversion::FDisplacementInversion() :
+		mPointX(nullptr), mPointY(nullptr), mNumPoints(0), mIteration(0), mNumActive(0)
+	{
+	}
+
+	void FDisplacementInversion::Reserve(int32_t count)
+	{
+		mOffsetX.reserve(count);
+		mOffsetY.reserve(count);
+		mActivePoint.reserve(count);
+		mActiveX.reserve(count);
+		mActiveY.reserve(count);
+		mDisplacementX.reserve(count);
+		mDisplacementY.reserve(count);
+		mDisplacementZ.reserve(count);
+	}
+
+	void FDisplacementInversion::Reset(int32_t count)
+	{
+		mNumPoints = count;
+		mNumActive = 0;
+		mOffsetX.assign(count, 0.0f);
+		mOffsetY.assign(count, 0.0f);
+		mActivePoint.resize(count);
+		mActiveX.resize(count);
+		mActiveY.resize(count);
+		mDisplacementX.resize(count);
+		mDisplacementY.resize(count);
+		mDisplacementZ.resize(count);
+	}
+
+	void FDisplacementInversion::Begin(const float* x, const float* y, int32_t count)
+	{
+		if (count != mNumPoints)
+		{
+			Reset(count);
+		}
+
+		mPointX = x;
+		mPointY = y;
+		mIteration = 0;
+		mNumActive = count;
+		for (int32_t point = 0; point < count; ++point)
+		{
+			mActivePoint[point] = point;
+			mActiveX[point] = x[point] - mOffsetX[point];
+			mActiveY[point] = y[point] - mOffsetY[point];
+		}
+	}
+
+	void FDisplacementInversion::Step(float* outZ)
+	{
+		++mIteration;
+		const bool bLastIteration = mIteration >= DisplacementInversionIterations;
+		const float toleranceSquared = DisplacementInversionTolerance * DisplacementInversionTolerance;
+
+		// The source was p - offset, so it lands off p by the change of the offset. Compacted in place, the write
+		// position never passes the read position.
+		int32_t numActive = 0;
+		for (int32_t i = 0; i < mNumActive; ++i)
+		{
+			const int32_t point = mActivePoint[i];
+			const float missX = mDisplacementX[i] - mOffsetX[point];
+			const float missY = mDisplacementY[i] - mOffsetY[point];
+			mOffsetX[point] = mDisplacementX[i];
+			mOffsetY[point] = mDisplacementY[i];
+
+			if (bLastIteration || (((missX * missX) + (missY * missY)) <= toleranceSquared))
+			{
+				outZ[point] = mDisplacementZ[i];
+			}
+			else
+			{
+				mActivePoint[numActive] = point;
+				mActiveX[numActive] = mPointX[point] - mOffsetX[point];
+				mActiveY[numActive] = mPointY[point] - mOffsetY[point];
+				++numActive;
+			}
+		}
+		mNumActive = numActive;
+	}
+
+	void FDisplacementInversion::Advance(const float* displacementX, const float* displacementY, int32_t count)
+	{
+		if (count != mNumPoints)
+		{
+			Reset(count);
+		}
+
+		std::copy(displacementX, displacementX + count, mOffsetX.begin());
+		std::copy(displacementY, displacementY + count, mOffsetY.begin());
+	}
+}
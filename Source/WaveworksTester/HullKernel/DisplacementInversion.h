@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernelTypes.h"
+
+#include <vector>
+
+namespace HullKernel
+{
+	// Horizontal miss (m) under which a point counts as inverted, well below the grid and vertex spacing of a hull.
+	static const float DisplacementInversionTolerance = 0.01f;
+
+	// Most displacement samples per point and solve. Only a cold start needs more than one or two.
+	static const int32_t DisplacementInversionIterations = 4;
+
+	/**
+	 * Finds for points p the undisplaced positions q the ocean moves onto them, q + D(q) = p, so that the height
+	 * sampled at q is the one of the water right above p rather than of a surface point a choppy wave carried away.
+	 * Fixed point iteration q' = p - D(q), which converges as long as the crests do not loop over. Every point keeps
+	 * its offset D(q) from the previous solve as its start, so while the points and the waves move smoothly most of
+	 * them are done after a single sample. The caller samples the displacement at the points still active, which are
+	 * kept packed so a whole iteration is one vectorized call.
+	 */
+	class FDisplacementInversion
+	{
+	public:
+		FDisplacementInversion();
+
+		void Reserve(int32_t count);
+
+		// Forgets the offsets, every point starts from itself again.
+		void Reset(int32_t count);
+
+		int32_t NumPoints() const { return mNumPoints; }
+
+		// Starts a solve for count points (m), which have to stay valid until it is done. A different number of
+		// points than last time resets the offsets.
+		void Begin(const float* x, const float* y, int32_t count);
+
+		// Positions to sample next and room for the displacements there, zero active once every point is done.
+		int32_t NumActive() const { return mNumActive; }
+		const float* ActiveX() const { return mActiveX.data(); }
+		const float* ActiveY() const { return mActiveY.data(); }
+		float* DisplacementX() { return mDisplacementX.data(); }
+		float* DisplacementY() { return mDisplacementY.data(); }
+		float* DisplacementZ() { return mDisplacementZ.data(); }
+
+		// Takes the displacements sampled at the active positions. Points within the tolerance, or out of iterations,
+		// get their vertical displacement written to outZ, indexed like the points of Begin. The others stay active.
+		void Step(float* outZ);
+
+		// Last horizontal displacement (m) of the source of every point.
+		const float* OffsetX() const { return mOffsetX.data(); }
+		const float* OffsetY() const { return mOffsetY.data(); }
+
+		// For asynchronous oceans, where one sample per point and request is all there is: takes the horizontal
+		// displacements sampled at p - Offset as the offsets of the next request, one iteration per round trip.
+		void Advance(const float* displacementX, const float* displacementY, int32_t count);
+
+	private:
+		const float* mPointX;
+		const float* mPointY;
+		int32_t mNumPoints;
+		int32_t mIteration;
+
+		std::vector<float> mOffsetX;
+		std::vector<float> mOffsetY;
+
+		int32_t mNumActive;
+		std::vector<int32_t> mActivePoint;
+		std::vector<float> mActiveX;
+		std::vector<float> mActiveY;
+		std::vector<float> mDisplacementX;
+		std::vector<float> mDisplacementY;
+		std::vector<float> mDisplacementZ;
+	};
+}
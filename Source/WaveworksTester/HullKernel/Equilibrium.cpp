@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Equilibrium.h"
+
+#include <cmath>
+
+namespace HullKernel
+{
+	static float Length(float x, float y, float z)
+	{
+		return std::sqrt((x * x) + (y * y) + (z * z));
+	}
+
+	FEquilibriumDetector::FEquilibriumDetector() :
+		mSleepWrench(), mRestingSince(0.0), mLastCheck(0.0), mResting(false), mAsleep(false)
+	{
+	}
+
+	bool FEquilibriumDetector::NeedsEvaluation(const FSleepSettings& settings, double time, float linearSpeed, float angularSpeed)
+	{
+		if (!mAsleep)
+		{
+			return true;
+		}
+
+		// Twice the rest speeds, so the jitter of a body that just fell asleep does not wake it again.
+		if ((linearSpeed > (2.0f * settings.LinearSpeed)) || (angularSpeed > (2.0f * settings.AngularSpeed)))
+		{
+			Wake(time);
+			return true;
+		}
+
+		return (time - mLastCheck) >= settings.CheckInterval;
+	}
+
+	void FEquilibriumDetector::AddEvaluation(const FSleepSettings& settings, double time, const FWrench& wrench, float weight, float length,
+		float linearSpeed, float angularSpeed)
+	{
+		const float weightMagnitude = std::fabs(weight);
+		mLastCheck = time;
+
+		if (mAsleep)
+		{
+			const float change = Length(wrench.Force[0] - mSleepWrench.Force[0], wrench.Force[1] - mSleepWrench.Force[1], wrench.Force[2] - mSleepWrench.Force[2]);
+			if (change > (settings.WakeForceChange * weightMagnitude))
+			{
+				Wake(time);
+			}
+			return;
+		}
+
+		// Gravity pulls along Z with the weight, the water has to cancel it and every torque.
+		const float netForce = Length(wrench.Force[0], wrench.Force[1], wrench.Force[2] + weight);
+		const float netTorque = Length(wrench.Torque[0], wrench.Torque[1], wrench.Torque[2]);
+		const bool bBalanced = (netForce <= (settings.Residual * weightMagnitude)) && (netTorque <= (settings.Residual * weightMagnitude * length));
+		const bool bStill = (linearSpeed <= settings.LinearSpeed) && (angularSpeed <= settings.AngularSpeed);
+
+		if (!bBalanced || !bStill)
+		{
+			mResting = false;
+			return;
+		}
+
+		if (!mResting)
+		{
+			mResting = true;
+			mRestingSince = time;
+		}
+
+		if ((time - mRestingSince) >= settings.SleepDelay)
+		{
+			mAsleep = true;
+			mSleepWrench = wrench;
+		}
+	}
+
+	void FEquilibriumDetector::Wake(double time)
+	{
+		mAsleep = false;
+		mResting = false;
+		mRestingSince = time;
+		mLastCheck = time;
+	}
+}
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernelTypes.h"
+
+namespace HullKernel
+{
+	struct FSleepSettings
+	{
+		// Body speeds below which it counts as at rest, in the units the caller measures them in.
+		float LinearSpeed;
+		float AngularSpeed;
+
+		// Largest net force, water plus gravity, as a fraction of the weight that still counts as balanced.
+		// The net torque is compared against the weight times the body length.
+		float Residual;
+
+		// Seconds the body has to stay at rest and balanced before it sleeps.
+		float SleepDelay;
+
+		// Seconds between the full evaluations that check a sleeping body still floats the same way.
+		float CheckInterval;
+
+		// Change of the water force since falling asleep, as a fraction of the weight, that wakes the body.
+		float WakeForceChange;
+	};
+
+	/**
+	 * Tells when a floating body has settled at hydrostatic equilibrium, so the full force evaluation can be
+	 * skipped while it rests, and when it has to wake up again.
+	 * A sleeping body is only evaluated every CheckInterval seconds, and wakes once it moves, once the water
+	 * force under it changes, e.g. when the waves pick up, or when the caller wakes it explicitly.
+	 */
+	class FEquilibriumDetector
+	{
+	public:
+		FEquilibriumDetector();
+
+		bool IsAsleep() const { return mAsleep; }
+
+		// Called every tick before anything else. True when the forces have to be evaluated this tick.
+		// A sleeping body that moves faster than twice the rest speeds wakes up.
+		bool NeedsEvaluation(const FSleepSettings& settings, double time, float linearSpeed, float angularSpeed);
+
+		// Called with the result of every full evaluation. Puts the body to sleep once it has been balanced and at
+		// rest for long enough, or wakes it when the water force moved away from the one it fell asleep with.
+		// wrench is the force and torque the water applies to the body, in the units of weight.
+		void AddEvaluation(const FSleepSettings& settings, double time, const FWrench& wrench, float weight, float length,
+			float linearSpeed, float angularSpeed);
+
+		// Wakes the body, it stays awake for at least the sleep delay.
+		void Wake(double time);
+
+	private:
+		FWrench mSleepWrench;
+		double mRestingSince;
+		double mLastCheck;
+		bool mResting;
+		bool mAsleep;
+	};
+}
@@ -0,0 +1,352 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GerstnerOcean.h"
+#include "DisplacementInversion.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if HULLKERNEL_X86
+#include <emmintrin.h>
+#endif
+
+namespace HullKernel
+{
+	static const double TwoPi = 6.283185307179586;
+	static const float Gravity = 9.81f;
+
+	// Frequency band of the spectrum covered by the waves, relative to its peak.
+	static const float LowestFrequencyRatio = 0.6f;
+	static const float HighestFrequencyRatio = 3.0f;
+
+	static const float PiersonMoskowitzAlpha = 0.0081f;
+
+	// Points evaluated together, so the per wave setup is shared.
+	static const int32_t SampleBlockSize = 64;
+
+	static const int32_t RaycastMaxSteps = 256;
+	static const int32_t RaycastBisections = 20;
+
+	// Cephes style sin and cos: reduce to [-pi/4, pi/4] around the nearest multiple of pi/2, then a polynomial.
+	// The SSE and scalar versions execute the same operations in the same order, so they give identical results.
+	static const float TwoOverPi = 0.636619772f;
+	static const float HalfPiPart1 = 1.5703125f;
+	static const float HalfPiPart2 = 4.837512969970703125e-4f;
+	static const float HalfPiPart3 = 7.54978995489188216e-8f;
+	static const float SinCoefficient1 = -1.9515295891e-4f;
+	static const float SinCoefficient2 = 8.3321608736e-3f;
+	static const float SinCoefficient3 = -1.6666654611e-1f;
+	static const float CosCoefficient1 = 2.443315711809948e-5f;
+	static const float CosCoefficient2 = -1.388731625493765e-3f;
+	static const float CosCoefficient3 = 4.166664568298827e-2f;
+
+	namespace
+	{
+		struct FScalarLanes
+		{
+			typedef float FValue;
+			static const int32_t Width = 1;
+
+			static HULLKERNEL_FORCEINLINE FValue Set(float value) { return value; }
+			static HULLKERNEL_FORCEINLINE FValue Load(const float* source) { return *source; }
+			static HULLKERNEL_FORCEINLINE void Store(float* destination, FValue value) { *destination = value; }
+			static HULLKERNEL_FORCEINLINE FValue Add(FValue a, FValue b) { return a + b; }
+			static HULLKERNEL_FORCEINLINE FValue Sub(FValue a, FValue b) { return a - b; }
+			static HULLKERNEL_FORCEINLINE FValue Mul(FValue a, FValue b) { return a * b; }
+
+			static HULLKERNEL_FORCEINLINE void SinCos(FValue angle, FValue& outSin, FValue& outCos)
+			{
+				const int32_t quadrant = static_cast<int32_t>(std::nearbyint(angle * TwoOverPi));
+				const float q = static_cast<float>(quadrant);
+				const float r = ((angle - (q * HalfPiPart1)) - (q * HalfPiPart2)) - (q * HalfPiPart3);
+				const float r2 = r * r;
+
+				const float sinR = r + ((r * r2) * ((((SinCoefficient1 * r2) + SinCoefficient2) * r2) + SinCoefficient3));
+				const float cosR = (1.0f - (0.5f * r2)) + ((r2 * r2) * ((((CosCoefficient1 * r2) + CosCoefficient2) * r2) + CosCoefficient3));
+
+				switch (quadrant & 3)
+				{
+				case 0: outSin = sinR; outCos = cosR; break;
+				case 1: outSin = cosR; outCos = -sinR; break;
+				case 2: outSin = -sinR; outCos = -cosR; break;
+				default: outSin = -cosR; outCos = sinR; break;
+				}
+			}
+		};
+
+#if HULLKERNEL_X86
+		struct FSSELanes
+		{
+			typedef __m128 FValue;
+			static const int32_t Width = 4;
+
+			static HULLKERNEL_FORCEINLINE FValue Set(float value) { return _mm_set1_ps(value); }
+			static HULLKERNEL_FORCEINLINE FValue Load(const float* source) { return _mm_loadu_ps(source); }
+			static HULLKERNEL_FORCEINLINE void Store(float* destination, FValue value) { _mm_storeu_ps(destination, value); }
+			static HULLKERNEL_FORCEINLINE FValue Add(FValue a, FValue b) { return _mm_add_ps(a, b); }
+			static HULLKERNEL_FORCEINLINE FValue Sub(FValue a, FValue b) { return _mm_sub_ps(a, b); }
+			static HULLKERNEL_FORCEINLINE FValue Mul(FValue a, FValue b) { return _mm_mul_ps(a, b); }
+
+			static HULLKERNEL_FORCEINLINE void SinCos(FValue angle, FValue& outSin, FValue& outCos)
+			{
+				// Rounds to nearest even under the default rounding mode, like nearbyint.
+				const __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(angle, _mm_set1_ps(TwoOverPi)));
+				const __m128 q = _mm_cvtepi32_ps(quadrant);
+				const __m128 r = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(angle, _mm_mul_ps(q, _mm_set1_ps(HalfPiPart1))), _mm_mul_ps(q, _mm_set1_ps(HalfPiPart2))), _mm_mul_ps(q, _mm_set1_ps(HalfPiPart3)));
+				const __m128 r2 = _mm_mul_ps(r, r);
+
+				__m128 sinPoly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SinCoefficient1), r2), _mm_set1_ps(SinCoefficient2));
+				sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, r2), _mm_set1_ps(SinCoefficient3));
+				const __m128 sinR = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), sinPoly));
+
+				__m128 cosPoly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(CosCoefficient1), r2), _mm_set1_ps(CosCoefficient2));
+				cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, r2), _mm_set1_ps(CosCoefficient3));
+				const __m128 cosR = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)), _mm_mul_ps(_mm_mul_ps(r2, r2), cosPoly));
+
+				// Odd quadrants swap sin and cos, the sign follows the quadrant.
+				const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+				const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+				const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+
+				outSin = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, cosR), _mm_andnot_ps(swap, sinR)), sinSign);
+				outCos = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, sinR), _mm_andnot_ps(swap, cosR)), cosSign);
+			}
+		};
+#endif
+
+		// Per call broadcast of one wave.
+		struct FWaveTerm
+		{
+			float WaveVectorX;
+			float WaveVectorY;
+			float TimePhase;
+			float HorizontalX;
+			float HorizontalY;
+			float Amplitude;
+		};
+
+		template <typename Lanes>
+		HULLKERNEL_FORCEINLINE void AccumulateWave(const FWaveTerm& wave, const float* x, const float* y, int32_t begin, int32_t end,
+			float* accumulatedX, float* accumulatedY, float* accumulatedZ)
+		{
+			typedef typename Lanes::FValue FValue;
+
+			const FValue waveVectorX = Lanes::Set(wave.WaveVectorX);
+			const FValue waveVectorY = Lanes::Set(wave.WaveVectorY);
+			const FValue timePhase = Lanes::Set(wave.TimePhase);
+			const FValue horizontalX = Lanes::Set(wave.HorizontalX);
+			const FValue horizontalY = Lanes::Set(wave.HorizontalY);
+			const FValue amplitude = Lanes::Set(wave.Amplitude);
+
+			for (int32_t i = begin; (i + Lanes::Width) <= end; i += Lanes::Width)
+			{
+				// theta = k (d . p) - (omega t - phase)
+				const FValue theta = Lanes::Sub(Lanes::Add(Lanes::Mul(waveVectorX, Lanes::Load(x + i)), Lanes::Mul(waveVectorY, Lanes::Load(y + i))), timePhase);
+
+				FValue sinTheta;
+				FValue cosTheta;
+				Lanes::SinCos(theta, sinTheta, cosTheta);
+
+				Lanes::Store(accumulatedX + i, Lanes::Add(Lanes::Load(accumulatedX + i), Lanes::Mul(horizontalX, cosTheta)));
+				Lanes::Store(accumulatedY + i, Lanes::Add(Lanes::Load(accumulatedY + i), Lanes::Mul(horizontalY, cosTheta)));
+				Lanes::Store(accumulatedZ + i, Lanes::Add(Lanes::Load(accumulatedZ + i), Lanes::Mul(amplitude, sinTheta)));
+			}
+		}
+
+		// Small deterministic generator, the standard distributions differ between library implementations.
+		struct FWaveRandom
+		{
+			uint32_t State;
+
+			float Next()
+			{
+				State ^= State << 13;
+				State ^= State >> 17;
+				State ^= State << 5;
+				return static_cast<float>(State >> 8) * (1.0f / 16777216.0f);
+			}
+		};
+	}
+
+	FGerstnerSettings DefaultGerstnerSettings()
+	{
+		FGerstnerSettings settings;
+		settings.NumWaves = 16;
+		settings.WindDirection = 0.0f;
+		settings.WindSpeed = 8.0f;
+		settings.DirectionalSpread = 45.0f;
+		settings.AmplitudeScale = 1.0f;
+		settings.Choppiness = 0.6f;
+		settings.Seed = 1;
+		return settings;
+	}
+
+	FGerstnerOcean::FGerstnerOcean()
+	{
+	}
+
+	void FGerstnerOcean::Build(const FGerstnerSettings& settings)
+	{
+		const int32_t numWaves = std::max(settings.NumWaves, 0);
+		mDirectionX.resize(numWaves);
+		mDirectionY.resize(numWaves);
+		mWaveNumber.resize(numWaves);
+		mAngularFrequency.resize(numWaves);
+		mPhase.resize(numWaves);
+		mAmplitude.resize(numWaves);
+		mHorizontalAmplitude.resize(numWaves);
+
+		FWaveRandom random = { (settings.Seed != 0) ? settings.Seed : 0x9E3779B9u };
+
+		// Fully developed sea for the wind speed, the frequencies are spread geometrically around the spectrum peak.
+		const float peakFrequency = 0.877f * Gravity / std::max(settings.WindSpeed, 0.5f);
+		const float lowestFrequency = peakFrequency * LowestFrequencyRatio;
+		const float frequencyRatio = HighestFrequencyRatio / LowestFrequencyRatio;
+		const float degreesToRadians = static_cast<float>(TwoPi / 360.0);
+
+		float slopeSum = 0.0f;
+		for (int32_t wave = 0; wave < numWaves; ++wave)
+		{
+			const float bandLow = lowestFrequency * std::pow(frequencyRatio, static_cast<float>(wave) / numWaves);
+			const float bandHigh = lowestFrequency * std::pow(frequencyRatio, static_cast<float>(wave + 1) / numWaves);
+			const float frequency = 0.5f * (bandLow + bandHigh);
+
+			const float ratio = peakFrequency / frequency;
+			const float spectrum = (PiersonMoskowitzAlpha * Gravity * Gravity / std::pow(frequency, 5.0f)) * std::exp(-1.25f * ratio * ratio * ratio * ratio);
+
+			const float direction = (settings.WindDirection + (settings.DirectionalSpread * ((2.0f * random.Next()) - 1.0f))) * degreesToRadians;
+			mDirectionX[wave] = std::cos(direction);
+			mDirectionY[wave] = std::sin(direction);
+
+			// Deep water dispersion.
+			mAngularFrequency[wave] = frequency;
+			mWaveNumber[wave] = (frequency * frequency) / Gravity;
+			mPhase[wave] = static_cast<float>(TwoPi) * random.Next();
+			mAmplitude[wave] = settings.AmplitudeScale * std::sqrt(2.0f * spectrum * (bandHigh - bandLow));
+
+			slopeSum += mWaveNumber[wave] * mAmplitude[wave];
+		}
+
+		// Same steepness for every wave, scaled so the sum stays below 1 and crests never loop over.
+		const float choppiness = std::min(std::max(settings.Choppiness, 0.0f), 1.0f);
+		for (int32_t wave = 0; wave < numWaves; ++wave)
+		{
+			mHorizontalAmplitude[wave] = (slopeSum > 0.0f) ? (choppiness * mAmplitude[wave] / slopeSum) : 0.0f;
+		}
+	}
+
+	void FGerstnerOcean::SampleDisplacements(const float* x, const float* y, int32_t count, double time, float* outX, float* outY, float* outZ) const
+	{
+		for (int32_t blockBegin = 0; blockBegin < count; blockBegin += SampleBlockSize)
+		{
+			const int32_t blockCount = std::min(SampleBlockSize, count - blockBegin);
+			const float* blockX = x + blockBegin;
+			const float* blockY = y + blockBegin;
+
+			float accumulatedX[SampleBlockSize] = {};
+			float accumulatedY[SampleBlockSize] = {};
+			float accumulatedZ[SampleBlockSize] = {};
+
+			for (int32_t wave = 0; wave < NumWaves(); ++wave)
+			{
+				// Wrapped in double so the phase stays accurate however long the game runs.
+				FWaveTerm term;
+				term.WaveVectorX = mWaveNumber[wave] * mDirectionX[wave];
+				term.WaveVectorY = mWaveNumber[wave] * mDirectionY[wave];
+				term.TimePhase = static_cast<float>(std::fmod((mAngularFrequency[wave] * time) - mPhase[wave], TwoPi));
+				term.HorizontalX = mHorizontalAmplitude[wave] * mDirectionX[wave];
+				term.HorizontalY = mHorizontalAmplitude[wave] * mDirectionY[wave];
+				term.Amplitude = mAmplitude[wave];
+
+				int32_t vectorEnd = 0;
+#if HULLKERNEL_X86
+				vectorEnd = blockCount - (blockCount % FSSELanes::Width);
+				AccumulateWave<FSSELanes>(term, blockX, blockY, 0, vectorEnd, accumulatedX, accumulatedY, accumulatedZ);
+#endif
+				AccumulateWave<FScalarLanes>(term, blockX, blockY, vectorEnd, blockCount, accumulatedX, accumulatedY, accumulatedZ);
+			}
+
+			if (outX)
+			{
+				std::copy(accumulatedX, accumulatedX + blockCount, outX + blockBegin);
+			}
+			if (outY)
+			{
+				std::copy(accumulatedY, accumulatedY + blockCount, outY + blockBegin);
+			}
+			if (outZ)
+			{
+				std::copy(accumulatedZ, accumulatedZ + blockCount, outZ + blockBegin);
+			}
+		}
+	}
+
+	void FGerstnerOcean::SampleSurfaceHeights(const float* x, const float* y, int32_t count, double time, FDisplacementInversion& inversion, float* outZ) const
+	{
+		inversion.Begin(x, y, count);
+		while (inversion.NumActive() > 0)
+		{
+			SampleDisplacements(inversion.ActiveX(), inversion.ActiveY(), inversion.NumActive(), time, inversion.DisplacementX(), inversion.DisplacementY(), inversion.DisplacementZ());
+			inversion.Step(outZ);
+		}
+	}
+
+	bool FGerstnerOcean::Raycast(const float origin[3], const float direction[3], float maxDistance, double time, float outPoint[3]) const
+	{
+		// Height of the ray above the water under it. The water is sampled at the ray position directly,
+		// which ignores the small horizontal shift of the choppy displacement.
+		auto heightAboveWater = [&](float distance)
+		{
+			const float x = origin[0] + (direction[0] * distance);
+			const float y = origin[1] + (direction[1] * distance);
+			float waterHeight;
+			SampleDisplacements(&x, &y, 1, time, nullptr, nullptr, &waterHeight);
+			return (origin[2] + (direction[2] * distance)) - waterHeight;
+		};
+
+		// March at a fraction of the shortest wavelength so no crest is stepped over, then bisect the crossing.
+		float shortestWavelength = maxDistance;
+		for (int32_t wave = 0; wave < NumWaves(); ++wave)
+		{
+			shortestWavelength = std::min(shortestWavelength, static_cast<float>(TwoPi) / mWaveNumber[wave]);
+		}
+		const float step = std::max(shortestWavelength * 0.125f, maxDistance / RaycastMaxSteps);
+
+		float previousDistance = 0.0f;
+		if (heightAboveWater(0.0f) <= 0.0f)
+		{
+			return false;
+		}
+
+		for (float distance = step; previousDistance < maxDistance; distance += step)
+		{
+			distance = std::min(distance, maxDistance);
+			if (heightAboveWater(distance) <= 0.0f)
+			{
+				float above = previousDistance;
+				float below = distance;
+				for (int32_t bisection = 0; bisection < RaycastBisections; ++bisection)
+				{
+					const float middle = 0.5f * (above + below);
+					if (heightAboveWater(middle) > 0.0f)
+					{
+						above = middle;
+					}
+					else
+					{
+						below = middle;
+					}
+				}
+
+				outPoint[0] = origin[0] + (direction[0] * below);
+				outPoint[1] = origin[1] + (direction[1] * below);
+				outPoint[2] = origin[2] + (direction[2] * below);
+				return true;
+			}
+
+			previousDistance = distance;
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernelTypes.h"
+
+#include <vector>
+
+namespace HullKernel
+{
+	class FDisplacementInversion;
+
+	// Sea state the wave set is generated from.
+	struct FGerstnerSettings
+	{
+		int32_t NumWaves;
+
+		// Direction (degrees, around Z from +X) and speed (m/s) of the wind, which sets the dominant wavelength.
+		float WindDirection;
+		float WindSpeed;
+
+		// Half angle (degrees) the wave directions are spread over around the wind.
+		float DirectionalSpread;
+
+		// Multiplier on the spectrum amplitudes.
+		float AmplitudeScale;
+
+		// 0 gives round sine waves, 1 the sharpest crests that do not loop over.
+		float Choppiness;
+
+		// Same seed and settings give the same ocean on every machine.
+		uint32_t Seed;
+	};
+
+	FGerstnerSettings DefaultGerstnerSettings();
+
+	/**
+	 * Deterministic CPU ocean made of a sum of Gerstner waves with amplitudes from a Pierson-Moskowitz spectrum.
+	 * Stands in for the WaveWorks GPU simulation where there is no GPU (dedicated servers, headless tests) and lets
+	 * physics sample the water synchronously. Works in metres and seconds like the WaveWorks sampling API.
+	 * Immutable after Build, so it can be sampled from any thread.
+	 */
+	class FGerstnerOcean
+	{
+	public:
+		FGerstnerOcean();
+
+		void Build(const FGerstnerSettings& settings);
+
+		int32_t NumWaves() const { return static_cast<int32_t>(mAmplitude.size()); }
+
+		// Displacement (m) of the surface point whose undisplaced position is (x, y) (m), at time (s).
+		// Several points are evaluated per instruction with SSE. Any of the outputs may be null.
+		void SampleDisplacements(const float* x, const float* y, int32_t count, double time, float* outX, float* outY, float* outZ) const;
+
+		// Height (m) of the surface right above each point (x, y) (m), at time (s). The choppy displacement is
+		// inverted with the offsets inversion kept from the previous call, so mostly one sample per point.
+		void SampleSurfaceHeights(const float* x, const float* y, int32_t count, double time, FDisplacementInversion& inversion, float* outZ) const;
+
+		// First intersection (m) of the ray with the displaced surface within maxDistance (m).
+		bool Raycast(const float origin[3], const float direction[3], float maxDistance, double time, float outPoint[3]) const;
+
+	private:
+		// Per wave structure-of-arrays.
+		std::vector<float> mDirectionX;
+		std::vector<float> mDirectionY;
+		std::vector<float> mWaveNumber;
+		std::vector<float> mAngularFrequency;
+		std::vector<float> mPhase;
+		std::vector<float> mAmplitude;
+
+		// Horizontal displacement amplitude, Gerstner steepness times amplitude.
+		std::vector<float> mHorizontalAmplitude;
+	};
+}
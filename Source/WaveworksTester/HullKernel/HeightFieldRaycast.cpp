@@ -0,0 +1,534 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HeightFieldRaycast.h"
+#include "HullForceKernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if HULLKERNEL_X86
+#include <emmintrin.h>
+#endif
+
+namespace HullKernel
+{
+	// Stands in for infinity in the root selection, so fast math builds keep comparing it like a number.
+	static const float FarDistance = 3.0e38f;
+
+	// Below these a coefficient counts as zero and the root using it as a denominator is dropped.
+	static const float TinyQuadratic = 1.0e-12f;
+	static const float TinyDenominator = 1.0e-20f;
+
+	// A ray looks up its next cell this far (in cells) past where it left the last one, so a ray running along
+	// a cell border still gets to the other side.
+	static const float CellNudge = 1.0e-3f;
+
+	namespace
+	{
+		struct FScalarLanes
+		{
+			typedef float FValue;
+			typedef bool FMask;
+			static const int32_t Width = 1;
+
+			static HULLKERNEL_FORCEINLINE FValue Set(float value) { return value; }
+			static HULLKERNEL_FORCEINLINE FValue Load(const float* source) { return *source; }
+			static HULLKERNEL_FORCEINLINE void Store(float* destination, FValue value) { *destination = value; }
+			static HULLKERNEL_FORCEINLINE FValue Add(FValue a, FValue b) { return a + b; }
+			static HULLKERNEL_FORCEINLINE FValue Sub(FValue a, FValue b) { return a - b; }
+			static HULLKERNEL_FORCEINLINE FValue Mul(FValue a, FValue b) { return a * b; }
+			static HULLKERNEL_FORCEINLINE FValue Div(FValue a, FValue b) { return a / b; }
+
+			// Same operand order as minps and maxps, which return the second operand unless the first wins.
+			static HULLKERNEL_FORCEINLINE FValue Min(FValue a, FValue b) { return (a < b) ? a : b; }
+			static HULLKERNEL_FORCEINLINE FValue Max(FValue a, FValue b) { return (a > b) ? a : b; }
+
+			static HULLKERNEL_FORCEINLINE FValue Sqrt(FValue a) { return std::sqrt(a); }
+			static HULLKERNEL_FORCEINLINE FValue Abs(FValue a) { return std::fabs(a); }
+			static HULLKERNEL_FORCEINLINE FValue Truncate(FValue a) { return static_cast<float>(static_cast<int32_t>(a)); }
+
+			static HULLKERNEL_FORCEINLINE FMask Greater(FValue a, FValue b) { return a > b; }
+			static HULLKERNEL_FORCEINLINE FMask GreaterEqual(FValue a, FValue b) { return a >= b; }
+			static HULLKERNEL_FORCEINLINE FMask LessEqual(FValue a, FValue b) { return a <= b; }
+			static HULLKERNEL_FORCEINLINE FMask Less(FValue a, FValue b) { return a < b; }
+			static HULLKERNEL_FORCEINLINE FMask And(FMask a, FMask b) { return a && b; }
+			static HULLKERNEL_FORCEINLINE FValue Select(FMask mask, FValue a, FValue b) { return mask ? a : b; }
+			static HULLKERNEL_FORCEINLINE int32_t Bits(FMask mask) { return mask ? 1 : 0; }
+		};
+
+#if HULLKERNEL_X86
+		struct FSSELanes
+		{
+			typedef __m128 FValue;
+			typedef __m128 FMask;
+			static const int32_t Width = 4;
+
+			static HULLKERNEL_FORCEINLINE FValue Set(float value) { return _mm_set1_ps(value); }
+			static HULLKERNEL_FORCEINLINE FValue Load(const float* source) { return _mm_loadu_ps(source); }
+			static HULLKERNEL_FORCEINLINE void Store(float* destination, FValue value) { _mm_storeu_ps(destination, value); }
+			static HULLKERNEL_FORCEINLINE FValue Add(FValue a, FValue b) { return _mm_add_ps(a, b); }
+			static HULLKERNEL_FORCEINLINE FValue Sub(FValue a, FValue b) { return _mm_sub_ps(a, b); }
+			static HULLKERNEL_FORCEINLINE FValue Mul(FValue a, FValue b) { return _mm_mul_ps(a, b); }
+			static HULLKERNEL_FORCEINLINE FValue Div(FValue a, FValue b) { return _mm_div_ps(a, b); }
+			static HULLKERNEL_FORCEINLINE FValue Min(FValue a, FValue b) { return _mm_min_ps(a, b); }
+			static HULLKERNEL_FORCEINLINE FValue Max(FValue a, FValue b) { return _mm_max_ps(a, b); }
+			static HULLKERNEL_FORCEINLINE FValue Sqrt(FValue a) { return _mm_sqrt_ps(a); }
+			static HULLKERNEL_FORCEINLINE FValue Abs(FValue a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+			static HULLKERNEL_FORCEINLINE FValue Truncate(FValue a) { return _mm_cvtepi32_ps(_mm_cvttps_epi32(a)); }
+
+			static HULLKERNEL_FORCEINLINE FMask Greater(FValue a, FValue b) { return _mm_cmpgt_ps(a, b); }
+			static HULLKERNEL_FORCEINLINE FMask GreaterEqual(FValue a, FValue b) { return _mm_cmpge_ps(a, b); }
+			static HULLKERNEL_FORCEINLINE FMask LessEqual(FValue a, FValue b) { return _mm_cmple_ps(a, b); }
+			static HULLKERNEL_FORCEINLINE FMask Less(FValue a, FValue b) { return _mm_cmplt_ps(a, b); }
+			static HULLKERNEL_FORCEINLINE FMask And(FMask a, FMask b) { return _mm_and_ps(a, b); }
+			static HULLKERNEL_FORCEINLINE FValue Select(FMask mask, FValue a, FValue b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+			static HULLKERNEL_FORCEINLINE int32_t Bits(FMask mask) { return _mm_movemask_ps(mask); }
+		};
+#endif
+
+		// Rays in flight, one per lane, in grid space (the grid origin at zero) so the cell bounds stay exact far from
+		// the world origin.
+		template <int32_t Width>
+		struct FRayLanes
+		{
+			float OriginX[Width];
+			float OriginY[Width];
+			float OriginZ[Width];
+			float DirectionX[Width];
+			float DirectionY[Width];
+			float DirectionZ[Width];
+
+			// Distance the ray has been traced to, and where it leaves the grid or reaches maxDistance.
+			float Distance[Width];
+			float End[Width];
+
+			// Pyramid level of the cell looked at next, with the cell size and last cell index of that level.
+			int32_t Level[Width];
+			float CellSize[Width];
+			float LastColumn[Width];
+			float LastRow[Width];
+
+			// Index of the ray in the batch, -1 for an idle lane, and the rounds it has taken so far.
+			int32_t Ray[Width];
+			int32_t Rounds[Width];
+
+			void SetLevel(const FHeightFieldPyramid& pyramid, int32_t lane, int32_t level)
+			{
+				Level[lane] = level;
+				CellSize[lane] = pyramid.Layout().CellSize * static_cast<float>(1 << level);
+				LastColumn[lane] = static_cast<float>(pyramid.LevelWidth(level) - 1);
+				LastRow[lane] = static_cast<float>(pyramid.LevelHeight(level) - 1);
+			}
+		};
+
+		// Cell each ray is in, gathered from the pyramid for the vector part.
+		template <int32_t Width>
+		struct FCellLanes
+		{
+			float Column[Width];
+			float Row[Width];
+			float LowestWater[Width];
+			float HighestWater[Width];
+
+			// Node heights at the corners of level 0 cells, (min X, min Y), (max X, min Y), (min X, max Y), (max X, max Y).
+			float Corner00[Width];
+			float Corner10[Width];
+			float Corner01[Width];
+			float Corner11[Width];
+		};
+
+		// Clips the ray to the grid, false when it misses it within maxDistance.
+		bool ClipToGrid(float origin, float direction, float gridSize, float& inOutNear, float& inOutFar)
+		{
+			if (direction == 0.0f)
+			{
+				return (origin >= 0.0f) && (origin <= gridSize);
+			}
+
+			float enter = (0.0f - origin) / direction;
+			float leave = (gridSize - origin) / direction;
+			if (enter > leave)
+			{
+				std::swap(enter, leave);
+			}
+			inOutNear = std::max(inOutNear, enter);
+			inOutFar = std::min(inOutFar, leave);
+			return inOutNear <= inOutFar;
+		}
+
+		// Puts the next ray that crosses the grid into the lane and answers the ones that miss it right away.
+		// Leaves the lane idle once the batch is used up.
+		template <int32_t Width>
+		void StartNextRay(const FHeightFieldPyramid& pyramid, const FRayBatch& batch, float maxDistance, int32_t end, int32_t& inOutNextRay,
+			FRayLanes<Width>& rays, int32_t lane, float* outDistances)
+		{
+			const FHeightGridLayout& layout = pyramid.Layout();
+			const float gridSizeX = (layout.NumX - 1) * layout.CellSize;
+			const float gridSizeY = (layout.NumY - 1) * layout.CellSize;
+
+			rays.Ray[lane] = -1;
+			while (inOutNextRay < end)
+			{
+				const int32_t ray = inOutNextRay++;
+				const float originX = batch.OriginX[ray] - layout.OriginX;
+				const float originY = batch.OriginY[ray] - layout.OriginY;
+
+				float nearDistance = 0.0f;
+				float farDistance = maxDistance;
+				if (!ClipToGrid(originX, batch.DirectionX[ray], gridSizeX, nearDistance, farDistance)
+					|| !ClipToGrid(originY, batch.DirectionY[ray], gridSizeY, nearDistance, farDistance))
+				{
+					outDistances[ray] = -1.0f;
+					continue;
+				}
+
+				rays.OriginX[lane] = originX;
+				rays.OriginY[lane] = originY;
+				rays.OriginZ[lane] = batch.OriginZ[ray];
+				rays.DirectionX[lane] = batch.DirectionX[ray];
+				rays.DirectionY[lane] = batch.DirectionY[ray];
+				rays.DirectionZ[lane] = batch.DirectionZ[ray];
+				rays.Distance[lane] = nearDistance;
+				rays.End[lane] = farDistance;
+				rays.SetLevel(pyramid, lane, pyramid.NumLevels() - 1);
+				rays.Ray[lane] = ray;
+				rays.Rounds[lane] = 0;
+				return;
+			}
+
+			// Harmless values for the arithmetic of the idle lane.
+			rays.OriginX[lane] = rays.OriginY[lane] = rays.OriginZ[lane] = 0.0f;
+			rays.DirectionX[lane] = rays.DirectionY[lane] = 0.0f;
+			rays.DirectionZ[lane] = -1.0f;
+			rays.Distance[lane] = rays.End[lane] = 0.0f;
+			rays.SetLevel(pyramid, lane, 0);
+		}
+
+		template <int32_t Width>
+		void GatherCell(const FHeightFieldPyramid& pyramid, const FRayLanes<Width>& rays, int32_t lane, FCellLanes<Width>& inOutCells)
+		{
+			const int32_t level = rays.Level[lane];
+			const int32_t column = static_cast<int32_t>(inOutCells.Column[lane]);
+			const int32_t row = static_cast<int32_t>(inOutCells.Row[lane]);
+
+			const int32_t cell = (row * pyramid.LevelWidth(level)) + column;
+			inOutCells.LowestWater[lane] = pyramid.LevelMin(level)[cell];
+			inOutCells.HighestWater[lane] = pyramid.LevelMax(level)[cell];
+
+			if (level == 0)
+			{
+				const int32_t numX = pyramid.Layout().NumX;
+				const float* corner = pyramid.NodeHeights() + (row * numX) + column;
+				inOutCells.Corner00[lane] = corner[0];
+				inOutCells.Corner10[lane] = corner[1];
+				inOutCells.Corner01[lane] = corner[numX];
+				inOutCells.Corner11[lane] = corner[numX + 1];
+			}
+			else
+			{
+				inOutCells.Corner00[lane] = 0.0f;
+				inOutCells.Corner10[lane] = 0.0f;
+				inOutCells.Corner01[lane] = 0.0f;
+				inOutCells.Corner11[lane] = 0.0f;
+			}
+		}
+
+		// Traces rays [begin, end) of the batch Width at a time. Each round every lane's ray looks at one cell: it passes
+		// above it, ends up below its lowest water, descends a level, or, in a level 0 cell, solves for where it crosses
+		// the bilinear surface. A lane whose ray is done takes the next one of the batch straight away, so long rays
+		// do not hold up the others. Only the loads from the pyramid and the decisions run per lane.
+		template <typename Lanes>
+		void TraceRays(const FHeightFieldPyramid& pyramid, const FRayBatch& batch, int32_t begin, int32_t end, float maxDistance, float* outDistances)
+		{
+			typedef typename Lanes::FValue FValue;
+			typedef typename Lanes::FMask FMask;
+			const int32_t Width = Lanes::Width;
+
+			const FHeightGridLayout& layout = pyramid.Layout();
+			const int32_t topLevel = pyramid.NumLevels() - 1;
+
+			// Every round moves a ray to the next cell or a level down, so this is only hit on broken input.
+			const int32_t maxRounds = 4 * (layout.NumX + layout.NumY) * (topLevel + 2);
+
+			const FValue zero = Lanes::Set(0.0f);
+			const FValue one = Lanes::Set(1.0f);
+			const FValue farAway = Lanes::Set(FarDistance);
+			const FValue nudge = Lanes::Set(CellNudge * layout.CellSize);
+			const FValue inverseCellSize = Lanes::Set(1.0f / layout.CellSize);
+
+			FRayLanes<Width> rays;
+			FCellLanes<Width> cells;
+			float exitDistances[Width];
+			float hitDistances[Width];
+
+			int32_t nextRay = begin;
+			int32_t numActive = 0;
+			for (int32_t lane = 0; lane < Width; ++lane)
+			{
+				StartNextRay(pyramid, batch, maxDistance, end, nextRay, rays, lane, outDistances);
+				numActive += (rays.Ray[lane] >= 0) ? 1 : 0;
+			}
+
+			while (numActive > 0)
+			{
+				const FValue originX = Lanes::Load(rays.OriginX);
+				const FValue originY = Lanes::Load(rays.OriginY);
+				const FValue originZ = Lanes::Load(rays.OriginZ);
+				const FValue directionX = Lanes::Load(rays.DirectionX);
+				const FValue directionY = Lanes::Load(rays.DirectionY);
+				const FValue directionZ = Lanes::Load(rays.DirectionZ);
+				const FValue distance = Lanes::Load(rays.Distance);
+				const FValue cellSize = Lanes::Load(rays.CellSize);
+
+				// Cell a little past where the ray is, clamped into the level. Clamping first makes truncation a floor.
+				const FValue lookup = Lanes::Add(distance, nudge);
+				const FValue column = Lanes::Truncate(Lanes::Min(Lanes::Max(Lanes::Div(Lanes::Add(originX, Lanes::Mul(directionX, lookup)), cellSize), zero), Lanes::Load(rays.LastColumn)));
+				const FValue row = Lanes::Truncate(Lanes::Min(Lanes::Max(Lanes::Div(Lanes::Add(originY, Lanes::Mul(directionY, lookup)), cellSize), zero), Lanes::Load(rays.LastRow)));
+				Lanes::Store(cells.Column, column);
+				Lanes::Store(cells.Row, row);
+
+				for (int32_t lane = 0; lane < Width; ++lane)
+				{
+					GatherCell(pyramid, rays, lane, cells);
+				}
+
+				const FValue cellMinX = Lanes::Mul(column, cellSize);
+				const FValue cellMinY = Lanes::Mul(row, cellSize);
+
+				// Where the ray leaves the cell, always a little past where it is. Rays that never cross a cell border
+				// along an axis leave at their end.
+				const FMask bMovesX = Lanes::Greater(Lanes::Abs(directionX), zero);
+				const FMask bMovesY = Lanes::Greater(Lanes::Abs(directionY), zero);
+				const FValue borderX = Lanes::Select(Lanes::Greater(directionX, zero), Lanes::Add(cellMinX, cellSize), cellMinX);
+				const FValue borderY = Lanes::Select(Lanes::Greater(directionY, zero), Lanes::Add(cellMinY, cellSize), cellMinY);
+				const FValue exitX = Lanes::Select(bMovesX, Lanes::Div(Lanes::Sub(borderX, originX), Lanes::Select(bMovesX, directionX, one)), farAway);
+				const FValue exitY = Lanes::Select(bMovesY, Lanes::Div(Lanes::Sub(borderY, originY), Lanes::Select(bMovesY, directionY, one)), farAway);
+				FValue exit = Lanes::Min(Lanes::Min(exitX, exitY), Lanes::Load(rays.End));
+				exit = Lanes::Max(exit, Lanes::Add(distance, nudge));
+
+				// Conservative tests against the water range of the cell.
+				const FValue enterZ = Lanes::Add(originZ, Lanes::Mul(directionZ, distance));
+				const FValue exitZ = Lanes::Add(originZ, Lanes::Mul(directionZ, exit));
+				const int32_t aboveBits = Lanes::Bits(Lanes::Greater(Lanes::Min(enterZ, exitZ), Lanes::Load(cells.HighestWater)));
+				const int32_t belowBits = Lanes::Bits(Lanes::Less(Lanes::Max(enterZ, exitZ), Lanes::Load(cells.LowestWater)));
+
+				// Height of the ray above the bilinear surface as a quadratic in s, the distance past where it entered:
+				// f(s) = c0 + c1 s + c2 s^2, with the cell coordinates u = u0 + du s and v = v0 + dv s.
+				const FValue h00 = Lanes::Load(cells.Corner00);
+				const FValue h10 = Lanes::Load(cells.Corner10);
+				const FValue h01 = Lanes::Load(cells.Corner01);
+				const FValue h11 = Lanes::Load(cells.Corner11);
+				const FValue slopeU = Lanes::Sub(h10, h00);
+				const FValue slopeV = Lanes::Sub(h01, h00);
+				const FValue twist = Lanes::Sub(Lanes::Sub(Lanes::Add(h00, h11), h10), h01);
+
+				const FValue u0 = Lanes::Mul(Lanes::Sub(Lanes::Add(originX, Lanes::Mul(directionX, distance)), cellMinX), inverseCellSize);
+				const FValue v0 = Lanes::Mul(Lanes::Sub(Lanes::Add(originY, Lanes::Mul(directionY, distance)), cellMinY), inverseCellSize);
+				const FValue du = Lanes::Mul(directionX, inverseCellSize);
+				const FValue dv = Lanes::Mul(directionY, inverseCellSize);
+
+				const FValue waterAtEntry = Lanes::Add(Lanes::Add(Lanes::Add(h00, Lanes::Mul(slopeU, u0)), Lanes::Mul(slopeV, v0)), Lanes::Mul(twist, Lanes::Mul(u0, v0)));
+				const FValue waterSlope = Lanes::Add(Lanes::Add(Lanes::Mul(slopeU, du), Lanes::Mul(slopeV, dv)), Lanes::Mul(twist, Lanes::Add(Lanes::Mul(u0, dv), Lanes::Mul(v0, du))));
+				const FValue c0 = Lanes::Sub(enterZ, waterAtEntry);
+				const FValue c1 = Lanes::Sub(directionZ, waterSlope);
+				const FValue c2 = Lanes::Sub(zero, Lanes::Mul(twist, Lanes::Mul(du, dv)));
+				const FValue length = Lanes::Sub(exit, distance);
+
+				// Both roots in the cancellation free form, q = -(c1 + sign(c1) sqrt(d)) / 2, roots q / c2 and c0 / q.
+				const FValue discriminant = Lanes::Sub(Lanes::Mul(c1, c1), Lanes::Mul(Lanes::Set(4.0f), Lanes::Mul(c2, c0)));
+				const FMask bReal = Lanes::GreaterEqual(discriminant, zero);
+				const FValue root = Lanes::Sqrt(Lanes::Max(discriminant, zero));
+				const FValue q = Lanes::Mul(Lanes::Set(-0.5f), Lanes::Add(c1, Lanes::Select(Lanes::GreaterEqual(c1, zero), root, Lanes::Sub(zero, root))));
+
+				const FMask bQuadratic = Lanes::Greater(Lanes::Abs(c2), Lanes::Set(TinyQuadratic));
+				const FMask bDividesQ = Lanes::Greater(Lanes::Abs(q), Lanes::Set(TinyDenominator));
+				const FValue firstRoot = Lanes::Div(q, Lanes::Select(bQuadratic, c2, one));
+				const FValue secondRoot = Lanes::Div(c0, Lanes::Select(bDividesQ, q, one));
+
+				const FMask bFirstValid = Lanes::And(Lanes::And(bReal, bQuadratic), Lanes::And(Lanes::GreaterEqual(firstRoot, zero), Lanes::LessEqual(firstRoot, length)));
+				const FMask bSecondValid = Lanes::And(Lanes::And(bReal, bDividesQ), Lanes::And(Lanes::GreaterEqual(secondRoot, zero), Lanes::LessEqual(secondRoot, length)));
+				FValue crossing = Lanes::Min(Lanes::Select(bFirstValid, firstRoot, farAway), Lanes::Select(bSecondValid, secondRoot, farAway));
+
+				// Already under the surface where it entered the cell.
+				crossing = Lanes::Select(Lanes::LessEqual(c0, zero), zero, crossing);
+				const FValue hit = Lanes::Select(Lanes::Less(crossing, farAway), Lanes::Add(distance, crossing), Lanes::Set(-1.0f));
+
+				Lanes::Store(exitDistances, exit);
+				Lanes::Store(hitDistances, hit);
+
+				for (int32_t lane = 0; lane < Width; ++lane)
+				{
+					const int32_t ray = rays.Ray[lane];
+					if (ray < 0)
+					{
+						continue;
+					}
+
+					bool bDone = false;
+					bool bAdvance = false;
+					if ((belowBits >> lane) & 1)
+					{
+						// Above the water up to here and below all of it in the cell, so it went in right here.
+						outDistances[ray] = rays.Distance[lane];
+						bDone = true;
+					}
+					else if ((aboveBits >> lane) & 1)
+					{
+						bAdvance = true;
+					}
+					else if (rays.Level[lane] > 0)
+					{
+						rays.SetLevel(pyramid, lane, rays.Level[lane] - 1);
+					}
+					else if (hitDistances[lane] >= 0.0f)
+					{
+						outDistances[ray] = hitDistances[lane];
+						bDone = true;
+					}
+					else
+					{
+						bAdvance = true;
+					}
+
+					if (bAdvance)
+					{
+						if (exitDistances[lane] >= rays.End[lane])
+						{
+							outDistances[ray] = -1.0f;
+							bDone = true;
+						}
+						else
+						{
+							// The next cell is often clear at the coarser level again.
+							rays.Distance[lane] = exitDistances[lane];
+							rays.SetLevel(pyramid, lane, std::min(rays.Level[lane] + 1, topLevel));
+						}
+					}
+
+					if (!bDone && (++rays.Rounds[lane] >= maxRounds))
+					{
+						outDistances[ray] = -1.0f;
+						bDone = true;
+					}
+
+					if (bDone)
+					{
+						StartNextRay(pyramid, batch, maxDistance, end, nextRay, rays, lane, outDistances);
+						numActive -= (rays.Ray[lane] >= 0) ? 0 : 1;
+					}
+				}
+			}
+		}
+	}
+
+	FHeightFieldPyramid::FHeightFieldPyramid() :
+		mLayout(PerPointHeightGrid(0)), mNumLevels(0)
+	{
+	}
+
+	void FHeightFieldPyramid::Reset()
+	{
+		mNumLevels = 0;
+	}
+
+	void FHeightFieldPyramid::Build(const FHeightGridLayout& layout, const float* nodeHeights)
+	{
+		mNumLevels = 0;
+		if (layout.IsPerPoint() || (layout.NumX < 2) || (layout.NumY < 2))
+		{
+			return;
+		}
+
+		mLayout = layout;
+		mNodeHeights.assign(nodeHeights, nodeHeights + layout.NumNodes());
+
+		// Halve the cell count per level, rounding up, until one cell is left.
+		mLevelOffset.clear();
+		mLevelWidth.clear();
+		mLevelHeight.clear();
+		int32_t width = layout.NumX - 1;
+		int32_t height = layout.NumY - 1;
+		int32_t numCells = 0;
+		for (;;)
+		{
+			mLevelOffset.push_back(numCells);
+			mLevelWidth.push_back(width);
+			mLevelHeight.push_back(height);
+			numCells += width * height;
+			if ((width == 1) && (height == 1))
+			{
+				break;
+			}
+			width = (width + 1) / 2;
+			height = (height + 1) / 2;
+		}
+		mNumLevels = static_cast<int32_t>(mLevelOffset.size());
+		mMin.resize(numCells);
+		mMax.resize(numCells);
+
+		for (int32_t row = 0; row < mLevelHeight[0]; ++row)
+		{
+			for (int32_t column = 0; column < mLevelWidth[0]; ++column)
+			{
+				const float* corner = mNodeHeights.data() + (row * layout.NumX) + column;
+				const float* upperCorner = corner + layout.NumX;
+				const int32_t cell = (row * mLevelWidth[0]) + column;
+				mMin[cell] = std::min(std::min(corner[0], corner[1]), std::min(upperCorner[0], upperCorner[1]));
+				mMax[cell] = std::max(std::max(corner[0], corner[1]), std::max(upperCorner[0], upperCorner[1]));
+			}
+		}
+
+		for (int32_t level = 1; level < mNumLevels; ++level)
+		{
+			const int32_t childWidth = mLevelWidth[level - 1];
+			const int32_t childHeight = mLevelHeight[level - 1];
+			const float* childMin = mMin.data() + mLevelOffset[level - 1];
+			const float* childMax = mMax.data() + mLevelOffset[level - 1];
+			float* levelMin = mMin.data() + mLevelOffset[level];
+			float* levelMax = mMax.data() + mLevelOffset[level];
+
+			for (int32_t row = 0; row < mLevelHeight[level]; ++row)
+			{
+				for (int32_t column = 0; column < mLevelWidth[level]; ++column)
+				{
+					// The last row and column of an odd level cover a single child.
+					const int32_t firstChild = (2 * row * childWidth) + (2 * column);
+					const int32_t stepX = (((2 * column) + 1) < childWidth) ? 1 : 0;
+					const int32_t stepY = (((2 * row) + 1) < childHeight) ? childWidth : 0;
+
+					const int32_t cell = (row * mLevelWidth[level]) + column;
+					levelMin[cell] = std::min(std::min(childMin[firstChild], childMin[firstChild + stepX]),
+						std::min(childMin[firstChild + stepY], childMin[firstChild + stepY + stepX]));
+					levelMax[cell] = std::max(std::max(childMax[firstChild], childMax[firstChild + stepX]),
+						std::max(childMax[firstChild + stepY], childMax[firstChild + stepY + stepX]));
+				}
+			}
+		}
+	}
+
+	void RaycastHeightField(const FHeightFieldPyramid& pyramid, const FRayBatch& rays, float maxDistance, float* outDistances, EKernelPath path)
+	{
+		if (pyramid.IsEmpty())
+		{
+			std::fill(outDistances, outDistances + rays.Count, -1.0f);
+			return;
+		}
+
+		// Never run a wider path than the CPU supports. AVX2 machines take the SSE lanes as well, the per lane pyramid loads
+		// dominate and would not get any faster with wider registers.
+		const EKernelPath bestPath = DetectKernelPath();
+		if ((path == EKernelPath::Auto) || (static_cast<uint8_t>(path) > static_cast<uint8_t>(bestPath)))
+		{
+			path = bestPath;
+		}
+
+#if HULLKERNEL_X86
+		if (path != EKernelPath::Scalar)
+		{
+			TraceRays<FSSELanes>(pyramid, rays, 0, rays.Count, maxDistance, outDistances);
+			return;
+		}
+#endif
+		TraceRays<FScalarLanes>(pyramid, rays, 0, rays.Count, maxDistance, outDistances);
+	}
+}
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HeightGrid.h"
+
+#include <vector>
+
+namespace HullKernel
+{
+	/**
+	 * Snapshot of a height grid with the lowest and highest water of every cell, and of every 2x2 block of cells
+	 * one level up, until a single cell covers the whole grid. Rays use it to skip the blocks they pass above.
+	 * Build reuses the arrays of the previous snapshot, so rebuilding one of the same size does not allocate.
+	 */
+	class FHeightFieldPyramid
+	{
+	public:
+		FHeightFieldPyramid();
+
+		// Copies the node heights (cm) of a regular grid of at least 2x2 nodes.
+		void Build(const FHeightGridLayout& layout, const float* nodeHeights);
+
+		void Reset();
+
+		bool IsEmpty() const { return mNumLevels == 0; }
+
+		const FHeightGridLayout& Layout() const { return mLayout; }
+		const float* NodeHeights() const { return mNodeHeights.data(); }
+
+		int32_t NumLevels() const { return mNumLevels; }
+
+		// Cells along X and Y at level, level 0 has one cell between every four nodes.
+		int32_t LevelWidth(int32_t level) const { return mLevelWidth[level]; }
+		int32_t LevelHeight(int32_t level) const { return mLevelHeight[level]; }
+
+		// Per cell minimum and maximum height of a level, row by row along X.
+		const float* LevelMin(int32_t level) const { return mMin.data() + mLevelOffset[level]; }
+		const float* LevelMax(int32_t level) const { return mMax.data() + mLevelOffset[level]; }
+
+	private:
+		FHeightGridLayout mLayout;
+		int32_t mNumLevels;
+
+		std::vector<float> mNodeHeights;
+
+		// Every level one after the other.
+		std::vector<float> mMin;
+		std::vector<float> mMax;
+
+		std::vector<int32_t> mLevelOffset;
+		std::vector<int32_t> mLevelWidth;
+		std::vector<int32_t> mLevelHeight;
+	};
+
+	// Structure-of-arrays rays in world space (cm) with unit directions.
+	struct FRayBatch
+	{
+		const float* OriginX;
+		const float* OriginY;
+		const float* OriginZ;
+
+		const float* DirectionX;
+		const float* DirectionY;
+		const float* DirectionZ;
+
+		int32_t Count;
+	};
+
+	/**
+	 * Distance (cm) along every ray to where it first enters the water of the snapshot, the bilinear surface
+	 * InterpolateHeightGrid samples, or -1 when it stays above it within maxDistance. A ray starting below the
+	 * surface hits at 0. Only the part of a ray above the grid is tested, the water around it is unknown.
+	 * The rays descend the pyramid only where they come close to the water. The SSE path traces 4 rays side by side
+	 * with the same operations as the scalar one, so both give identical distances.
+	 */
+	void RaycastHeightField(const FHeightFieldPyramid& pyramid, const FRayBatch& rays, float maxDistance, float* outDistances,
+		EKernelPath path = EKernelPath::Auto);
+}
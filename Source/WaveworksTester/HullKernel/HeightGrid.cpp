@@ -0,0 +1,184 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HeightGrid.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace HullKernel
+{
+	bool operator==(const FHeightGridLayout& a, const FHeightGridLayout& b)
+	{
+		return (a.OriginX == b.OriginX) && (a.OriginY == b.OriginY) && (a.CellSize == b.CellSize) && (a.NumX == b.NumX) && (a.NumY == b.NumY);
+	}
+
+	FHeightGridLayout PerPointHeightGrid(int32_t count)
+	{
+		FHeightGridLayout layout = { 0.0f, 0.0f, 0.0f, count, 1 };
+		return layout;
+	}
+
+	FHeightGridLayout FitHeightGrid(const float* x, const float* y, int32_t count, float cellSize, float margin)
+	{
+		float minX = FLT_MAX;
+		float minY = FLT_MAX;
+		float maxX = -FLT_MAX;
+		float maxY = -FLT_MAX;
+		for (int32_t i = 0; i < count; ++i)
+		{
+			minX = std::min(minX, x[i]);
+			minY = std::min(minY, y[i]);
+			maxX = std::max(maxX, x[i]);
+			maxY = std::max(maxY, y[i]);
+		}
+		if (count == 0)
+		{
+			minX = minY = maxX = maxY = 0.0f;
+		}
+
+		const float firstX = std::floor((minX - margin) / cellSize);
+		const float firstY = std::floor((minY - margin) / cellSize);
+		const float lastX = std::ceil((maxX + margin) / cellSize);
+		const float lastY = std::ceil((maxY + margin) / cellSize);
+
+		FHeightGridLayout layout;
+		layout.OriginX = firstX * cellSize;
+		layout.OriginY = firstY * cellSize;
+		layout.CellSize = cellSize;
+		layout.NumX = static_cast<int32_t>(lastX - firstX) + 1;
+		layout.NumY = static_cast<int32_t>(lastY - firstY) + 1;
+		return layout;
+	}
+
+	int32_t MaxHeightGridNodes(float extent, float cellSize, float margin)
+	{
+		// Snapping the origin down and the far side up adds at most one cell on top of the covered span.
+		const int32_t numPerAxis = static_cast<int32_t>(std::ceil((extent + (2.0f * margin)) / cellSize)) + 2;
+		return numPerAxis * numPerAxis;
+	}
+
+	bool HeightGridCovers(const FHeightGridLayout& layout, const float* x, const float* y, int32_t count, float margin)
+	{
+		if (layout.IsPerPoint())
+		{
+			return layout.NumX == count;
+		}
+
+		const float minX = layout.OriginX + margin;
+		const float minY = layout.OriginY + margin;
+		const float maxX = layout.OriginX + ((layout.NumX - 1) * layout.CellSize) - margin;
+		const float maxY = layout.OriginY + ((layout.NumY - 1) * layout.CellSize) - margin;
+		for (int32_t i = 0; i < count; ++i)
+		{
+			if ((x[i] < minX) || (x[i] > maxX) || (y[i] < minY) || (y[i] > maxY))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void HeightGridNodePositions(const FHeightGridLayout& layout, float* outX, float* outY)
+	{
+		for (int32_t row = 0; row < layout.NumY; ++row)
+		{
+			for (int32_t column = 0; column < layout.NumX; ++column)
+			{
+				const int32_t node = (row * layout.NumX) + column;
+				outX[node] = layout.OriginX + (column * layout.CellSize);
+				outY[node] = layout.OriginY + (row * layout.CellSize);
+			}
+		}
+	}
+
+	void InterpolateHeightGrid(const FHeightGridLayout& layout, const float* nodeHeights, const float* x, const float* y, int32_t count, float* outHeights)
+	{
+		if (layout.IsPerPoint())
+		{
+			std::copy(nodeHeights, nodeHeights + std::min(count, layout.NumNodes()), outHeights);
+			return;
+		}
+
+		const float inverseCellSize = 1.0f / layout.CellSize;
+		const float maxColumn = static_cast<float>(layout.NumX - 1);
+		const float maxRow = static_cast<float>(layout.NumY - 1);
+		const int32_t lastColumn = std::max(layout.NumX - 2, 0);
+		const int32_t lastRow = std::max(layout.NumY - 2, 0);
+
+		for (int32_t i = 0; i < count; ++i)
+		{
+			const float gridX = std::min(std::max((x[i] - layout.OriginX) * inverseCellSize, 0.0f), maxColumn);
+			const float gridY = std::min(std::max((y[i] - layout.OriginY) * inverseCellSize, 0.0f), maxRow);
+
+			// The last cell also takes the points on the far border.
+			const int32_t column = std::min(static_cast<int32_t>(gridX), lastColumn);
+			const int32_t row = std::min(static_cast<int32_t>(gridY), lastRow);
+			const float fractionX = gridX - column;
+			const float fractionY = gridY - row;
+
+			const float* corner = nodeHeights + (row * layout.NumX) + column;
+			const int32_t stepX = (layout.NumX > 1) ? 1 : 0;
+			const int32_t stepY = (layout.NumY > 1) ? layout.NumX : 0;
+
+			const float bottom = corner[0] + ((corner[stepX] - corner[0]) * fractionX);
+			const float top = corner[stepY] + ((corner[stepY + stepX] - corner[stepY]) * fractionX);
+			outHeights[i] = bottom + ((top - bottom) * fractionY);
+		}
+	}
+
+	FHeightGridHistory::FHeightGridHistory() :
+		mLayout(PerPointHeightGrid(0)), mPreviousTime(0.0), mLatestTime(0.0), mNumSamples(0)
+	{
+	}
+
+	void FHeightGridHistory::Reserve(int32_t numNodes)
+	{
+		mPrevious.reserve(numNodes);
+		mLatest.reserve(numNodes);
+	}
+
+	void FHeightGridHistory::Reset()
+	{
+		mNumSamples = 0;
+	}
+
+	void FHeightGridHistory::Add(const FHeightGridLayout& layout, const float* nodeHeights, double time)
+	{
+		if ((mNumSamples == 0) || (layout != mLayout))
+		{
+			mLayout = layout;
+			mNumSamples = 0;
+		}
+		else if (time <= mLatestTime)
+		{
+			// Out of order or repeated, nothing to learn from it.
+			return;
+		}
+
+		mPrevious.swap(mLatest);
+		mPreviousTime = mLatestTime;
+
+		mLatest.assign(nodeHeights, nodeHeights + layout.NumNodes());
+		mLatestTime = time;
+		mNumSamples = std::min(mNumSamples + 1, 2);
+	}
+
+	void FHeightGridHistory::Evaluate(double time, double maxExtrapolation, float* outNodeHeights) const
+	{
+		const int32_t numNodes = mLayout.NumNodes();
+		if (mNumSamples < 2)
+		{
+			std::copy(mLatest.begin(), mLatest.begin() + numNodes, outNodeHeights);
+			return;
+		}
+
+		// Negative between the samples, interpolating back towards the previous one.
+		const double ahead = std::min(std::max(time - mLatestTime, mPreviousTime - mLatestTime), maxExtrapolation);
+		const float factor = static_cast<float>(ahead / (mLatestTime - mPreviousTime));
+		for (int32_t node = 0; node < numNodes; ++node)
+		{
+			outNodeHeights[node] = mLatest[node] + ((mLatest[node] - mPrevious[node]) * factor);
+		}
+	}
+}
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernelTypes.h"
+
+#include <vector>
+
+namespace HullKernel
+{
+	// Regular grid of water samples in world space (cm). A cell size of zero means one sample per point instead.
+	struct FHeightGridLayout
+	{
+		float OriginX;
+		float OriginY;
+		float CellSize;
+		int32_t NumX;
+		int32_t NumY;
+
+		bool IsPerPoint() const { return CellSize <= 0.0f; }
+		int32_t NumNodes() const { return NumX * NumY; }
+	};
+
+	bool operator==(const FHeightGridLayout& a, const FHeightGridLayout& b);
+	inline bool operator!=(const FHeightGridLayout& a, const FHeightGridLayout& b) { return !(a == b); }
+
+	// Layout sampling every one of count points directly.
+	FHeightGridLayout PerPointHeightGrid(int32_t count);
+
+	// Smallest grid of cellSize cells covering the points plus margin. The origin is snapped to the cell size,
+	// so a hull moving around inside keeps sampling the same world positions.
+	FHeightGridLayout FitHeightGrid(const float* x, const float* y, int32_t count, float cellSize, float margin);
+
+	// Most nodes FitHeightGrid can return for points spread over at most extent along X and Y.
+	int32_t MaxHeightGridNodes(float extent, float cellSize, float margin);
+
+	// True when every point lies at least margin inside the grid.
+	bool HeightGridCovers(const FHeightGridLayout& layout, const float* x, const float* y, int32_t count, float margin);
+
+	// Positions of the nodes, row by row along X.
+	void HeightGridNodePositions(const FHeightGridLayout& layout, float* outX, float* outY);
+
+	// Bilinear interpolation of the node heights under every point, points outside are clamped to the border.
+	// Per point layouts copy the node heights through.
+	void InterpolateHeightGrid(const FHeightGridLayout& layout, const float* nodeHeights, const float* x, const float* y, int32_t count, float* outHeights);
+
+	/**
+	 * Last two height samples of a grid, so the heights can be interpolated between them or extrapolated to the
+	 * current time while the next sample is still in flight or has not been requested yet.
+	 */
+	class FHeightGridHistory
+	{
+	public:
+		FHeightGridHistory();
+
+		void Reserve(int32_t numNodes);
+
+		void Reset();
+
+		// A sample of another layout than the latest one restarts the history.
+		void Add(const FHeightGridLayout& layout, const float* nodeHeights, double time);
+
+		bool IsEmpty() const { return mNumSamples == 0; }
+
+		const FHeightGridLayout& Layout() const { return mLayout; }
+
+		// Node heights at time, linear between the last two samples and moved on linearly past the latest,
+		// at most maxExtrapolation seconds. Times before the previous sample get the previous heights.
+		void Evaluate(double time, double maxExtrapolation, float* outNodeHeights) const;
+
+	private:
+		FHeightGridLayout mLayout;
+
+		std::vector<float> mPrevious;
+		std::vector<float> mLatest;
+		double mPreviousTime;
+		double mLatestTime;
+		int32_t mNumSamples;
+	};
+}
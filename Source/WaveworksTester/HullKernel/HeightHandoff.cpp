@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HeightHandoff.h"
+
+namespace HullKernel
+{
+	FHeightHandoff::FHeightHandoff() :
+		mShared(1), mWriteIndex(0), mNextSequence(1), mReadIndex(2)
+	{
+		for (FBuffer& buffer : mBuffers)
+		{
+			buffer.Sequence = 0;
+			buffer.Tag = 0;
+		}
+	}
+
+	void FHeightHandoff::Reserve(int32_t count)
+	{
+		// Only valid before the producer and consumer start running.
+		for (FBuffer& buffer : mBuffers)
+		{
+			buffer.Heights.reserve(count);
+		}
+	}
+
+	float* FHeightHandoff::BeginWrite(int32_t count)
+	{
+		FBuffer& buffer = mBuffers[mWriteIndex];
+		buffer.Heights.resize(count);
+		return buffer.Heights.data();
+	}
+
+	void FHeightHandoff::Publish(uint64_t tag)
+	{
+		mBuffers[mWriteIndex].Sequence = mNextSequence++;
+		mBuffers[mWriteIndex].Tag = tag;
+
+		// Release the written heights to the consumer and take back whichever buffer it is not reading.
+		const uint32_t previous = mShared.exchange(mWriteIndex | DirtyBit, std::memory_order_acq_rel);
+		mWriteIndex = previous & ~DirtyBit;
+	}
+
+	FHeightSnapshot FHeightHandoff::Acquire()
+	{
+		if ((mShared.load(std::memory_order_relaxed) & DirtyBit) != 0)
+		{
+			const uint32_t previous = mShared.exchange(mReadIndex, std::memory_order_acq_rel);
+			mReadIndex = previous & ~DirtyBit;
+		}
+
+		const FBuffer& buffer = mBuffers[mReadIndex];
+
+		FHeightSnapshot snapshot;
+		snapshot.Heights = buffer.Heights.data();
+		snapshot.Num = static_cast<int32_t>(buffer.Heights.size());
+		snapshot.Sequence = buffer.Sequence;
+		snapshot.Tag = buffer.Tag;
+		return snapshot;
+	}
+}
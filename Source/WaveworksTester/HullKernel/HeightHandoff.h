@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernelTypes.h"
+
+#include <atomic>
+#include <vector>
+
+namespace HullKernel
+{
+	// Stable view of the latest published heights. Stays valid until the consumer calls Acquire again.
+	struct FHeightSnapshot
+	{
+		const float* Heights;
+		int32_t Num;
+
+		// Increases by one with every publish, zero until the first one arrives.
+		uint64_t Sequence;
+
+		// Whatever the producer published the heights with, e.g. which request they answer.
+		uint64_t Tag;
+	};
+
+	/**
+	 * Lock free triple buffer handing water heights from a single producer (the render thread readback) to a single
+	 * consumer (the force pass). The producer fills its private back buffer and publishes it with one atomic exchange,
+	 * the consumer swaps in the newest published buffer and reads it without ever blocking the producer.
+	 */
+	class FHeightHandoff
+	{
+	public:
+		FHeightHandoff();
+
+		FHeightHandoff(const FHeightHandoff&) = delete;
+		FHeightHandoff& operator=(const FHeightHandoff&) = delete;
+
+		// Preallocates every buffer so that neither side allocates in steady state.
+		void Reserve(int32_t count);
+
+		// Producer: returns the back buffer resized to count heights.
+		float* BeginWrite(int32_t count);
+
+		// Producer: makes the back buffer the latest snapshot.
+		void Publish(uint64_t tag = 0);
+
+		// Consumer: takes the newest published buffer if there is one, otherwise returns the current one again.
+		FHeightSnapshot Acquire();
+
+	private:
+		struct FBuffer
+		{
+			std::vector<float> Heights;
+			uint64_t Sequence;
+			uint64_t Tag;
+		};
+
+		static const uint32_t DirtyBit = 4;
+
+		FBuffer mBuffers[3];
+
+		// Index of the buffer between producer and consumer, or'ed with DirtyBit when the consumer has not seen it yet.
+		std::atomic<uint32_t> mShared;
+
+		// Only touched by the producer.
+		uint32_t mWriteIndex;
+		uint64_t mNextSequence;
+
+		// Only touched by the consumer.
+		uint32_t mReadIndex;
+	};
+}
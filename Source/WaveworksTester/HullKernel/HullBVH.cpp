@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HullBVH.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace HullKernel
+{
+	// Relative slack of the world space box of a node, covering the rounding of the box and of the vertex transform.
+	static const float NodeBoundsTolerance = 1e-5f;
+
+	namespace
+	{
+		struct FHullBVHBuilder
+		{
+			const FHullData& Hull;
+			std::vector<float> Centroids;
+			std::vector<int32_t> Order;
+			std::vector<FHullNode>& Nodes;
+
+			FHullBVHBuilder(const FHullData& hull, std::vector<FHullNode>& outNodes) :
+				Hull(hull), Nodes(outNodes)
+			{
+				const int32_t numTriangles = hull.NumTriangles();
+				Centroids.resize(static_cast<size_t>(numTriangles) * 3);
+				Order.resize(numTriangles);
+				for (int32_t tri = 0; tri < numTriangles; ++tri)
+				{
+					const int32_t* corners = &hull.Indices[tri * 3];
+					Centroids[(tri * 3) + 0] = (hull.X[corners[0]] + hull.X[corners[1]] + hull.X[corners[2]]) * (1.0f / 3.0f);
+					Centroids[(tri * 3) + 1] = (hull.Y[corners[0]] + hull.Y[corners[1]] + hull.Y[corners[2]]) * (1.0f / 3.0f);
+					Centroids[(tri * 3) + 2] = (hull.Z[corners[0]] + hull.Z[corners[1]] + hull.Z[corners[2]]) * (1.0f / 3.0f);
+					Order[tri] = tri;
+				}
+			}
+
+			// Builds the node of the triangles Order [begin, end) and its children, returns its index.
+			int32_t Build(int32_t begin, int32_t end)
+			{
+				const int32_t node = static_cast<int32_t>(Nodes.size());
+				Nodes.push_back(FHullNode());
+				Nodes[node].Begin = begin;
+				Nodes[node].End = end;
+				Nodes[node].Second = 0;
+
+				const int32_t count = end - begin;
+				if (count <= HullClusterTriangles)
+				{
+					std::sort(Order.begin() + begin, Order.begin() + end);
+					return node;
+				}
+
+				float minimum[3] = { Centroids[Order[begin] * 3], Centroids[(Order[begin] * 3) + 1], Centroids[(Order[begin] * 3) + 2] };
+				float maximum[3] = { minimum[0], minimum[1], minimum[2] };
+				for (int32_t i = begin + 1; i < end; ++i)
+				{
+					for (int32_t axis = 0; axis < 3; ++axis)
+					{
+						const float value = Centroids[(Order[i] * 3) + axis];
+						minimum[axis] = std::min(minimum[axis], value);
+						maximum[axis] = std::max(maximum[axis], value);
+					}
+				}
+
+				int32_t axis = 0;
+				for (int32_t other = 1; other < 3; ++other)
+				{
+					if ((maximum[other] - minimum[other]) > (maximum[axis] - minimum[axis]))
+					{
+						axis = other;
+					}
+				}
+
+				// The first half is rounded up to whole leaves. Ties are broken by triangle so the split is a total order.
+				const int32_t firstCount = (((count / 2) + HullClusterTriangles - 1) / HullClusterTriangles) * HullClusterTriangles;
+				const std::vector<float>& centroids = Centroids;
+				std::nth_element(Order.begin() + begin, Order.begin() + begin + firstCount, Order.begin() + end,
+					[&centroids, axis](int32_t a, int32_t b)
+					{
+						const float centroidA = centroids[(a * 3) + axis];
+						const float centroidB = centroids[(b * 3) + axis];
+						return (centroidA < centroidB) || ((centroidA == centroidB) && (a < b));
+					});
+
+				Build(begin, begin + firstCount);
+				const int32_t second = Build(begin + firstCount, end);
+				Nodes[node].Second = second;
+				return node;
+			}
+		};
+	}
+
+	void BuildHullBVH(FHullData& hull)
+	{
+		hull.Nodes.clear();
+		hull.NodeVertices.clear();
+
+		const int32_t numTriangles = hull.NumTriangles();
+		if (numTriangles == 0)
+		{
+			return;
+		}
+
+		std::vector<int32_t> indices(hull.Indices.size());
+		{
+			FHullBVHBuilder builder(hull, hull.Nodes);
+			builder.Build(0, numTriangles);
+
+			for (int32_t tri = 0; tri < numTriangles; ++tri)
+			{
+				const int32_t source = builder.Order[tri];
+				indices[(tri * 3) + 0] = hull.Indices[(source * 3) + 0];
+				indices[(tri * 3) + 1] = hull.Indices[(source * 3) + 1];
+				indices[(tri * 3) + 2] = hull.Indices[(source * 3) + 2];
+			}
+		}
+		hull.Indices.swap(indices);
+
+		// Boxes around the vertices of each node, and the vertices each leaf uses for its exact test.
+		std::vector<int32_t> vertexLeaf(hull.NumVertices(), -1);
+		for (int32_t index = 0; index < static_cast<int32_t>(hull.Nodes.size()); ++index)
+		{
+			FHullNode& node = hull.Nodes[index];
+			const int32_t first = hull.Indices[node.Begin * 3];
+			float minimum[3] = { hull.X[first], hull.Y[first], hull.Z[first] };
+			float maximum[3] = { minimum[0], minimum[1], minimum[2] };
+
+			const bool bLeaf = node.Second == 0;
+			node.VertexBegin = static_cast<int32_t>(hull.NodeVertices.size());
+			for (int32_t i = node.Begin * 3; i < node.End * 3; ++i)
+			{
+				const int32_t vertex = hull.Indices[i];
+				const float position[3] = { hull.X[vertex], hull.Y[vertex], hull.Z[vertex] };
+				for (int32_t axis = 0; axis < 3; ++axis)
+				{
+					minimum[axis] = std::min(minimum[axis], position[axis]);
+					maximum[axis] = std::max(maximum[axis], position[axis]);
+				}
+
+				if (bLeaf && (vertexLeaf[vertex] != index))
+				{
+					vertexLeaf[vertex] = index;
+					hull.NodeVertices.push_back(vertex);
+				}
+			}
+			node.VertexEnd = static_cast<int32_t>(hull.NodeVertices.size());
+			std::sort(hull.NodeVertices.begin() + node.VertexBegin, hull.NodeVertices.end());
+
+			for (int32_t axis = 0; axis < 3; ++axis)
+			{
+				node.Center[axis] = 0.5f * (minimum[axis] + maximum[axis]);
+				node.Extent[axis] = 0.5f * (maximum[axis] - minimum[axis]);
+			}
+		}
+	}
+
+	void BindHullBVH(FHullView& view, const FHullData& hull, const FAffineTransform& transform, const float* waterHeights)
+	{
+		view.Nodes = hull.Nodes.empty() ? nullptr : hull.Nodes.data();
+		view.NodeVertices = hull.NodeVertices.data();
+		view.NumNodes = static_cast<int32_t>(hull.Nodes.size());
+		for (int32_t column = 0; column < 4; ++column)
+		{
+			view.HeightRow[column] = transform.M[2][column];
+		}
+
+		float waterMin = 0.0f;
+		float waterMax = 0.0f;
+		if (view.NumVertices > 0)
+		{
+			waterMin = waterHeights[0];
+			waterMax = waterHeights[0];
+			for (int32_t vertex = 1; vertex < view.NumVertices; ++vertex)
+			{
+				waterMin = std::min(waterMin, waterHeights[vertex]);
+				waterMax = std::max(waterMax, waterHeights[vertex]);
+			}
+		}
+		view.WaterMin = waterMin;
+		view.WaterMax = waterMax;
+	}
+
+	EWaterContact ClassifyHullNodeBounds(const FHullView& hull, const FHullNode& node)
+	{
+		const float* row = hull.HeightRow;
+		const float center = (row[0] * node.Center[0]) + (row[1] * node.Center[1]) + (row[2] * node.Center[2]) + row[3];
+		const float extent = (std::abs(row[0]) * node.Extent[0]) + (std::abs(row[1]) * node.Extent[1]) + (std::abs(row[2]) * node.Extent[2]);
+		const float slack = NodeBoundsTolerance * (std::abs(center) + extent + std::abs(row[3]));
+
+		if ((center - extent - slack) >= hull.WaterMax)
+		{
+			return EWaterContact::Dry;
+		}
+		if ((center + extent + slack) < hull.WaterMin)
+		{
+			return EWaterContact::Submerged;
+		}
+		return EWaterContact::Waterline;
+	}
+
+	EWaterContact ClassifyHullLeaf(const FHullView& hull, const float* waterHeights, const FHullNode& node)
+	{
+		bool bAnyDry = false;
+		bool bAnySubmerged = false;
+		for (int32_t i = node.VertexBegin; i < node.VertexEnd; ++i)
+		{
+			const int32_t vertex = hull.NodeVertices[i];
+			const float height = hull.Z[vertex] - waterHeights[vertex];
+			bAnySubmerged |= height < 0.0f;
+			bAnyDry |= !(height < 0.0f);
+		}
+
+		if (!bAnySubmerged)
+		{
+			return EWaterContact::Dry;
+		}
+		return bAnyDry ? EWaterContact::Waterline : EWaterContact::Submerged;
+	}
+}
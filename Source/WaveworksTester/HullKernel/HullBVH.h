@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullData.h"
+#include "VertexTransform.h"
+
+namespace HullKernel
+{
+	// Most triangles in a leaf of the hierarchy. Every node starts at a multiple of it, so the nodes split a hull at the
+	// same SIMD register boundaries as a whole hull call.
+	static const int32_t HullClusterTriangles = 64;
+
+	// Where a node of the hierarchy is against the water.
+	enum class EWaterContact : uint8_t
+	{
+		// Every vertex above the water, none of the triangles receives force.
+		Dry,
+		// Every vertex below the water, the triangles are integrated whole without clipping.
+		Submerged,
+		// Possibly crossing the waterline, each triangle is classified.
+		Waterline
+	};
+
+	/**
+	 * Reorders the triangles of the hull into spatially coherent clusters and builds the bounding volume hierarchy
+	 * over them, median split along the longest axis of the centroids. The result only depends on the mesh, not on
+	 * the standard library, so cooked hulls and captures stay reproducible.
+	 */
+	void BuildHullBVH(FHullData& hull);
+
+	// Points the view at the hierarchy of hull and bounds the water under its vertices. transform is the mesh to world
+	// transform the vertices of the view were taken through, waterHeights holds one height per vertex.
+	void BindHullBVH(FHullView& view, const FHullData& hull, const FAffineTransform& transform, const float* waterHeights);
+
+	// Conservative test of the box of a node against the range of the water heights.
+	EWaterContact ClassifyHullNodeBounds(const FHullView& hull, const FHullNode& node);
+
+	// Exact test of a leaf from the heights of its vertices above the water, the same ones the kernel compares.
+	EWaterContact ClassifyHullLeaf(const FHullView& hull, const float* waterHeights, const FHullNode& node);
+}
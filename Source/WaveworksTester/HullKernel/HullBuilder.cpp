@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HullBuilder.h"
+
+#include <utility>
+
+namespace HullKernel
+{
+	void FHullBuilder::AppendMesh(const float* vertices, int32_t vertexStride, int32_t numVertices,
+		const void* indices, EIndexWidth indexWidth, int32_t numTriangles, const float* transform)
+	{
+		const int32_t baseVertex = mHull.NumVertices();
+		const size_t numIndices = static_cast<size_t>(numTriangles) * 3;
+
+		mHull.X.reserve(baseVertex + numVertices);
+		mHull.Y.reserve(baseVertex + numVertices);
+		mHull.Z.reserve(baseVertex + numVertices);
+
+		const uint8_t* vertexBytes = reinterpret_cast<const uint8_t*>(vertices);
+		for (int32_t i = 0; i < numVertices; ++i)
+		{
+			const float* vertex = reinterpret_cast<const float*>(vertexBytes + (static_cast<size_t>(i) * vertexStride));
+			float x = vertex[0];
+			float y = vertex[1];
+			float z = vertex[2];
+
+			if (transform)
+			{
+				const float localX = x;
+				const float localY = y;
+				const float localZ = z;
+				x = (transform[0] * localX) + (transform[1] * localY) + (transform[2] * localZ) + transform[3];
+				y = (transform[4] * localX) + (transform[5] * localY) + (transform[6] * localZ) + transform[7];
+				z = (transform[8] * localX) + (transform[9] * localY) + (transform[10] * localZ) + transform[11];
+			}
+
+			mHull.X.push_back(x);
+			mHull.Y.push_back(y);
+			mHull.Z.push_back(z);
+		}
+
+		// Rebase the indices of every mesh after the first onto the merged vertex buffer.
+		mHull.Indices.reserve(mHull.Indices.size() + numIndices);
+		if (indexWidth == EIndexWidth::Bits16)
+		{
+			const uint16_t* source = static_cast<const uint16_t*>(indices);
+			for (size_t i = 0; i < numIndices; ++i)
+			{
+				mHull.Indices.push_back(baseVertex + static_cast<int32_t>(source[i]));
+			}
+		}
+		else
+		{
+			const uint32_t* source = static_cast<const uint32_t*>(indices);
+			for (size_t i = 0; i < numIndices; ++i)
+			{
+				mHull.Indices.push_back(baseVertex + static_cast<int32_t>(source[i]));
+			}
+		}
+	}
+
+	void FHullBuilder::Finish(FHullData& outHull)
+	{
+		FinalizeHullData(mHull);
+		outHull = std::move(mHull);
+		mHull = FHullData();
+	}
+}
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullData.h"
+
+namespace HullKernel
+{
+	enum class EIndexWidth : uint8_t
+	{
+		Bits16,
+		Bits32
+	};
+
+	/**
+	 * Merges any number of triangle meshes into one flat FHullData.
+	 * Used at setup time only, so it favours simplicity over speed.
+	 */
+	class FHullBuilder
+	{
+	public:
+		/**
+		 * Appends a mesh. Vertices are xyz float triples vertexStride bytes apart, indices are three per triangle.
+		 * transform is an optional row major 3x4 affine matrix (rotation/scale columns followed by translation)
+		 * taking the vertices into the space of the hull.
+		 */
+		void AppendMesh(const float* vertices, int32_t vertexStride, int32_t numVertices,
+			const void* indices, EIndexWidth indexWidth, int32_t numTriangles, const float* transform = nullptr);
+
+		int32_t NumVertices() const { return mHull.NumVertices(); }
+		int32_t NumTriangles() const { return mHull.NumTriangles(); }
+
+		// Computes the derived data and moves the merged hull out, leaving the builder empty.
+		void Finish(FHullData& outHull);
+
+	private:
+		FHullData mHull;
+	};
+}
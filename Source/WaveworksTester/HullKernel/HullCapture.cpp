@@ -0,0 +1,228 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HullCapture.h"
+
+#include <cstring>
+
+namespace HullKernel
+{
+	static const uint32_t CaptureMagic = 0x50435757; // "WWCP"
+	// Version 2: slamming coefficients, body mass, area and time step, and the triangle history.
+	// Version 3: force coefficients per step instead of in the header, with the enabled force terms.
+	// Version 4: hulls in cluster order with their hierarchy.
+	// Version 5: no area scale, the kernel takes the areas from the world space vertices.
+	static const uint32_t CaptureVersion = 5;
+
+	// Large enough that a step of a big hull goes to the disk in one write.
+	static const size_t CaptureFileBuffer = 1 << 20;
+
+	static const uint8_t CapturePadding[8] = {};
+
+	static_assert((sizeof(FCaptureHeader) % 8) == 0, "Chunks have to stay 8 byte aligned.");
+	static_assert((sizeof(FCaptureStep) % 8) == 0, "The water heights of a step have to stay aligned.");
+
+	// Id and length in front of the name of a body and the bytes of a hull.
+	struct FCaptureBlobHeader
+	{
+		uint32_t Id;
+		uint32_t NumBytes;
+	};
+
+	FHullCaptureWriter::FHullCaptureWriter() :
+		mFile(nullptr), mBytesWritten(0), mFailed(false)
+	{
+	}
+
+	FHullCaptureWriter::~FHullCaptureWriter()
+	{
+		Close();
+	}
+
+	bool FHullCaptureWriter::Open(const char* fileName, EKernelPath path)
+	{
+		Close();
+
+		mFile = std::fopen(fileName, "wb");
+		if (!mFile)
+		{
+			return false;
+		}
+		std::setvbuf(mFile, nullptr, _IOFBF, CaptureFileBuffer);
+
+		FCaptureHeader header = {};
+		header.Magic = CaptureMagic;
+		header.Version = CaptureVersion;
+		header.Path = static_cast<uint32_t>(path);
+
+		mFailed = std::fwrite(&header, sizeof(header), 1, mFile) != 1;
+		mBytesWritten = sizeof(header);
+		return !mFailed;
+	}
+
+	bool FHullCaptureWriter::Close()
+	{
+		if (!mFile)
+		{
+			return !mFailed;
+		}
+
+		mFailed |= std::fclose(mFile) != 0;
+		mFile = nullptr;
+		return !mFailed;
+	}
+
+	void FHullCaptureWriter::WriteBody(uint32_t id, const char* name)
+	{
+		const FCaptureBlobHeader blob = { id, static_cast<uint32_t>(std::strlen(name)) };
+		const FSegment segments[] = { { &blob, sizeof(blob) }, { name, blob.NumBytes } };
+		WriteChunk(ECaptureChunk::Body, segments, 2);
+	}
+
+	void FHullCaptureWriter::WriteHull(uint32_t id, const FHullData& hull)
+	{
+		SerializeHullData(hull, mScratch);
+
+		const FCaptureBlobHeader blob = { id, static_cast<uint32_t>(mScratch.size()) };
+		const FSegment segments[] = { { &blob, sizeof(blob) }, { mScratch.data(), blob.NumBytes } };
+		WriteChunk(ECaptureChunk::Hull, segments, 2);
+	}
+
+	void FHullCaptureWriter::WriteStep(const FCaptureStep& step, const float* waterHeights)
+	{
+		const FSegment segments[] = { { &step, sizeof(step) }, { waterHeights, static_cast<uint32_t>(step.NumVertices * sizeof(float)) } };
+		WriteChunk(ECaptureChunk::Step, segments, 2);
+	}
+
+	void FHullCaptureWriter::WriteHistory(uint32_t body, const FTriangleForces& forces, int32_t numTriangles)
+	{
+		const FCaptureHistory history = { body, numTriangles };
+		const uint32_t arraySize = static_cast<uint32_t>(numTriangles * sizeof(float));
+		const FSegment segments[] =
+		{
+			{ &history, sizeof(history) },
+			{ forces.SubmergedAreaHistory, arraySize },
+			{ forces.VelocityHistoryX, arraySize },
+			{ forces.VelocityHistoryY, arraySize },
+			{ forces.VelocityHistoryZ, arraySize }
+		};
+		WriteChunk(ECaptureChunk::History, segments, 5);
+	}
+
+	void FHullCaptureWriter::WriteChunk(ECaptureChunk type, const FSegment* segments, int32_t numSegments)
+	{
+		if (!mFile || mFailed)
+		{
+			return;
+		}
+
+		uint32_t size = 0;
+		for (int32_t segment = 0; segment < numSegments; ++segment)
+		{
+			size += segments[segment].Size;
+		}
+		const uint32_t padding = (8 - (size % 8)) % 8;
+		const FCaptureChunkHeader chunk = { type, size + padding };
+
+		bool bWritten = std::fwrite(&chunk, sizeof(chunk), 1, mFile) == 1;
+		for (int32_t segment = 0; segment < numSegments; ++segment)
+		{
+			const FSegment& data = segments[segment];
+			bWritten = bWritten && ((data.Size == 0) || (std::fwrite(data.Data, 1, data.Size, mFile) == data.Size));
+		}
+		bWritten = bWritten && ((padding == 0) || (std::fwrite(CapturePadding, 1, padding, mFile) == padding));
+
+		mFailed = !bWritten;
+		mBytesWritten += sizeof(chunk) + chunk.Size;
+	}
+
+	FHullCaptureReader::FHullCaptureReader() :
+		mHeader(nullptr), mChunk(nullptr), mCursor(nullptr), mEnd(nullptr), mTruncated(false)
+	{
+	}
+
+	bool FHullCaptureReader::Open(const uint8_t* bytes, size_t numBytes)
+	{
+		mHeader = reinterpret_cast<const FCaptureHeader*>(bytes);
+		mChunk = nullptr;
+		mCursor = bytes + sizeof(FCaptureHeader);
+		mEnd = bytes + numBytes;
+		mTruncated = false;
+
+		return (numBytes >= sizeof(FCaptureHeader)) && ((reinterpret_cast<uintptr_t>(bytes) % 8) == 0)
+			&& (mHeader->Magic == CaptureMagic) && (mHeader->Version == CaptureVersion);
+	}
+
+	bool FHullCaptureReader::Next()
+	{
+		const size_t remaining = static_cast<size_t>(mEnd - mCursor);
+		if (remaining < sizeof(FCaptureChunkHeader))
+		{
+			mTruncated = remaining > 0;
+			return false;
+		}
+
+		const FCaptureChunkHeader* chunk = reinterpret_cast<const FCaptureChunkHeader*>(mCursor);
+		if (((chunk->Size % 8) != 0) || (chunk->Size > (remaining - sizeof(FCaptureChunkHeader))))
+		{
+			mTruncated = true;
+			return false;
+		}
+
+		mChunk = chunk;
+		mCursor += sizeof(FCaptureChunkHeader) + chunk->Size;
+		return true;
+	}
+
+	bool FHullCaptureReader::ReadBody(uint32_t& outId, std::string& outName) const
+	{
+		const FCaptureBlobHeader* blob = reinterpret_cast<const FCaptureBlobHeader*>(mChunk + 1);
+		if ((mChunk->Type != ECaptureChunk::Body) || (mChunk->Size < sizeof(FCaptureBlobHeader)) || (blob->NumBytes > (mChunk->Size - sizeof(FCaptureBlobHeader))))
+		{
+			return false;
+		}
+
+		outId = blob->Id;
+		outName.assign(reinterpret_cast<const char*>(blob + 1), blob->NumBytes);
+		return true;
+	}
+
+	bool FHullCaptureReader::ReadHull(uint32_t& outId, FHullData& outHull) const
+	{
+		const FCaptureBlobHeader* blob = reinterpret_cast<const FCaptureBlobHeader*>(mChunk + 1);
+		if ((mChunk->Type != ECaptureChunk::Hull) || (mChunk->Size < sizeof(FCaptureBlobHeader)) || (blob->NumBytes > (mChunk->Size - sizeof(FCaptureBlobHeader))))
+		{
+			return false;
+		}
+
+		outId = blob->Id;
+		return DeserializeHullData(reinterpret_cast<const uint8_t*>(blob + 1), blob->NumBytes, outHull);
+	}
+
+	bool FHullCaptureReader::ReadStep(const FCaptureStep*& outStep, const float*& outWaterHeights) const
+	{
+		const FCaptureStep* step = reinterpret_cast<const FCaptureStep*>(mChunk + 1);
+		if ((mChunk->Type != ECaptureChunk::Step) || (mChunk->Size < sizeof(FCaptureStep)) || (step->NumVertices < 0)
+			|| ((static_cast<size_t>(step->NumVertices) * sizeof(float)) > (mChunk->Size - sizeof(FCaptureStep))))
+		{
+			return false;
+		}
+
+		outStep = step;
+		outWaterHeights = reinterpret_cast<const float*>(step + 1);
+		return true;
+	}
+
+	bool FHullCaptureReader::ReadHistory(const FCaptureHistory*& outHistory, const float*& outArrays) const
+	{
+		const FCaptureHistory* history = reinterpret_cast<const FCaptureHistory*>(mChunk + 1);
+		if ((mChunk->Type != ECaptureChunk::History) || (mChunk->Size < sizeof(FCaptureHistory)) || (history->NumTriangles < 0)
+			|| ((static_cast<size_t>(history->NumTriangles) * 4 * sizeof(float)) > (mChunk->Size - sizeof(FCaptureHistory))))
+		{
+			return false;
+		}
+
+		outHistory = history;
+		outArrays = reinterpret_cast<const float*>(history + 1);
+		return true;
+	}
+}
@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullData.h"
+#include "HullForceKernel.h"
+#include "VertexTransform.h"
+
+#include <cstdio>
+#include <string>
+
+namespace HullKernel
+{
+	/**
+	 * Recording of the hull kernel's inputs and outputs, so a session can be replayed headless and compared against.
+	 *
+	 * File layout, native endianness: FCaptureHeader, then chunks of an FCaptureChunkHeader and Size bytes of payload.
+	 * Every chunk starts 8 byte aligned, so a memory mapped file can be read in place.
+	 *   Body  uint32 id, uint32 name length, name bytes.
+	 *   Hull  uint32 id, uint32 byte count, SerializeHullData bytes.
+	 *   Step     FCaptureStep, then NumVertices water heights.
+	 *   History  FCaptureHistory, then the submerged areas and X, Y and Z velocities of NumTriangles triangles.
+	 * Bodies and hulls come before the first step that uses them. Unknown chunk types are skipped.
+	 */
+	enum class ECaptureChunk : uint32_t
+	{
+		Body = 1,
+		Hull = 2,
+		Step = 3,
+		History = 4
+	};
+
+	struct FCaptureHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+
+		// EKernelPath the steps were computed with.
+		uint32_t Path;
+
+		// Keeps the first chunk 8 byte aligned.
+		uint32_t Padding;
+	};
+
+	struct FCaptureChunkHeader
+	{
+		ECaptureChunk Type;
+		uint32_t Size;
+	};
+
+	// One evaluation of one body.
+	struct FCaptureStep
+	{
+		double Time;
+		uint32_t Body;
+		uint32_t Hull;
+
+		// Mesh to world transform the local hull vertices were taken to the water with.
+		FAffineTransform Transform;
+		FBodyState BodyState;
+
+		// Force model of the body's hull.
+		FForceCoefficients Coefficients;
+
+		int32_t NumVertices;
+
+		// CaptureStep flags.
+		uint32_t Flags;
+
+		// What the kernel returned.
+		FKernelSummary Summary;
+	};
+
+	// Computed in HullChunkTriangles chunks summed in order, like the scheduler does, rather than in one call.
+	static const uint32_t CaptureStepChunked = 1 << 0;
+
+	// First step of a body in the capture. The triangle history it started from is unknown, so it cannot be replayed,
+	// a History chunk with the history it left follows it instead.
+	static const uint32_t CaptureStepSeed = 1 << 1;
+
+	// Triangle history of a body after its latest step.
+	struct FCaptureHistory
+	{
+		uint32_t Body;
+		int32_t NumTriangles;
+	};
+
+	/**
+	 * Streams a capture to disk through a buffered file. Not thread safe, the caller serializes the writes.
+	 */
+	class FHullCaptureWriter
+	{
+	public:
+		FHullCaptureWriter();
+		~FHullCaptureWriter();
+
+		// Path is the one the recorded steps are computed with.
+		bool Open(const char* fileName, EKernelPath path);
+
+		// Returns false if anything since Open failed to write.
+		bool Close();
+
+		bool IsOpen() const { return mFile != nullptr; }
+
+		void WriteBody(uint32_t id, const char* name);
+		void WriteHull(uint32_t id, const FHullData& hull);
+
+		// waterHeights holds step.NumVertices heights.
+		void WriteStep(const FCaptureStep& step, const float* waterHeights);
+
+		// The history arrays of forces.
+		void WriteHistory(uint32_t body, const FTriangleForces& forces, int32_t numTriangles);
+
+		uint64_t BytesWritten() const { return mBytesWritten; }
+
+	private:
+		struct FSegment
+		{
+			const void* Data;
+			uint32_t Size;
+		};
+
+		void WriteChunk(ECaptureChunk type, const FSegment* segments, int32_t numSegments);
+
+		FILE* mFile;
+		uint64_t mBytesWritten;
+		bool mFailed;
+
+		std::vector<uint8_t> mScratch;
+	};
+
+	/**
+	 * Walks the chunks of a capture held in memory, e.g. a memory mapped file. Nothing is copied, the steps and
+	 * their water heights point into the bytes, which have to stay valid and 8 byte aligned.
+	 */
+	class FHullCaptureReader
+	{
+	public:
+		FHullCaptureReader();
+
+		// Returns false if the bytes do not start with a capture of the current version.
+		bool Open(const uint8_t* bytes, size_t numBytes);
+
+		const FCaptureHeader& Header() const { return *mHeader; }
+
+		// Moves to the next chunk, false at the end of the capture or at a truncated chunk.
+		bool Next();
+
+		ECaptureChunk Type() const { return mChunk->Type; }
+
+		// Each returns false if the current chunk is not of its type or is malformed.
+		bool ReadBody(uint32_t& outId, std::string& outName) const;
+		bool ReadHull(uint32_t& outId, FHullData& outHull) const;
+		bool ReadStep(const FCaptureStep*& outStep, const float*& outWaterHeights) const;
+
+		// outArrays points to the submerged areas, the X, Y and Z velocities follow NumTriangles apart.
+		bool ReadHistory(const FCaptureHistory*& outHistory, const float*& outArrays) const;
+
+		// True when the last Next stopped at a chunk running past the end, e.g. a capture cut short by a crash.
+		bool IsTruncated() const { return mTruncated; }
+
+	private:
+		const FCaptureHeader* mHeader;
+		const FCaptureChunkHeader* mChunk;
+		const uint8_t* mCursor;
+		const uint8_t* mEnd;
+		bool mTruncated;
+	};
+}
@@ -0,0 +1,229 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HullData.h"
+#include "HullBVH.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace HullKernel
+{
+	static const uint32_t HullDataMagic = 0x4C4C5548; // "HULL"
+	// Version 2: files cooked before 32 bit index and compound hull support may hold corrupted indices.
+	// Version 3: triangles in cluster order, with the hierarchy over them.
+	// Version 4: simplified LODs stretched vertically about the keel instead of the centre of the bounds.
+	static const uint32_t HullDataVersion = 4;
+
+	FHullData::FHullData() :
+		SurfaceArea(0.0f), LengthOfBoat(0.0f)
+	{
+	}
+
+	void FinalizeHullData(FHullData& hull)
+	{
+		// Same estimate the component always used: distance between the first and the last vertex of the index buffer,
+		// taken before the triangles are reordered.
+		hull.LengthOfBoat = 0.0f;
+		if (!hull.Indices.empty())
+		{
+			const int32_t first = hull.Indices.front();
+			const int32_t last = hull.Indices.back();
+			const float deltaX = hull.X[first] - hull.X[last];
+			const float deltaY = hull.Y[first] - hull.Y[last];
+			const float deltaZ = hull.Z[first] - hull.Z[last];
+			hull.LengthOfBoat = std::sqrt((deltaX * deltaX) + (deltaY * deltaY) + (deltaZ * deltaZ));
+		}
+
+		BuildHullBVH(hull);
+
+		const int32_t numTriangles = hull.NumTriangles();
+		hull.Areas.resize(numTriangles);
+		hull.NormalX.resize(numTriangles);
+		hull.NormalY.resize(numTriangles);
+		hull.NormalZ.resize(numTriangles);
+		hull.SurfaceArea = 0.0f;
+
+		for (int32_t tri = 0; tri < numTriangles; ++tri)
+		{
+			const int32_t index1 = hull.Indices[(tri * 3) + 0];
+			const int32_t index2 = hull.Indices[(tri * 3) + 1];
+			const int32_t index3 = hull.Indices[(tri * 3) + 2];
+
+			const float edge1X = hull.X[index1] - hull.X[index2];
+			const float edge1Y = hull.Y[index1] - hull.Y[index2];
+			const float edge1Z = hull.Z[index1] - hull.Z[index2];
+			const float edge2X = hull.X[index2] - hull.X[index3];
+			const float edge2Y = hull.Y[index2] - hull.Y[index3];
+			const float edge2Z = hull.Z[index2] - hull.Z[index3];
+
+			const float crossX = (edge1Y * edge2Z) - (edge1Z * edge2Y);
+			const float crossY = (edge1Z * edge2X) - (edge1X * edge2Z);
+			const float crossZ = (edge1X * edge2Y) - (edge1Y * edge2X);
+			const float crossLength = std::sqrt((crossX * crossX) + (crossY * crossY) + (crossZ * crossZ));
+
+			// area = 1/2 * |edge1 ^ edge2|, converted from cm2 to m2
+			hull.Areas[tri] = 0.5f * crossLength * 1e-4f;
+			hull.SurfaceArea += hull.Areas[tri];
+
+			const float inverseLength = (crossLength > 0.0f) ? (1.0f / crossLength) : 0.0f;
+			hull.NormalX[tri] = crossX * inverseLength;
+			hull.NormalY[tri] = crossY * inverseLength;
+			hull.NormalZ[tri] = crossZ * inverseLength;
+		}
+	}
+
+	float ScaledSurfaceArea(const FHullData& hull, const float scale[3])
+	{
+		double area = 0.0;
+		for (int32_t tri = 0; tri < hull.NumTriangles(); ++tri)
+		{
+			const int32_t index1 = hull.Indices[(tri * 3) + 0];
+			const int32_t index2 = hull.Indices[(tri * 3) + 1];
+			const int32_t index3 = hull.Indices[(tri * 3) + 2];
+
+			const float edge1X = (hull.X[index1] - hull.X[index2]) * scale[0];
+			const float edge1Y = (hull.Y[index1] - hull.Y[index2]) * scale[1];
+			const float edge1Z = (hull.Z[index1] - hull.Z[index2]) * scale[2];
+			const float edge2X = (hull.X[index2] - hull.X[index3]) * scale[0];
+			const float edge2Y = (hull.Y[index2] - hull.Y[index3]) * scale[1];
+			const float edge2Z = (hull.Z[index2] - hull.Z[index3]) * scale[2];
+
+			const float crossX = (edge1Y * edge2Z) - (edge1Z * edge2Y);
+			const float crossY = (edge1Z * edge2X) - (edge1X * edge2Z);
+			const float crossZ = (edge1X * edge2Y) - (edge1Y * edge2X);
+			area += 0.5 * std::sqrt((crossX * crossX) + (crossY * crossY) + (crossZ * crossZ)) * 1e-4;
+		}
+		return static_cast<float>(area);
+	}
+
+	template <typename T>
+	static void WriteValue(std::vector<uint8_t>& bytes, const T& value)
+	{
+		const uint8_t* source = reinterpret_cast<const uint8_t*>(&value);
+		bytes.insert(bytes.end(), source, source + sizeof(T));
+	}
+
+	template <typename T>
+	static void WriteArray(std::vector<uint8_t>& bytes, const std::vector<T>& values)
+	{
+		if (!values.empty())
+		{
+			const uint8_t* source = reinterpret_cast<const uint8_t*>(values.data());
+			bytes.insert(bytes.end(), source, source + (values.size() * sizeof(T)));
+		}
+	}
+
+	template <typename T>
+	static bool ReadValue(const uint8_t*& cursor, const uint8_t* end, T& outValue)
+	{
+		if (static_cast<size_t>(end - cursor) < sizeof(T))
+		{
+			return false;
+		}
+		std::memcpy(&outValue, cursor, sizeof(T));
+		cursor += sizeof(T);
+		return true;
+	}
+
+	template <typename T>
+	static bool ReadArray(const uint8_t*& cursor, const uint8_t* end, size_t count, std::vector<T>& outValues)
+	{
+		if ((static_cast<size_t>(end - cursor) / sizeof(T)) < count)
+		{
+			return false;
+		}
+		outValues.resize(count);
+		if (count > 0)
+		{
+			std::memcpy(outValues.data(), cursor, count * sizeof(T));
+		}
+		cursor += count * sizeof(T);
+		return true;
+	}
+
+	void SerializeHullData(const FHullData& hull, std::vector<uint8_t>& outBytes)
+	{
+		const uint32_t numVertices = static_cast<uint32_t>(hull.NumVertices());
+		const uint32_t numTriangles = static_cast<uint32_t>(hull.NumTriangles());
+		const uint32_t numNodes = static_cast<uint32_t>(hull.Nodes.size());
+		const uint32_t numNodeVertices = static_cast<uint32_t>(hull.NodeVertices.size());
+
+		outBytes.clear();
+		outBytes.reserve((6 * sizeof(uint32_t)) + (2 * sizeof(float)) + (numVertices * 3 * sizeof(float)) + (numTriangles * 3 * sizeof(int32_t)) + (numTriangles * 4 * sizeof(float))
+			+ (numNodes * sizeof(FHullNode)) + (numNodeVertices * sizeof(int32_t)));
+
+		WriteValue(outBytes, HullDataMagic);
+		WriteValue(outBytes, HullDataVersion);
+		WriteValue(outBytes, numVertices);
+		WriteValue(outBytes, numTriangles);
+		WriteValue(outBytes, numNodes);
+		WriteValue(outBytes, numNodeVertices);
+		WriteValue(outBytes, hull.SurfaceArea);
+		WriteValue(outBytes, hull.LengthOfBoat);
+
+		WriteArray(outBytes, hull.X);
+		WriteArray(outBytes, hull.Y);
+		WriteArray(outBytes, hull.Z);
+		WriteArray(outBytes, hull.Indices);
+		WriteArray(outBytes, hull.Areas);
+		WriteArray(outBytes, hull.NormalX);
+		WriteArray(outBytes, hull.NormalY);
+		WriteArray(outBytes, hull.NormalZ);
+		WriteArray(outBytes, hull.Nodes);
+		WriteArray(outBytes, hull.NodeVertices);
+	}
+
+	bool DeserializeHullData(const uint8_t* bytes, size_t numBytes, FHullData& outHull)
+	{
+		const uint8_t* cursor = bytes;
+		const uint8_t* end = bytes + numBytes;
+
+		uint32_t magic = 0;
+		uint32_t version = 0;
+		uint32_t numVertices = 0;
+		uint32_t numTriangles = 0;
+		uint32_t numNodes = 0;
+		uint32_t numNodeVertices = 0;
+		if (!ReadValue(cursor, end, magic) || !ReadValue(cursor, end, version) || (magic != HullDataMagic) || (version != HullDataVersion))
+		{
+			return false;
+		}
+
+		bool bRead = ReadValue(cursor, end, numVertices) && ReadValue(cursor, end, numTriangles)
+			&& ReadValue(cursor, end, numNodes) && ReadValue(cursor, end, numNodeVertices)
+			&& ReadValue(cursor, end, outHull.SurfaceArea) && ReadValue(cursor, end, outHull.LengthOfBoat)
+			&& ReadArray(cursor, end, numVertices, outHull.X)
+			&& ReadArray(cursor, end, numVertices, outHull.Y)
+			&& ReadArray(cursor, end, numVertices, outHull.Z)
+			&& ReadArray(cursor, end, static_cast<size_t>(numTriangles) * 3, outHull.Indices)
+			&& ReadArray(cursor, end, numTriangles, outHull.Areas)
+			&& ReadArray(cursor, end, numTriangles, outHull.NormalX)
+			&& ReadArray(cursor, end, numTriangles, outHull.NormalY)
+			&& ReadArray(cursor, end, numTriangles, outHull.NormalZ)
+			&& ReadArray(cursor, end, numNodes, outHull.Nodes)
+			&& ReadArray(cursor, end, numNodeVertices, outHull.NodeVertices);
+
+		// Reject indices pointing outside of the vertex buffer rather than crashing in the kernel later.
+		for (size_t i = 0; bRead && (i < outHull.Indices.size()); ++i)
+		{
+			bRead = (outHull.Indices[i] >= 0) && (static_cast<uint32_t>(outHull.Indices[i]) < numVertices);
+		}
+		for (size_t i = 0; bRead && (i < outHull.NodeVertices.size()); ++i)
+		{
+			bRead = (outHull.NodeVertices[i] >= 0) && (static_cast<uint32_t>(outHull.NodeVertices[i]) < numVertices);
+		}
+
+		// Same for nodes outside of the triangles, and children that would not lead down the tree.
+		bRead = bRead && ((numNodes > 0) == (numTriangles > 0));
+		for (uint32_t i = 0; bRead && (i < numNodes); ++i)
+		{
+			const FHullNode& node = outHull.Nodes[i];
+			const bool bLeaf = node.Second == 0;
+			bRead = (node.Begin >= 0) && (node.Begin < node.End) && (static_cast<uint32_t>(node.End) <= numTriangles)
+				&& (bLeaf || ((static_cast<uint32_t>(node.Second) > (i + 1)) && (static_cast<uint32_t>(node.Second) < numNodes)))
+				&& (node.VertexBegin >= 0) && (node.VertexBegin <= node.VertexEnd) && (static_cast<uint32_t>(node.VertexEnd) <= numNodeVertices);
+		}
+
+		return bRead && (cursor == end);
+	}
+}
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernelTypes.h"
+
+#include <vector>
+
+namespace HullKernel
+{
+	/**
+	 * Topology and local space data of a hull, built once per mesh and shared by every body using it.
+	 * Positions are in cm in the space of the mesh, areas in m2.
+	 */
+	struct FHullData
+	{
+		std::vector<float> X;
+		std::vector<float> Y;
+		std::vector<float> Z;
+
+		// Three vertex indices per triangle, in the cluster order of the hierarchy.
+		std::vector<int32_t> Indices;
+
+		std::vector<float> Areas;
+		std::vector<float> NormalX;
+		std::vector<float> NormalY;
+		std::vector<float> NormalZ;
+
+		// Bounding volume hierarchy over the triangles, see BuildHullBVH.
+		std::vector<FHullNode> Nodes;
+		std::vector<int32_t> NodeVertices;
+
+		float SurfaceArea;
+		float LengthOfBoat;
+
+		FHullData();
+
+		int32_t NumVertices() const { return static_cast<int32_t>(X.size()); }
+		int32_t NumTriangles() const { return static_cast<int32_t>(Indices.size() / 3); }
+	};
+
+	// Computes areas, normals, surface area and length from the vertices and indices, and reorders the triangles into
+	// the clusters of the hierarchy.
+	void FinalizeHullData(FHullData& hull);
+
+	// Surface area (m2) of the hull with its mesh space scaled by scale along X, Y and Z. Exact for non uniform scales.
+	float ScaledSurfaceArea(const FHullData& hull, const float scale[3]);
+
+	// Cooked binary form of the hull, so that it does not need to be rebuilt from the physics mesh on every load.
+	void SerializeHullData(const FHullData& hull, std::vector<uint8_t>& outBytes);
+
+	// Returns false if the bytes are not a cooked hull of the current version.
+	bool DeserializeHullData(const uint8_t* bytes, size_t numBytes, FHullData& outHull);
+}
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HullForceBatch.h"
+
+#include <algorithm>
+
+namespace HullKernel
+{
+	int32_t CountHullChunks(const FHullJob* jobs, int32_t numJobs)
+	{
+		int32_t numChunks = 0;
+		for (int32_t job = 0; job < numJobs; ++job)
+		{
+			numChunks += (jobs[job].Hull.NumTriangles + HullChunkTriangles - 1) / HullChunkTriangles;
+		}
+		return numChunks;
+	}
+
+	void BuildHullChunks(const FHullJob* jobs, int32_t numJobs, FHullChunk* outChunks)
+	{
+		int32_t chunk = 0;
+		for (int32_t job = 0; job < numJobs; ++job)
+		{
+			const int32_t numTriangles = jobs[job].Hull.NumTriangles;
+			for (int32_t begin = 0; begin < numTriangles; begin += HullChunkTriangles)
+			{
+				outChunks[chunk].Job = job;
+				outChunks[chunk].Begin = begin;
+				outChunks[chunk].End = std::min(begin + HullChunkTriangles, numTriangles);
+				++chunk;
+			}
+		}
+	}
+
+	void ComputeHullChunk(const FHullJob* jobs, const FHullChunk& chunk, FKernelSummary& outSummary)
+	{
+		const FHullJob& job = jobs[chunk.Job];
+
+		outSummary = FKernelSummary();
+		ComputeHullForcesRange(job.Hull, job.WaterHeights, job.Body, job.Coefficients, job.Out, chunk.Begin, chunk.End, outSummary);
+	}
+
+	void ReduceHullChunks(const FHullChunk* chunks, const FKernelSummary* chunkSummaries, int32_t numChunks, FKernelSummary* outJobSummaries, int32_t numJobs)
+	{
+		std::fill(outJobSummaries, outJobSummaries + numJobs, FKernelSummary());
+		for (int32_t chunk = 0; chunk < numChunks; ++chunk)
+		{
+			AccumulateSummary(outJobSummaries[chunks[chunk].Job], chunkSummaries[chunk]);
+		}
+	}
+}
@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullForceKernel.h"
+
+namespace HullKernel
+{
+	// Triangles per unit of work. A multiple of every SIMD width, so chunking never changes which triangles share a register.
+	static const int32_t HullChunkTriangles = 512;
+
+	// Everything the kernel needs for one body this tick.
+	struct FHullJob
+	{
+		FHullView Hull;
+		const float* WaterHeights;
+		FBodyState Body;
+
+		// Force model of the hull, jobs of different hull types run side by side.
+		FForceCoefficients Coefficients;
+
+		FTriangleForces Out;
+	};
+
+	struct FHullChunk
+	{
+		int32_t Job;
+		int32_t Begin;
+		int32_t End;
+	};
+
+	int32_t CountHullChunks(const FHullJob* jobs, int32_t numJobs);
+
+	// Splits every hull into chunks of HullChunkTriangles, job after job. outChunks holds CountHullChunks elements.
+	// The split only depends on the hulls, never on the number of threads.
+	void BuildHullChunks(const FHullJob* jobs, int32_t numJobs, FHullChunk* outChunks);
+
+	// Computes one chunk into its own summary. Any number of chunks, of the same body or not, can run at once.
+	void ComputeHullChunk(const FHullJob* jobs, const FHullChunk& chunk, FKernelSummary& outSummary);
+
+	// Sums the chunk summaries of every job in chunk order, so the result is the same whichever thread ran which chunk.
+	void ReduceHullChunks(const FHullChunk* chunks, const FKernelSummary* chunkSummaries, int32_t numChunks, FKernelSummary* outJobSummaries, int32_t numJobs);
+}
@@ -0,0 +1,265 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HullForceKernel.h"
+#include "HullBVH.h"
+
+#include <cstring>
+
+#if HULLKERNEL_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace HullKernel
+{
+	static bool CpuSupportsAVX2()
+	{
+#if !HULLKERNEL_X86
+		return false;
+#elif defined(_MSC_VER)
+		int32_t info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+		{
+			return false;
+		}
+
+		// The OS has to save the YMM registers on context switches as well.
+		__cpuid(info, 1);
+		const bool bOSXSave = (info[2] & (1 << 27)) != 0;
+		if (!bOSXSave || ((_xgetbv(0) & 0x6) != 0x6))
+		{
+			return false;
+		}
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") != 0;
+#endif
+	}
+
+	EKernelPath DetectKernelPath()
+	{
+		static const EKernelPath BestPath = CpuSupportsAVX2() ? EKernelPath::AVX2 : (HULLKERNEL_X86 ? EKernelPath::SSE : EKernelPath::Scalar);
+		return BestPath;
+	}
+
+	EFalloffPower ClassifyFalloffPower(float exponent)
+	{
+		if (exponent == 0.5f)
+		{
+			return EFalloffPower::SquareRoot;
+		}
+		if (exponent == 1.0f)
+		{
+			return EFalloffPower::Linear;
+		}
+		if (exponent == 2.0f)
+		{
+			return EFalloffPower::Square;
+		}
+		return EFalloffPower::General;
+	}
+
+	const char* KernelPathName(EKernelPath path)
+	{
+		switch (path)
+		{
+		case EKernelPath::Auto:
+			return "Auto";
+		case EKernelPath::Scalar:
+			return "Scalar";
+		case EKernelPath::SSE:
+			return "SSE";
+		case EKernelPath::AVX2:
+			return "AVX2";
+		}
+		return "Unknown";
+	}
+
+	FKernelSummary ComputeHullForces(const FHullView& hull, const float* waterHeights, const FBodyState& body,
+		const FForceCoefficients& coefficients, const FTriangleForces& out, EKernelPath path)
+	{
+		FKernelSummary summary = {};
+		ComputeHullForcesRange(hull, waterHeights, body, coefficients, out, 0, hull.NumTriangles, summary, path);
+		return summary;
+	}
+
+	static void ComputePathRange(EKernelPath path, const FHullView& hull, const float* waterHeights, const FBodyState& body,
+		const FForceCoefficients& coefficients, const FTriangleForces& out, int32_t begin, int32_t end, FKernelSummary& summary, bool bSubmerged)
+	{
+		switch (path)
+		{
+#if HULLKERNEL_X86
+		case EKernelPath::AVX2:
+			AVX2::ComputeRange(hull, waterHeights, body, coefficients, out, begin, end, summary, bSubmerged);
+			break;
+		case EKernelPath::SSE:
+			SSE::ComputeRange(hull, waterHeights, body, coefficients, out, begin, end, summary, bSubmerged);
+			break;
+#endif
+		default:
+			Scalar::ComputeRange(hull, waterHeights, body, coefficients, out, begin, end, summary, bSubmerged);
+			break;
+		}
+	}
+
+	// Output of triangles entirely above the water, what the kernel stores for them without computing anything.
+	// Their centroids are left as they are, they are only meaningful where a force is applied.
+	static void StoreDryRange(const FForceCoefficients& coefficients, const FTriangleForces& out, int32_t begin, int32_t end, FKernelSummary& summary)
+	{
+		const size_t count = static_cast<size_t>(end - begin);
+		const size_t bytes = count * sizeof(float);
+
+		std::memset(out.Submersion + begin, 0, count);
+		std::memset(out.Applied + begin, 0, count);
+		std::memset(out.ForceX + begin, 0, bytes);
+		std::memset(out.ForceY + begin, 0, bytes);
+		std::memset(out.ForceZ + begin, 0, bytes);
+
+		float* const terms[] =
+		{
+			out.HydrostaticX, out.HydrostaticY, out.HydrostaticZ,
+			out.ViscousX, out.ViscousY, out.ViscousZ,
+			out.PressureDragX, out.PressureDragY, out.PressureDragZ,
+			out.SlammingX, out.SlammingY, out.SlammingZ
+		};
+		for (float* term : terms)
+		{
+			if (term)
+			{
+				std::memset(term + begin, 0, bytes);
+			}
+		}
+
+		// A dry triangle has no submerged area to slam with next time. Its velocity only matters together with an area.
+		if (((coefficients.Terms & ForceTermSlamming) != 0) && out.SubmergedAreaHistory)
+		{
+			std::memset(out.SubmergedAreaHistory + begin, 0, bytes);
+		}
+
+		summary.SubmersionCounts[0] += static_cast<int32_t>(count);
+	}
+
+	namespace
+	{
+		// Walks the hierarchy over a range of triangles and hands consecutive triangles of the same contact to the kernel
+		// in one call.
+		class FHullNodeWalker
+		{
+		public:
+			FHullNodeWalker(EKernelPath path, const FHullView& hull, const float* waterHeights, const FBodyState& body,
+				const FForceCoefficients& coefficients, const FTriangleForces& out, FKernelSummary& summary) :
+				mPath(path), mHull(hull), mWaterHeights(waterHeights), mBody(body), mCoefficients(coefficients), mOut(out), mSummary(summary),
+				mRunBegin(0), mRunEnd(0), mRunContact(EWaterContact::Waterline)
+			{
+			}
+
+			void Walk(int32_t index, int32_t begin, int32_t end)
+			{
+				const FHullNode& node = mHull.Nodes[index];
+				const int32_t overlapBegin = (node.Begin > begin) ? node.Begin : begin;
+				const int32_t overlapEnd = (node.End < end) ? node.End : end;
+				if (overlapBegin >= overlapEnd)
+				{
+					return;
+				}
+
+				EWaterContact contact = ClassifyHullNodeBounds(mHull, node);
+				if (contact == EWaterContact::Waterline)
+				{
+					if (node.Second != 0)
+					{
+						Walk(index + 1, begin, end);
+						Walk(node.Second, begin, end);
+						return;
+					}
+					contact = ClassifyHullLeaf(mHull, mWaterHeights, node);
+				}
+				Add(overlapBegin, overlapEnd, contact);
+			}
+
+			void Flush()
+			{
+				if (mRunBegin == mRunEnd)
+				{
+					return;
+				}
+
+				if (mRunContact == EWaterContact::Dry)
+				{
+					StoreDryRange(mCoefficients, mOut, mRunBegin, mRunEnd, mSummary);
+				}
+				else
+				{
+					ComputePathRange(mPath, mHull, mWaterHeights, mBody, mCoefficients, mOut, mRunBegin, mRunEnd, mSummary,
+						mRunContact == EWaterContact::Submerged);
+				}
+				mRunBegin = mRunEnd;
+			}
+
+		private:
+			void Add(int32_t begin, int32_t end, EWaterContact contact)
+			{
+				if ((contact != mRunContact) || (begin != mRunEnd))
+				{
+					Flush();
+					mRunBegin = begin;
+					mRunContact = contact;
+				}
+				mRunEnd = end;
+			}
+
+			EKernelPath mPath;
+			const FHullView& mHull;
+			const float* mWaterHeights;
+			const FBodyState& mBody;
+			const FForceCoefficients& mCoefficients;
+			const FTriangleForces& mOut;
+			FKernelSummary& mSummary;
+
+			int32_t mRunBegin;
+			int32_t mRunEnd;
+			EWaterContact mRunContact;
+		};
+	}
+
+	void ComputeHullForcesRange(const FHullView& hull, const float* waterHeights, const FBodyState& body,
+		const FForceCoefficients& coefficients, const FTriangleForces& out, int32_t begin, int32_t end, FKernelSummary& summary,
+		EKernelPath path)
+	{
+		// Never run a wider path than the CPU supports.
+		const EKernelPath bestPath = DetectKernelPath();
+		if ((path == EKernelPath::Auto) || (static_cast<uint8_t>(path) > static_cast<uint8_t>(bestPath)))
+		{
+			path = bestPath;
+		}
+
+		if (!hull.Nodes)
+		{
+			ComputePathRange(path, hull, waterHeights, body, coefficients, out, begin, end, summary, false);
+			return;
+		}
+
+		FHullNodeWalker walker(path, hull, waterHeights, body, coefficients, out, summary);
+		walker.Walk(0, begin, end);
+		walker.Flush();
+	}
+
+	void AccumulateSummary(FKernelSummary& summary, const FKernelSummary& part)
+	{
+		for (int32_t axis = 0; axis < 3; ++axis)
+		{
+			summary.Wrench.Force[axis] += part.Wrench.Force[axis];
+			summary.Wrench.Torque[axis] += part.Wrench.Torque[axis];
+		}
+
+		summary.SubmergedArea += part.SubmergedArea;
+		for (int32_t submersion = 0; submersion < 4; ++submersion)
+		{
+			summary.SubmersionCounts[submersion] += part.SubmersionCounts[submersion];
+		}
+		summary.AppliedCount += part.AppliedCount;
+	}
+}
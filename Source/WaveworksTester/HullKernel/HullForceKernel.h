@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernelTypes.h"
+
+namespace HullKernel
+{
+	/**
+	 * Classifies every triangle of the hull against the water heights and computes, for the submerged part of the
+	 * downward facing ones, the hydrostatic force and whichever of the viscous, pressure drag and slamming forces
+	 * coefficients.Terms enables.
+	 * Partially submerged triangles are cut at the waterline, interpolated along their edges, and only the part
+	 * below it is integrated.
+	 * WaterHeights holds one absolute water height (cm) per hull vertex.
+	 * Several triangles are processed per instruction with SSE or AVX2 when the CPU supports it.
+	 * With the hierarchy of the hull bound to the view, clusters entirely above the water are skipped and clusters
+	 * entirely below it are integrated without cutting, only those on the waterline are classified per triangle.
+	 */
+	FKernelSummary ComputeHullForces(const FHullView& hull, const float* waterHeights, const FBodyState& body,
+		const FForceCoefficients& coefficients, const FTriangleForces& out, EKernelPath path = EKernelPath::Auto);
+
+	// Same for the triangles in [begin, end) only, added into summary. Begin should be a multiple of 8 so that the
+	// triangles share SIMD registers exactly like in a whole hull call.
+	void ComputeHullForcesRange(const FHullView& hull, const float* waterHeights, const FBodyState& body,
+		const FForceCoefficients& coefficients, const FTriangleForces& out, int32_t begin, int32_t end, FKernelSummary& summary,
+		EKernelPath path = EKernelPath::Auto);
+
+	// Adds the forces, areas and counts of part into summary.
+	void AccumulateSummary(FKernelSummary& summary, const FKernelSummary& part);
+
+	// Fast path of a falloff exponent, the kernel specializes on the pressure and suction falloffs when they share one.
+	EFalloffPower ClassifyFalloffPower(float exponent);
+
+	// Best path the running CPU supports.
+	EKernelPath DetectKernelPath();
+
+	const char* KernelPathName(EKernelPath path);
+
+	// Per instruction set entry points. Each processes the triangles in [begin, end) and adds into summary.
+	// bSubmerged promises every vertex of the range is below the water, which skips cutting the triangles.
+	namespace Scalar
+	{
+		void ComputeRange(const FHullView& hull, const float* waterHeights, const FBodyState& body,
+			const FForceCoefficients& coefficients, const FTriangleForces& out, int32_t begin, int32_t end, FKernelSummary& summary, bool bSubmerged);
+	}
+
+#if HULLKERNEL_X86
+	namespace SSE
+	{
+		static const int32_t Width = 4;
+
+		void ComputeRange(const FHullView& hull, const float* waterHeights, const FBodyState& body,
+			const FForceCoefficients& coefficients, const FTriangleForces& out, int32_t begin, int32_t end, FKernelSummary& summary, bool bSubmerged);
+	}
+
+	namespace AVX2
+	{
+		static const int32_t Width = 8;
+
+		void ComputeRange(const FHullView& hull, const float* waterHeights, const FBodyState& body,
+			const FForceCoefficients& coefficients, const FTriangleForces& out, int32_t begin, int32_t end, FKernelSummary& summary, bool bSubmerged);
+	}
+#endif
+}
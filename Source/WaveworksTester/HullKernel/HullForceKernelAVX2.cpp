@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HullForceKernel.h"
+
+#if HULLKERNEL_X86
+
+#include <cmath>
+#include <immintrin.h>
+
+// Only this translation unit is compiled for AVX2, the dispatcher checks the CPU before calling into it.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace HullKernel
+{
+	namespace AVX2
+	{
+		struct FPack
+		{
+			static const int32_t Width = 8;
+			__m256 V;
+		};
+
+		struct FMask
+		{
+			__m256 V;
+		};
+
+		struct FIndex
+		{
+			__m256i V;
+		};
+
+		static HULLKERNEL_FORCEINLINE FPack Pack(__m256 value) { FPack result = { value }; return result; }
+		static HULLKERNEL_FORCEINLINE FMask Mask(__m256 value) { FMask result = { value }; return result; }
+
+		static HULLKERNEL_FORCEINLINE FPack Set(float value) { return Pack(_mm256_set1_ps(value)); }
+		static HULLKERNEL_FORCEINLINE FPack Load(const float* source) { return Pack(_mm256_loadu_ps(source)); }
+		static HULLKERNEL_FORCEINLINE void Store(float* destination, const FPack& value) { _mm256_storeu_ps(destination, value.V); }
+
+		static HULLKERNEL_FORCEINLINE FIndex LoadCorner(const int32_t* indices, int32_t tri, int32_t corner)
+		{
+			const __m256i stride = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+			FIndex result = { _mm256_i32gather_epi32(reinterpret_cast<const int*>(indices + (tri * 3) + corner), stride, 4) };
+			return result;
+		}
+
+		static HULLKERNEL_FORCEINLINE FPack Gather(const float* base, const FIndex& index) { return Pack(_mm256_i32gather_ps(base, index.V, 4)); }
+
+		static HULLKERNEL_FORCEINLINE FPack operator+(const FPack& a, const FPack& b) { return Pack(_mm256_add_ps(a.V, b.V)); }
+		static HULLKERNEL_FORCEINLINE FPack operator-(const FPack& a, const FPack& b) { return Pack(_mm256_sub_ps(a.V, b.V)); }
+		static HULLKERNEL_FORCEINLINE FPack operator*(const FPack& a, const FPack& b) { return Pack(_mm256_mul_ps(a.V, b.V)); }
+		static HULLKERNEL_FORCEINLINE FPack operator/(const FPack& a, const FPack& b) { return Pack(_mm256_div_ps(a.V, b.V)); }
+		static HULLKERNEL_FORCEINLINE FPack Sqrt(const FPack& a) { return Pack(_mm256_sqrt_ps(a.V)); }
+
+		static HULLKERNEL_FORCEINLINE FMask Less(const FPack& a, const FPack& b) { return Mask(_mm256_cmp_ps(a.V, b.V, _CMP_LT_OQ)); }
+		static HULLKERNEL_FORCEINLINE FMask Greater(const FPack& a, const FPack& b) { return Mask(_mm256_cmp_ps(a.V, b.V, _CMP_GT_OQ)); }
+		static HULLKERNEL_FORCEINLINE FMask And(const FMask& a, const FMask& b) { return Mask(_mm256_and_ps(a.V, b.V)); }
+		static HULLKERNEL_FORCEINLINE FMask AndNot(const FMask& a, const FMask& b) { return Mask(_mm256_andnot_ps(b.V, a.V)); }
+		static HULLKERNEL_FORCEINLINE FPack Select(const FMask& mask, const FPack& a, const FPack& b) { return Pack(_mm256_blendv_ps(b.V, a.V, mask.V)); }
+		static HULLKERNEL_FORCEINLINE int32_t MaskBits(const FMask& mask) { return _mm256_movemask_ps(mask.V); }
+
+#include "HullForceKernelBody.inl"
+	}
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
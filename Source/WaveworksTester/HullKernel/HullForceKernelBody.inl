@@ -0,0 +1,701 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Instruction set independent body of the hull force kernel.
+// Included by each HullForceKernel*.cpp inside its own namespace after it has defined FPack, FMask and FIndex,
+// so there is deliberately no include guard.
+// Mirrors the formulae in BoatPhysicsUtil, one lane per triangle.
+// The loop is a template over the force model, ComputeRange picks the instance matching the coefficients, and over
+// whether the caller knows every triangle to be under the water.
+
+static const float KernelSmallNumber = 1.e-8f;
+
+// Position of a vertex and its height above the water surface.
+struct FVertexPack
+{
+	FPack X;
+	FPack Y;
+	FPack Z;
+	FPack H;
+};
+
+// Forces acting on the submerged part of a triangle and the point they act on.
+struct FSubTriangleForces
+{
+	FPack HydrostaticX;
+	FPack HydrostaticY;
+	FPack HydrostaticZ;
+	FPack ViscousX;
+	FPack ViscousY;
+	FPack ViscousZ;
+	FPack PressureDragX;
+	FPack PressureDragY;
+	FPack PressureDragZ;
+	FPack ForceX;
+	FPack ForceY;
+	FPack ForceZ;
+	FPack CentroidX;
+	FPack CentroidY;
+	FPack CentroidZ;
+};
+
+// Body state and coefficients broadcast once per call.
+struct FKernelConstants
+{
+	FPack Zero;
+	FPack One;
+	FPack Third;
+	FPack SmallNumber;
+
+	// Takes the length of an edge cross product (cm2) to the area (m2) of the triangle.
+	FPack CrossLengthToArea;
+
+	FPack LinearVelocityX;
+	FPack LinearVelocityY;
+	FPack LinearVelocityZ;
+	FPack AngularVelocityX;
+	FPack AngularVelocityY;
+	FPack AngularVelocityZ;
+	FPack CenterOfMassX;
+	FPack CenterOfMassY;
+	FPack CenterOfMassZ;
+
+	FPack HydrostaticScale;
+	FPack ViscousScale;
+	FPack PressureScale;
+	FPack SuctionScale;
+	FPack PressureFalloffPower;
+	FPack SuctionFalloffPower;
+
+	FPack SlammingScale;
+	FPack SlammingStopScale;
+	FPack InverseSlammingMaxAcceleration;
+	FPack InverseTimeStep;
+	float SlammingRampPower;
+	EFalloffPower SlammingRampFalloff;
+
+	// Set when there is a history to compare against.
+	bool bSlamming;
+};
+
+static HULLKERNEL_FORCEINLINE FPack Dot(const FPack& ax, const FPack& ay, const FPack& az, const FPack& bx, const FPack& by, const FPack& bz)
+{
+	return (ax * bx) + (ay * by) + (az * bz);
+}
+
+static HULLKERNEL_FORCEINLINE FPack CrossLength(const FVertexPack& a, const FVertexPack& b, const FVertexPack& c)
+{
+	const FPack edge1X = a.X - b.X;
+	const FPack edge1Y = a.Y - b.Y;
+	const FPack edge1Z = a.Z - b.Z;
+	const FPack edge2X = b.X - c.X;
+	const FPack edge2Y = b.Y - c.Y;
+	const FPack edge2Z = b.Z - c.Z;
+
+	const FPack crossX = (edge1Y * edge2Z) - (edge1Z * edge2Y);
+	const FPack crossY = (edge1Z * edge2X) - (edge1X * edge2Z);
+	const FPack crossZ = (edge1X * edge2Y) - (edge1Y * edge2X);
+	return Sqrt(Dot(crossX, crossY, crossZ, crossX, crossY, crossZ));
+}
+
+static HULLKERNEL_FORCEINLINE FVertexPack Select(const FMask& mask, const FVertexPack& a, const FVertexPack& b)
+{
+	FVertexPack result = { Select(mask, a.X, b.X), Select(mask, a.Y, b.Y), Select(mask, a.Z, b.Z), Select(mask, a.H, b.H) };
+	return result;
+}
+
+// Compare and swap so that lower ends up with the deeper of the two vertices.
+static HULLKERNEL_FORCEINLINE void SortByHeight(FVertexPack& lower, FVertexPack& higher)
+{
+	const FMask swap = Greater(lower.H, higher.H);
+	const FVertexPack deeper = Select(swap, higher, lower);
+	higher = Select(swap, lower, higher);
+	lower = deeper;
+}
+
+// Point where the edge from a submerged to a dry vertex crosses the water surface.
+static HULLKERNEL_FORCEINLINE FVertexPack WaterlineCrossing(const FKernelConstants& k, const FVertexPack& submerged, const FVertexPack& dry)
+{
+	// Lanes where the edge does not cross get a harmless parameter, they are masked out later.
+	const FPack heightDifference = dry.H - submerged.H;
+	const FPack t = (k.Zero - submerged.H) / Select(Greater(heightDifference, k.Zero), heightDifference, k.One);
+
+	FVertexPack result = { submerged.X + ((dry.X - submerged.X) * t), submerged.Y + ((dry.Y - submerged.Y) * t), submerged.Z + ((dry.Z - submerged.Z) * t), k.Zero };
+	return result;
+}
+
+static HULLKERNEL_FORCEINLINE FPack PowLanes(const FPack& base, float exponent)
+{
+	float lanes[FPack::Width];
+	Store(lanes, base);
+	for (int32_t lane = 0; lane < FPack::Width; ++lane)
+	{
+		lanes[lane] = std::pow(lanes[lane], exponent);
+	}
+	return Load(lanes);
+}
+
+// Same with an exponent per lane.
+static HULLKERNEL_FORCEINLINE FPack PowLanes(const FPack& base, const FPack& exponent)
+{
+	float lanes[FPack::Width];
+	float exponents[FPack::Width];
+	Store(lanes, base);
+	Store(exponents, exponent);
+	for (int32_t lane = 0; lane < FPack::Width; ++lane)
+	{
+		lanes[lane] = std::pow(lanes[lane], exponents[lane]);
+	}
+	return Load(lanes);
+}
+
+// Pressure drag falloff cos^power of the faces moving into the water, suction falloff of the others.
+// Specialized so that the common exponents never reach pow, the general form takes the exponent of each lane.
+template <EFalloffPower Power>
+struct TDragFalloff
+{
+	static HULLKERNEL_FORCEINLINE FPack Apply(const FKernelConstants& k, const FPack& cosMagnitude, const FMask& pressing)
+	{
+		return PowLanes(cosMagnitude, Select(pressing, k.PressureFalloffPower, k.SuctionFalloffPower));
+	}
+};
+
+template <>
+struct TDragFalloff<EFalloffPower::SquareRoot>
+{
+	static HULLKERNEL_FORCEINLINE FPack Apply(const FKernelConstants&, const FPack& cosMagnitude, const FMask&) { return Sqrt(cosMagnitude); }
+};
+
+template <>
+struct TDragFalloff<EFalloffPower::Linear>
+{
+	static HULLKERNEL_FORCEINLINE FPack Apply(const FKernelConstants&, const FPack& cosMagnitude, const FMask&) { return cosMagnitude; }
+};
+
+template <>
+struct TDragFalloff<EFalloffPower::Square>
+{
+	static HULLKERNEL_FORCEINLINE FPack Apply(const FKernelConstants&, const FPack& cosMagnitude, const FMask&) { return cosMagnitude * cosMagnitude; }
+};
+
+// Force terms of one hull type, fixed at compile time so that disabled terms compile out.
+template <uint32_t Terms, EFalloffPower DragFalloffPower>
+struct TForceModel
+{
+	static const bool bViscous = (Terms & ForceTermViscous) != 0;
+	static const bool bPressureDrag = (Terms & ForceTermPressureDrag) != 0;
+	static const bool bSlamming = (Terms & ForceTermSlamming) != 0;
+
+	typedef TDragFalloff<DragFalloffPower> FDragFalloff;
+};
+
+// Run time form for the slamming ramp, only evaluated on the few registers with a slamming triangle.
+static HULLKERNEL_FORCEINLINE FPack Falloff(const FPack& base, EFalloffPower power, float exponent)
+{
+	switch (power)
+	{
+	case EFalloffPower::SquareRoot:
+		return Sqrt(base);
+	case EFalloffPower::Linear:
+		return base;
+	case EFalloffPower::Square:
+		return base * base;
+	default:
+		return PowLanes(base, exponent);
+	}
+}
+
+static HULLKERNEL_FORCEINLINE float HorizontalSum(const FPack& value)
+{
+	float lanes[FPack::Width];
+	Store(lanes, value);
+	float sum = 0.0f;
+	for (int32_t lane = 0; lane < FPack::Width; ++lane)
+	{
+		sum += lanes[lane];
+	}
+	return sum;
+}
+
+// Slamming force of triangles hitting the water, from how fast the water they sweep grew since the previous evaluation:
+// the swept rate is submerged area * speed, its growth per triangle area and second is ramped against the maximum
+// acceleration into a fraction of the force that stops the triangle's share of the body, area over half the hull.
+// Only acts on faces moving into the water, against their velocity, zero on inactive lanes.
+static HULLKERNEL_FORCEINLINE void SlammingForce(const FKernelConstants& k, const FPack& submergedArea, const FPack& velocityX, const FPack& velocityY,
+	const FPack& velocityZ, const FPack& previousArea, const FPack& previousVelocityX, const FPack& previousVelocityY, const FPack& previousVelocityZ,
+	const FPack& area, const FPack& normalX, const FPack& normalY, const FPack& normalZ, const FMask& active,
+	FPack& outX, FPack& outY, FPack& outZ)
+{
+	const FPack speedSquared = Dot(velocityX, velocityY, velocityZ, velocityX, velocityY, velocityZ);
+	const FMask moving = Greater(speedSquared, k.SmallNumber);
+	const FPack speed = Sqrt(speedSquared);
+	const FPack previousSpeed = Sqrt(Dot(previousVelocityX, previousVelocityY, previousVelocityZ, previousVelocityX, previousVelocityY, previousVelocityZ));
+
+	const FMask validArea = Greater(area, k.Zero);
+	const FPack inverseArea = k.One / Select(validArea, area, k.One);
+	const FPack acceleration = ((submergedArea * speed) - (previousArea * previousSpeed)) * inverseArea * k.InverseTimeStep;
+
+	const FPack cosVelocityAndNormal = Dot(velocityX, velocityY, velocityZ, normalX, normalY, normalZ) / Select(moving, speed, k.One);
+	const FMask slamming = And(And(active, And(moving, validArea)), And(Greater(acceleration, k.Zero), Greater(cosVelocityAndNormal, k.Zero)));
+
+	const FPack ratio = acceleration * k.InverseSlammingMaxAcceleration;
+	const FPack ramp = Falloff(Select(slamming, Select(Greater(ratio, k.One), k.One, ratio), k.Zero), k.SlammingRampFalloff, k.SlammingRampPower);
+
+	// F = -scale * ramp * cos * (mass * 2 * submerged area / hull area) * velocity
+	const FPack slam = k.Zero - (k.SlammingScale * ramp * cosVelocityAndNormal * k.SlammingStopScale * submergedArea);
+	outX = Select(slamming, slam * velocityX, k.Zero);
+	outY = Select(slamming, slam * velocityY, k.Zero);
+	outZ = Select(slamming, slam * velocityZ, k.Zero);
+}
+
+// Hydrostatic, viscous and pressure drag forces on a (sub) triangle of the given area, zero on inactive lanes and for
+// the terms the model leaves out.
+template <typename TModel>
+static HULLKERNEL_FORCEINLINE void IntegrateSubTriangle(const FKernelConstants& k, const FVertexPack& p1, const FVertexPack& p2, const FVertexPack& p3,
+	const FPack& area, const FPack& normalX, const FPack& normalY, const FPack& normalZ, const FMask& active, FSubTriangleForces& out)
+{
+	out.CentroidX = (p1.X + p2.X + p3.X) * k.Third;
+	out.CentroidY = (p1.Y + p2.Y + p3.Y) * k.Third;
+	out.CentroidZ = (p1.Z + p2.Z + p3.Z) * k.Third;
+
+	// Hydrostatic force, the depth is linear over the triangle so its mean is the mean of the corners.
+	const FPack hydrostatic = k.HydrostaticScale * ((p1.H + p2.H + p3.H) * k.Third) * area;
+	out.HydrostaticX = Select(active, hydrostatic * normalX, k.Zero);
+	out.HydrostaticY = Select(active, hydrostatic * normalY, k.Zero);
+	out.HydrostaticZ = Select(active, hydrostatic * normalZ, k.Zero);
+
+	out.ForceX = out.HydrostaticX;
+	out.ForceY = out.HydrostaticY;
+	out.ForceZ = out.HydrostaticZ;
+
+	out.ViscousX = k.Zero;
+	out.ViscousY = k.Zero;
+	out.ViscousZ = k.Zero;
+	out.PressureDragX = k.Zero;
+	out.PressureDragY = k.Zero;
+	out.PressureDragZ = k.Zero;
+
+	if (!TModel::bViscous && !TModel::bPressureDrag)
+	{
+		return;
+	}
+
+	// Velocity of the centroid = velocity of the body + (angular velocity ^ arm from the centre of mass).
+	const FPack armX = out.CentroidX - k.CenterOfMassX;
+	const FPack armY = out.CentroidY - k.CenterOfMassY;
+	const FPack armZ = out.CentroidZ - k.CenterOfMassZ;
+	const FPack velocityX = k.LinearVelocityX + ((k.AngularVelocityY * armZ) - (k.AngularVelocityZ * armY));
+	const FPack velocityY = k.LinearVelocityY + ((k.AngularVelocityZ * armX) - (k.AngularVelocityX * armZ));
+	const FPack velocityZ = k.LinearVelocityZ + ((k.AngularVelocityX * armY) - (k.AngularVelocityY * armX));
+
+	const FPack speedSquared = Dot(velocityX, velocityY, velocityZ, velocityX, velocityY, velocityZ);
+	const FMask moving = Greater(speedSquared, k.SmallNumber);
+	const FPack inverseSpeed = Select(moving, k.One / Sqrt(Select(moving, speedSquared, k.One)), k.Zero);
+
+	// Viscous water resistance acts along the flow tangential to the triangle.
+	if (TModel::bViscous)
+	{
+		const FPack normalCrossVelocityX = (normalY * velocityZ) - (normalZ * velocityY);
+		const FPack normalCrossVelocityY = (normalZ * velocityX) - (normalX * velocityZ);
+		const FPack normalCrossVelocityZ = (normalX * velocityY) - (normalY * velocityX);
+		const FPack tangentX = ((normalY * normalCrossVelocityZ) - (normalZ * normalCrossVelocityY)) * inverseSpeed * inverseSpeed;
+		const FPack tangentY = ((normalZ * normalCrossVelocityX) - (normalX * normalCrossVelocityZ)) * inverseSpeed * inverseSpeed;
+		const FPack tangentZ = ((normalX * normalCrossVelocityY) - (normalY * normalCrossVelocityX)) * inverseSpeed * inverseSpeed;
+		const FPack tangentLengthSquared = Dot(tangentX, tangentY, tangentZ, tangentX, tangentY, tangentZ);
+		const FMask validTangent = Greater(tangentLengthSquared, k.SmallNumber);
+		const FPack inverseTangentLength = Select(validTangent, k.One / Sqrt(Select(validTangent, tangentLengthSquared, k.One)), k.Zero);
+
+		const FPack viscous = k.Zero - (k.ViscousScale * speedSquared * area * inverseTangentLength);
+		out.ViscousX = Select(active, viscous * tangentX, k.Zero);
+		out.ViscousY = Select(active, viscous * tangentY, k.Zero);
+		out.ViscousZ = Select(active, viscous * tangentZ, k.Zero);
+
+		out.ForceX = out.ForceX + out.ViscousX;
+		out.ForceY = out.ForceY + out.ViscousY;
+		out.ForceZ = out.ForceZ + out.ViscousZ;
+	}
+
+	// Pressure drag on the faces moving into the water, suction on the ones moving away from it.
+	if (TModel::bPressureDrag)
+	{
+		const FPack cosVelocityAndNormal = Dot(velocityX, velocityY, velocityZ, normalX, normalY, normalZ) * inverseSpeed;
+		const FMask pressing = Greater(cosVelocityAndNormal, k.Zero);
+		const FPack cosMagnitude = Select(pressing, cosVelocityAndNormal, k.Zero - cosVelocityAndNormal);
+		const FPack pressureDrag = Select(pressing, k.PressureScale, k.SuctionScale) * TModel::FDragFalloff::Apply(k, cosMagnitude, pressing) * area;
+		out.PressureDragX = Select(active, pressureDrag * normalX, k.Zero);
+		out.PressureDragY = Select(active, pressureDrag * normalY, k.Zero);
+		out.PressureDragZ = Select(active, pressureDrag * normalZ, k.Zero);
+
+		out.ForceX = out.ForceX + out.PressureDragX;
+		out.ForceY = out.ForceY + out.PressureDragY;
+		out.ForceZ = out.ForceZ + out.PressureDragZ;
+	}
+}
+
+template <typename TModel, bool bSubmerged>
+static void ComputeModelRange(const FHullView& hull, const float* waterHeights, const FBodyState& body,
+	const FForceCoefficients& coefficients, const FTriangleForces& out, int32_t begin, int32_t end, FKernelSummary& summary)
+{
+	FKernelConstants k;
+	k.Zero = Set(0.0f);
+	k.One = Set(1.0f);
+	k.Third = Set(1.0f / 3.0f);
+	k.SmallNumber = Set(KernelSmallNumber);
+	k.CrossLengthToArea = Set(0.5f * 1e-4f);
+
+	k.LinearVelocityX = Set(body.LinearVelocity[0]);
+	k.LinearVelocityY = Set(body.LinearVelocity[1]);
+	k.LinearVelocityZ = Set(body.LinearVelocity[2]);
+	k.AngularVelocityX = Set(body.AngularVelocity[0]);
+	k.AngularVelocityY = Set(body.AngularVelocity[1]);
+	k.AngularVelocityZ = Set(body.AngularVelocity[2]);
+	k.CenterOfMassX = Set(body.CenterOfMass[0]);
+	k.CenterOfMassY = Set(body.CenterOfMass[1]);
+	k.CenterOfMassZ = Set(body.CenterOfMass[2]);
+
+	// Per body invariants of the force terms.
+	k.HydrostaticScale = Set(-coefficients.DensityOfWater * body.Weight);
+	k.ViscousScale = Set(0.5f * coefficients.DensityOfWater * body.ResistanceCoefficient);
+	k.PressureScale = Set(-(coefficients.LinearPressureDrag + coefficients.QuadraticPressureDrag));
+	k.SuctionScale = Set(coefficients.LinearSuctionDrag + coefficients.QuadraticSuctionDrag);
+	k.PressureFalloffPower = Set(coefficients.PressureFalloffPower);
+	k.SuctionFalloffPower = Set(coefficients.SuctionFalloffPower);
+
+	k.SlammingScale = Set(coefficients.SlammingScale);
+	k.SlammingStopScale = Set((body.SurfaceArea > 0.0f) ? ((2.0f * body.Mass) / body.SurfaceArea) : 0.0f);
+	k.InverseSlammingMaxAcceleration = Set((coefficients.SlammingMaxAcceleration > 0.0f) ? (1.0f / coefficients.SlammingMaxAcceleration) : 0.0f);
+	k.InverseTimeStep = Set((body.TimeStep > 0.0f) ? (1.0f / body.TimeStep) : 0.0f);
+	k.SlammingRampPower = coefficients.SlammingRampPower;
+	k.SlammingRampFalloff = ClassifyFalloffPower(coefficients.SlammingRampPower);
+	k.bSlamming = TModel::bSlamming && (out.SubmergedAreaHistory != nullptr) && (body.TimeStep > 0.0f);
+
+	const FPack zero = k.Zero;
+	const FPack one = k.One;
+
+	FPack submergedArea = zero;
+	FPack forceSumX = zero;
+	FPack forceSumY = zero;
+	FPack forceSumZ = zero;
+	FPack torqueSumX = zero;
+	FPack torqueSumY = zero;
+	FPack torqueSumZ = zero;
+
+	int32_t tri = begin;
+	for (; tri + FPack::Width <= end; tri += FPack::Width)
+	{
+		const FIndex index1 = LoadCorner(hull.Indices, tri, 0);
+		const FIndex index2 = LoadCorner(hull.Indices, tri, 1);
+		const FIndex index3 = LoadCorner(hull.Indices, tri, 2);
+
+		FVertexPack vertex1 = { Gather(hull.X, index1), Gather(hull.Y, index1), Gather(hull.Z, index1), zero };
+		FVertexPack vertex2 = { Gather(hull.X, index2), Gather(hull.Y, index2), Gather(hull.Z, index2), zero };
+		FVertexPack vertex3 = { Gather(hull.X, index3), Gather(hull.Y, index3), Gather(hull.Z, index3), zero };
+
+		// Height of each vertex above the water surface.
+		vertex1.H = vertex1.Z - Gather(waterHeights, index1);
+		vertex2.H = vertex2.Z - Gather(waterHeights, index2);
+		vertex3.H = vertex3.Z - Gather(waterHeights, index3);
+
+		const FPack submergedCount = Select(Less(vertex1.H, zero), one, zero) + Select(Less(vertex2.H, zero), one, zero) + Select(Less(vertex3.H, zero), one, zero);
+		// Normal from the cross product of two edges.
+		const FPack edge1X = vertex1.X - vertex2.X;
+		const FPack edge1Y = vertex1.Y - vertex2.Y;
+		const FPack edge1Z = vertex1.Z - vertex2.Z;
+		const FPack edge2X = vertex2.X - vertex3.X;
+		const FPack edge2Y = vertex2.Y - vertex3.Y;
+		const FPack edge2Z = vertex2.Z - vertex3.Z;
+
+		FPack normalX = (edge1Y * edge2Z) - (edge1Z * edge2Y);
+		FPack normalY = (edge1Z * edge2X) - (edge1X * edge2Z);
+		FPack normalZ = (edge1X * edge2Y) - (edge1Y * edge2X);
+
+		const FPack normalLengthSquared = Dot(normalX, normalY, normalZ, normalX, normalY, normalZ);
+		const FMask validNormal = Greater(normalLengthSquared, k.SmallNumber);
+		const FPack inverseNormalLength = Select(validNormal, one / Sqrt(Select(validNormal, normalLengthSquared, one)), zero);
+		normalX = normalX * inverseNormalLength;
+		normalY = normalY * inverseNormalLength;
+		normalZ = normalZ * inverseNormalLength;
+
+		// World space area, exact whatever the scale of the body, non uniform ones included.
+		const FPack areaPerCrossLength = Select(validNormal, k.CrossLengthToArea, zero);
+		const FPack area = normalLengthSquared * inverseNormalLength * areaPerCrossLength;
+
+		const FPack centroidX = (vertex1.X + vertex2.X + vertex3.X) * k.Third;
+		const FPack centroidY = (vertex1.Y + vertex2.Y + vertex3.Y) * k.Third;
+		const FPack centroidZ = (vertex1.Z + vertex2.Z + vertex3.Z) * k.Third;
+
+		// Sort the corners from deepest to highest, the waterline then always cuts the same edges.
+		FVertexPack low = vertex1;
+		FVertexPack mid = vertex2;
+		FVertexPack high = vertex3;
+		SortByHeight(low, mid);
+		SortByHeight(mid, high);
+		SortByHeight(low, mid);
+
+		const FMask anySubmerged = Less(low.H, zero);
+		const FMask full = Less(high.H, zero);
+		const FMask partialTwo = AndNot(Less(mid.H, zero), full);
+
+		// Only triangles in the water and facing downwards receive force.
+		const FMask applied = And(anySubmerged, Less(normalZ, zero));
+
+		// Submerged part as up to two sub triangles in the plane of the triangle, so they share its normal:
+		//   full:       A = (low, mid, high)
+		//   two under:  A = (mid, mid-high crossing, low), B = (low, mid-high crossing, low-high crossing)
+		//   one under:  A = (low, low-high crossing, low-mid crossing)
+		// A range known to be under the water is all full triangles and never cuts them.
+		FVertexPack a1 = low;
+		FVertexPack a2 = mid;
+		FVertexPack a3 = high;
+		FPack areaA = area;
+		FVertexPack crossingMidHigh = high;
+		FVertexPack crossingLowHigh = high;
+
+		if (!bSubmerged)
+		{
+			crossingMidHigh = WaterlineCrossing(k, mid, high);
+			crossingLowHigh = WaterlineCrossing(k, low, high);
+			const FVertexPack crossingLowMid = WaterlineCrossing(k, low, mid);
+
+			a1 = Select(partialTwo, mid, low);
+			a2 = Select(full, mid, Select(partialTwo, crossingMidHigh, crossingLowHigh));
+			a3 = Select(full, high, Select(partialTwo, low, crossingLowMid));
+			areaA = Select(anySubmerged, Select(full, area, CrossLength(a1, a2, a3) * areaPerCrossLength), zero);
+		}
+
+		FSubTriangleForces forcesA;
+		IntegrateSubTriangle<TModel>(k, a1, a2, a3, areaA, normalX, normalY, normalZ, applied, forcesA);
+
+		FPack forceX = forcesA.ForceX;
+		FPack forceY = forcesA.ForceY;
+		FPack forceZ = forcesA.ForceZ;
+
+		// Torque about the centre of mass = arm ^ force, summed per sub triangle.
+		FPack armX = forcesA.CentroidX - k.CenterOfMassX;
+		FPack armY = forcesA.CentroidY - k.CenterOfMassY;
+		FPack armZ = forcesA.CentroidZ - k.CenterOfMassZ;
+		torqueSumX = torqueSumX + ((armY * forcesA.ForceZ) - (armZ * forcesA.ForceY));
+		torqueSumY = torqueSumY + ((armZ * forcesA.ForceX) - (armX * forcesA.ForceZ));
+		torqueSumZ = torqueSumZ + ((armX * forcesA.ForceY) - (armY * forcesA.ForceX));
+
+		// The force acts on the centroid of the submerged part, or the centroid of the triangle when it is dry.
+		FPack forceCentroidX = Select(anySubmerged, forcesA.CentroidX, centroidX);
+		FPack forceCentroidY = Select(anySubmerged, forcesA.CentroidY, centroidY);
+		FPack forceCentroidZ = Select(anySubmerged, forcesA.CentroidZ, centroidZ);
+
+		FPack hydrostaticX = forcesA.HydrostaticX;
+		FPack hydrostaticY = forcesA.HydrostaticY;
+		FPack hydrostaticZ = forcesA.HydrostaticZ;
+		FPack viscousX = forcesA.ViscousX;
+		FPack viscousY = forcesA.ViscousY;
+		FPack viscousZ = forcesA.ViscousZ;
+		FPack pressureDragX = forcesA.PressureDragX;
+		FPack pressureDragY = forcesA.PressureDragY;
+		FPack pressureDragZ = forcesA.PressureDragZ;
+
+		FPack areaB = zero;
+
+		// Second sub triangle, skipped when no lane has two submerged corners.
+		if (!bSubmerged && (MaskBits(partialTwo) != 0))
+		{
+			areaB = Select(partialTwo, CrossLength(low, crossingMidHigh, crossingLowHigh) * areaPerCrossLength, zero);
+
+			FSubTriangleForces forcesB;
+			IntegrateSubTriangle<TModel>(k, low, crossingMidHigh, crossingLowHigh, areaB, normalX, normalY, normalZ, And(applied, partialTwo), forcesB);
+
+			forceX = forceX + forcesB.ForceX;
+			forceY = forceY + forcesB.ForceY;
+			forceZ = forceZ + forcesB.ForceZ;
+
+			armX = forcesB.CentroidX - k.CenterOfMassX;
+			armY = forcesB.CentroidY - k.CenterOfMassY;
+			armZ = forcesB.CentroidZ - k.CenterOfMassZ;
+			torqueSumX = torqueSumX + ((armY * forcesB.ForceZ) - (armZ * forcesB.ForceY));
+			torqueSumY = torqueSumY + ((armZ * forcesB.ForceX) - (armX * forcesB.ForceZ));
+			torqueSumZ = torqueSumZ + ((armX * forcesB.ForceY) - (armY * forcesB.ForceX));
+
+			const FPack submergedTotal = areaA + areaB;
+			const FMask weighted = And(partialTwo, Greater(submergedTotal, zero));
+			const FPack inverseTotal = one / Select(weighted, submergedTotal, one);
+			forceCentroidX = Select(weighted, ((forcesA.CentroidX * areaA) + (forcesB.CentroidX * areaB)) * inverseTotal, forceCentroidX);
+			forceCentroidY = Select(weighted, ((forcesA.CentroidY * areaA) + (forcesB.CentroidY * areaB)) * inverseTotal, forceCentroidY);
+			forceCentroidZ = Select(weighted, ((forcesA.CentroidZ * areaA) + (forcesB.CentroidZ * areaB)) * inverseTotal, forceCentroidZ);
+
+			hydrostaticX = hydrostaticX + forcesB.HydrostaticX;
+			hydrostaticY = hydrostaticY + forcesB.HydrostaticY;
+			hydrostaticZ = hydrostaticZ + forcesB.HydrostaticZ;
+			viscousX = viscousX + forcesB.ViscousX;
+			viscousY = viscousY + forcesB.ViscousY;
+			viscousZ = viscousZ + forcesB.ViscousZ;
+			pressureDragX = pressureDragX + forcesB.PressureDragX;
+			pressureDragY = pressureDragY + forcesB.PressureDragY;
+			pressureDragZ = pressureDragZ + forcesB.PressureDragZ;
+		}
+
+		// Slamming needs the previous evaluation of the triangle. Triangles staying dry or fully under have the same
+		// submerged area as then and do not slam, a register of only those skips the force entirely.
+		if (TModel::bSlamming && out.SubmergedAreaHistory)
+		{
+			const FPack submergedTotal = areaA + areaB;
+			const FPack armCentroidX = centroidX - k.CenterOfMassX;
+			const FPack armCentroidY = centroidY - k.CenterOfMassY;
+			const FPack armCentroidZ = centroidZ - k.CenterOfMassZ;
+			const FPack velocityX = k.LinearVelocityX + ((k.AngularVelocityY * armCentroidZ) - (k.AngularVelocityZ * armCentroidY));
+			const FPack velocityY = k.LinearVelocityY + ((k.AngularVelocityZ * armCentroidX) - (k.AngularVelocityX * armCentroidZ));
+			const FPack velocityZ = k.LinearVelocityZ + ((k.AngularVelocityX * armCentroidY) - (k.AngularVelocityY * armCentroidX));
+
+			FPack slammingX = zero;
+			FPack slammingY = zero;
+			FPack slammingZ = zero;
+
+			const FPack previousArea = Load(out.SubmergedAreaHistory + tri);
+			const FPack areaChange = submergedTotal - previousArea;
+			const FMask changed = And(applied, Greater(areaChange * areaChange, zero));
+			if (k.bSlamming && (MaskBits(changed) != 0))
+			{
+				SlammingForce(k, submergedTotal, velocityX, velocityY, velocityZ, previousArea, Load(out.VelocityHistoryX + tri), Load(out.VelocityHistoryY + tri),
+					Load(out.VelocityHistoryZ + tri), area, normalX, normalY, normalZ, changed, slammingX, slammingY, slammingZ);
+
+				forceX = forceX + slammingX;
+				forceY = forceY + slammingY;
+				forceZ = forceZ + slammingZ;
+
+				armX = forceCentroidX - k.CenterOfMassX;
+				armY = forceCentroidY - k.CenterOfMassY;
+				armZ = forceCentroidZ - k.CenterOfMassZ;
+				torqueSumX = torqueSumX + ((armY * slammingZ) - (armZ * slammingY));
+				torqueSumY = torqueSumY + ((armZ * slammingX) - (armX * slammingZ));
+				torqueSumZ = torqueSumZ + ((armX * slammingY) - (armY * slammingX));
+			}
+
+			Store(out.SubmergedAreaHistory + tri, submergedTotal);
+			Store(out.VelocityHistoryX + tri, velocityX);
+			Store(out.VelocityHistoryY + tri, velocityY);
+			Store(out.VelocityHistoryZ + tri, velocityZ);
+
+			if (out.SlammingX)
+			{
+				Store(out.SlammingX + tri, slammingX);
+				Store(out.SlammingY + tri, slammingY);
+				Store(out.SlammingZ + tri, slammingZ);
+			}
+		}
+		else if (out.SlammingX)
+		{
+			Store(out.SlammingX + tri, zero);
+			Store(out.SlammingY + tri, zero);
+			Store(out.SlammingZ + tri, zero);
+		}
+
+		submergedArea = submergedArea + areaA + areaB;
+		forceSumX = forceSumX + forceX;
+		forceSumY = forceSumY + forceY;
+		forceSumZ = forceSumZ + forceZ;
+
+		Store(out.ForceX + tri, forceX);
+		Store(out.ForceY + tri, forceY);
+		Store(out.ForceZ + tri, forceZ);
+		Store(out.CentroidX + tri, forceCentroidX);
+		Store(out.CentroidY + tri, forceCentroidY);
+		Store(out.CentroidZ + tri, forceCentroidZ);
+
+		if (out.HydrostaticX)
+		{
+			Store(out.HydrostaticX + tri, hydrostaticX);
+			Store(out.HydrostaticY + tri, hydrostaticY);
+			Store(out.HydrostaticZ + tri, hydrostaticZ);
+		}
+		if (out.ViscousX)
+		{
+			Store(out.ViscousX + tri, viscousX);
+			Store(out.ViscousY + tri, viscousY);
+			Store(out.ViscousZ + tri, viscousZ);
+		}
+		if (out.PressureDragX)
+		{
+			Store(out.PressureDragX + tri, pressureDragX);
+			Store(out.PressureDragY + tri, pressureDragY);
+			Store(out.PressureDragZ + tri, pressureDragZ);
+		}
+
+		float counts[FPack::Width];
+		Store(counts, submergedCount);
+		const int32_t appliedBits = MaskBits(applied);
+		for (int32_t lane = 0; lane < FPack::Width; ++lane)
+		{
+			const uint8_t submersion = static_cast<uint8_t>(counts[lane]);
+			const uint8_t isApplied = static_cast<uint8_t>((appliedBits >> lane) & 1);
+			out.Submersion[tri + lane] = submersion;
+			out.Applied[tri + lane] = isApplied;
+			++summary.SubmersionCounts[submersion];
+			summary.AppliedCount += isApplied;
+		}
+	}
+
+	summary.SubmergedArea += HorizontalSum(submergedArea);
+	summary.Wrench.Force[0] += HorizontalSum(forceSumX);
+	summary.Wrench.Force[1] += HorizontalSum(forceSumY);
+	summary.Wrench.Force[2] += HorizontalSum(forceSumZ);
+	summary.Wrench.Torque[0] += HorizontalSum(torqueSumX);
+	summary.Wrench.Torque[1] += HorizontalSum(torqueSumY);
+	summary.Wrench.Torque[2] += HorizontalSum(torqueSumZ);
+
+	// Remainder that does not fill a whole register.
+	if (tri < end)
+	{
+		HullKernel::Scalar::ComputeRange(hull, waterHeights, body, coefficients, out, tri, end, summary, bSubmerged);
+	}
+}
+
+typedef void (*FModelRange)(const FHullView& hull, const float* waterHeights, const FBodyState& body,
+	const FForceCoefficients& coefficients, const FTriangleForces& out, int32_t begin, int32_t end, FKernelSummary& summary);
+
+template <uint32_t Terms, bool bSubmerged>
+static FModelRange SelectDragFalloff(EFalloffPower dragFalloff)
+{
+	switch (dragFalloff)
+	{
+	case EFalloffPower::SquareRoot:
+		return &ComputeModelRange<TForceModel<Terms, EFalloffPower::SquareRoot>, bSubmerged>;
+	case EFalloffPower::Linear:
+		return &ComputeModelRange<TForceModel<Terms, EFalloffPower::Linear>, bSubmerged>;
+	case EFalloffPower::Square:
+		return &ComputeModelRange<TForceModel<Terms, EFalloffPower::Square>, bSubmerged>;
+	default:
+		return &ComputeModelRange<TForceModel<Terms, EFalloffPower::General>, bSubmerged>;
+	}
+}
+
+template <bool bSubmerged>
+static FModelRange SelectModelRange(const FForceCoefficients& coefficients)
+{
+	// The pressure and suction drag only take a fast path when they share it.
+	const EFalloffPower pressureFalloff = ClassifyFalloffPower(coefficients.PressureFalloffPower);
+	const EFalloffPower dragFalloff = (pressureFalloff == ClassifyFalloffPower(coefficients.SuctionFalloffPower)) ? pressureFalloff : EFalloffPower::General;
+
+	switch (coefficients.Terms & ForceTermsAll)
+	{
+	case 0:
+		return &ComputeModelRange<TForceModel<0, EFalloffPower::General>, bSubmerged>;
+	case ForceTermViscous:
+		return &ComputeModelRange<TForceModel<ForceTermViscous, EFalloffPower::General>, bSubmerged>;
+	case ForceTermSlamming:
+		return &ComputeModelRange<TForceModel<ForceTermSlamming, EFalloffPower::General>, bSubmerged>;
+	case ForceTermViscous | ForceTermSlamming:
+		return &ComputeModelRange<TForceModel<ForceTermViscous | ForceTermSlamming, EFalloffPower::General>, bSubmerged>;
+	case ForceTermPressureDrag:
+		return SelectDragFalloff<ForceTermPressureDrag, bSubmerged>(dragFalloff);
+	case ForceTermViscous | ForceTermPressureDrag:
+		return SelectDragFalloff<ForceTermViscous | ForceTermPressureDrag, bSubmerged>(dragFalloff);
+	case ForceTermPressureDrag | ForceTermSlamming:
+		return SelectDragFalloff<ForceTermPressureDrag | ForceTermSlamming, bSubmerged>(dragFalloff);
+	default:
+		return SelectDragFalloff<ForceTermsAll, bSubmerged>(dragFalloff);
+	}
+}
+
+void ComputeRange(const FHullView& hull, const float* waterHeights, const FBodyState& body,
+	const FForceCoefficients& coefficients, const FTriangleForces& out, int32_t begin, int32_t end, FKernelSummary& summary, bool bSubmerged)
+{
+	const FModelRange modelRange = bSubmerged ? SelectModelRange<true>(coefficients) : SelectModelRange<false>(coefficients);
+	modelRange(hull, waterHeights, body, coefficients, out, begin, end, summary);
+}
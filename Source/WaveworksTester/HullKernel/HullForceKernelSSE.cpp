@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HullForceKernel.h"
+
+#if HULLKERNEL_X86
+
+#include <cmath>
+#include <emmintrin.h>
+
+namespace HullKernel
+{
+	namespace SSE
+	{
+		// SSE2 is part of the x64 baseline, so this path needs no runtime check.
+		struct FPack
+		{
+			static const int32_t Width = 4;
+			__m128 V;
+		};
+
+		struct FMask
+		{
+			__m128 V;
+		};
+
+		struct FIndex
+		{
+			int32_t I[4];
+		};
+
+		static HULLKERNEL_FORCEINLINE FPack Pack(__m128 value) { FPack result = { value }; return result; }
+		static HULLKERNEL_FORCEINLINE FMask Mask(__m128 value) { FMask result = { value }; return result; }
+
+		static HULLKERNEL_FORCEINLINE FPack Set(float value) { return Pack(_mm_set1_ps(value)); }
+		static HULLKERNEL_FORCEINLINE FPack Load(const float* source) { return Pack(_mm_loadu_ps(source)); }
+		static HULLKERNEL_FORCEINLINE void Store(float* destination, const FPack& value) { _mm_storeu_ps(destination, value.V); }
+
+		static HULLKERNEL_FORCEINLINE FIndex LoadCorner(const int32_t* indices, int32_t tri, int32_t corner)
+		{
+			const int32_t* first = indices + (tri * 3) + corner;
+			FIndex result = { { first[0], first[3], first[6], first[9] } };
+			return result;
+		}
+
+		static HULLKERNEL_FORCEINLINE FPack Gather(const float* base, const FIndex& index)
+		{
+			return Pack(_mm_set_ps(base[index.I[3]], base[index.I[2]], base[index.I[1]], base[index.I[0]]));
+		}
+
+		static HULLKERNEL_FORCEINLINE FPack operator+(const FPack& a, const FPack& b) { return Pack(_mm_add_ps(a.V, b.V)); }
+		static HULLKERNEL_FORCEINLINE FPack operator-(const FPack& a, const FPack& b) { return Pack(_mm_sub_ps(a.V, b.V)); }
+		static HULLKERNEL_FORCEINLINE FPack operator*(const FPack& a, const FPack& b) { return Pack(_mm_mul_ps(a.V, b.V)); }
+		static HULLKERNEL_FORCEINLINE FPack operator/(const FPack& a, const FPack& b) { return Pack(_mm_div_ps(a.V, b.V)); }
+		static HULLKERNEL_FORCEINLINE FPack Sqrt(const FPack& a) { return Pack(_mm_sqrt_ps(a.V)); }
+
+		static HULLKERNEL_FORCEINLINE FMask Less(const FPack& a, const FPack& b) { return Mask(_mm_cmplt_ps(a.V, b.V)); }
+		static HULLKERNEL_FORCEINLINE FMask Greater(const FPack& a, const FPack& b) { return Mask(_mm_cmpgt_ps(a.V, b.V)); }
+		static HULLKERNEL_FORCEINLINE FMask And(const FMask& a, const FMask& b) { return Mask(_mm_and_ps(a.V, b.V)); }
+		static HULLKERNEL_FORCEINLINE FMask AndNot(const FMask& a, const FMask& b) { return Mask(_mm_andnot_ps(b.V, a.V)); }
+		static HULLKERNEL_FORCEINLINE FPack Select(const FMask& mask, const FPack& a, const FPack& b)
+		{
+			return Pack(_mm_or_ps(_mm_and_ps(mask.V, a.V), _mm_andnot_ps(mask.V, b.V)));
+		}
+		static HULLKERNEL_FORCEINLINE int32_t MaskBits(const FMask& mask) { return _mm_movemask_ps(mask.V); }
+
+#include "HullForceKernelBody.inl"
+	}
+}
+
+#endif
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HullForceKernel.h"
+
+#include <cmath>
+
+namespace HullKernel
+{
+	namespace Scalar
+	{
+		struct FPack
+		{
+			static const int32_t Width = 1;
+			float V;
+		};
+
+		typedef bool FMask;
+		typedef int32_t FIndex;
+
+		static HULLKERNEL_FORCEINLINE FPack Set(float value) { FPack result = { value }; return result; }
+		static HULLKERNEL_FORCEINLINE FPack Load(const float* source) { return Set(*source); }
+		static HULLKERNEL_FORCEINLINE void Store(float* destination, const FPack& value) { *destination = value.V; }
+		static HULLKERNEL_FORCEINLINE FIndex LoadCorner(const int32_t* indices, int32_t tri, int32_t corner) { return indices[(tri * 3) + corner]; }
+		static HULLKERNEL_FORCEINLINE FPack Gather(const float* base, FIndex index) { return Set(base[index]); }
+
+		static HULLKERNEL_FORCEINLINE FPack operator+(const FPack& a, const FPack& b) { return Set(a.V + b.V); }
+		static HULLKERNEL_FORCEINLINE FPack operator-(const FPack& a, const FPack& b) { return Set(a.V - b.V); }
+		static HULLKERNEL_FORCEINLINE FPack operator*(const FPack& a, const FPack& b) { return Set(a.V * b.V); }
+		static HULLKERNEL_FORCEINLINE FPack operator/(const FPack& a, const FPack& b) { return Set(a.V / b.V); }
+		static HULLKERNEL_FORCEINLINE FPack Sqrt(const FPack& a) { return Set(std::sqrt(a.V)); }
+
+		static HULLKERNEL_FORCEINLINE FMask Less(const FPack& a, const FPack& b) { return a.V < b.V; }
+		static HULLKERNEL_FORCEINLINE FMask Greater(const FPack& a, const FPack& b) { return a.V > b.V; }
+		static HULLKERNEL_FORCEINLINE FMask And(FMask a, FMask b) { return a && b; }
+		static HULLKERNEL_FORCEINLINE FMask AndNot(FMask a, FMask b) { return a && !b; }
+		static HULLKERNEL_FORCEINLINE FPack Select(FMask mask, const FPack& a, const FPack& b) { return mask ? a : b; }
+		static HULLKERNEL_FORCEINLINE int32_t MaskBits(FMask mask) { return mask ? 1 : 0; }
+
+#include "HullForceKernelBody.inl"
+	}
+}
@@ -0,0 +1,205 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Engine independent types shared by the hull force kernel and its Unreal adapter.
+// Nothing in the HullKernel folder may include engine headers so that it can be built and tested headless.
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define HULLKERNEL_X86 1
+#else
+#define HULLKERNEL_X86 0
+#endif
+
+#if defined(_MSC_VER)
+#define HULLKERNEL_FORCEINLINE __forceinline
+#else
+#define HULLKERNEL_FORCEINLINE inline __attribute__((always_inline))
+#endif
+
+namespace HullKernel
+{
+	// Mirrors the number of submerged vertices of a triangle, so the value can be used as a count.
+	enum class ESubmersion : uint8_t
+	{
+		None = 0,
+		PartialSingleVertex = 1,
+		PartialTwoVertices = 2,
+		Full = 3
+	};
+
+	enum class EKernelPath : uint8_t
+	{
+		Auto,
+		Scalar,
+		SSE,
+		AVX2
+	};
+
+	// Node of the bounding volume hierarchy over the triangles of a hull, see BuildHullBVH.
+	struct FHullNode
+	{
+		// Mesh space box around the vertices of the node's triangles.
+		float Center[3];
+		float Extent[3];
+
+		// Triangles [Begin, End) of the node.
+		int32_t Begin;
+		int32_t End;
+
+		// Index of the second child, the first one directly follows the node. 0 for a leaf.
+		int32_t Second;
+
+		// Leaves only, the vertices their triangles use are NodeVertices [VertexBegin, VertexEnd).
+		int32_t VertexBegin;
+		int32_t VertexEnd;
+	};
+
+	// Read only structure-of-arrays view of a hull. Positions are in cm, the kernel computes the areas (m2) from them.
+	struct FHullView
+	{
+		const float* X;
+		const float* Y;
+		const float* Z;
+
+		// Three vertex indices per triangle.
+		const int32_t* Indices;
+
+		int32_t NumVertices;
+		int32_t NumTriangles;
+
+		// Optional hierarchy over the triangles, null to classify every triangle. With it, nodes entirely above or
+		// below the water are handled at once and only the triangles of the waterline ones are clipped. See BindHullBVH.
+		const FHullNode* Nodes;
+		const int32_t* NodeVertices;
+		int32_t NumNodes;
+
+		// Z row of the mesh to world transform the vertices were taken to the water with, and the range of the water
+		// heights under them, to bound the nodes in height.
+		float HeightRow[4];
+		float WaterMin;
+		float WaterMax;
+	};
+
+	// Rigid body state sampled once per tick.
+	struct FBodyState
+	{
+		float LinearVelocity[3];
+		float AngularVelocity[3];
+		float CenterOfMass[3];
+
+		// Gravity multiplied by the mass of the body, as fed to the hydrostatic force.
+		float Weight;
+
+		// Per body viscous resistance coefficient, depends on the Reynolds number of the whole hull.
+		float ResistanceCoefficient;
+
+		// kg, and the surface area (m2) of the whole hull at the scale of the body, for the slamming force.
+		float Mass;
+		float SurfaceArea;
+
+		// Seconds since the evaluation the triangle history was written by, 0 when it holds nothing usable yet.
+		float TimeStep;
+	};
+
+	// Force terms a hull can be evaluated with. The hydrostatic force is always on, the kernel is compiled once for every
+	// combination of the others so that a disabled term costs nothing.
+	static const uint32_t ForceTermViscous = 1 << 0;
+	static const uint32_t ForceTermPressureDrag = 1 << 1;
+	static const uint32_t ForceTermSlamming = 1 << 2;
+	static const uint32_t ForceTermsAll = ForceTermViscous | ForceTermPressureDrag | ForceTermSlamming;
+
+	// Falloff exponents with a cheaper form than pow, General is any other.
+	enum class EFalloffPower : uint8_t
+	{
+		General,
+		SquareRoot,
+		Linear,
+		Square
+	};
+
+	struct FForceCoefficients
+	{
+		// ForceTerm flags.
+		uint32_t Terms;
+
+		float DensityOfWater;
+
+		float LinearPressureDrag;
+		float QuadraticPressureDrag;
+		float PressureFalloffPower;
+
+		float LinearSuctionDrag;
+		float QuadraticSuctionDrag;
+		float SuctionFalloffPower;
+
+		// Fraction of a triangle's share of the body momentum a full slam takes out per tuned tick.
+		float SlammingScale;
+
+		// Rate (cm/s2) at which the water swept by a triangle has to grow for a full slam, and the ramp up to it.
+		float SlammingMaxAcceleration;
+		float SlammingRampPower;
+	};
+
+	// Structure-of-arrays per triangle output. Every pointer must hold NumTriangles elements.
+	// The per term force arrays are optional and only written when not null (debug drawing).
+	// The history arrays are optional as well, without them there is no slamming force.
+	struct FTriangleForces
+	{
+		uint8_t* Submersion;
+
+		// Non zero when a force was computed for the triangle.
+		uint8_t* Applied;
+
+		float* ForceX;
+		float* ForceY;
+		float* ForceZ;
+
+		float* CentroidX;
+		float* CentroidY;
+		float* CentroidZ;
+
+		float* HydrostaticX;
+		float* HydrostaticY;
+		float* HydrostaticZ;
+
+		float* ViscousX;
+		float* ViscousY;
+		float* ViscousZ;
+
+		float* PressureDragX;
+		float* PressureDragY;
+		float* PressureDragZ;
+
+		float* SlammingX;
+		float* SlammingY;
+		float* SlammingZ;
+
+		// Submerged area (m2) and centroid velocity (cm/s) of every triangle at the previous evaluation, read and then
+		// overwritten with this one's. They belong to one body and hull, and have to be zeroed when either changes.
+		float* SubmergedAreaHistory;
+		float* VelocityHistoryX;
+		float* VelocityHistoryY;
+		float* VelocityHistoryZ;
+	};
+
+	// Net force and torque about the centre of mass of a body.
+	struct FWrench
+	{
+		float Force[3];
+		float Torque[3];
+	};
+
+	struct FKernelSummary
+	{
+		// Sum of all triangle forces, so the body can be pushed with one call per tick.
+		FWrench Wrench;
+
+		float SubmergedArea;
+		int32_t SubmersionCounts[4];
+		int32_t AppliedCount;
+	};
+}
@@ -0,0 +1,225 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HullSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace HullKernel
+{
+	static const int32_t CoarsestLODTriangles = 48;
+	static const int32_t SimplifierIterations = 24;
+
+	int32_t HullLODTargetTriangles(int32_t sourceTriangles, int32_t lod)
+	{
+		if (lod <= 0)
+		{
+			return sourceTriangles;
+		}
+		if (lod >= (HullLODCount - 1))
+		{
+			return std::min(sourceTriangles, CoarsestLODTriangles);
+		}
+		return std::max(std::min(sourceTriangles, CoarsestLODTriangles), sourceTriangles >> (2 * lod));
+	}
+
+	float HullVolume(const FHullData& hull)
+	{
+		// Sum of the signed volumes of the tetrahedra formed by each triangle and the origin.
+		double volume = 0.0;
+		for (int32_t tri = 0; tri < hull.NumTriangles(); ++tri)
+		{
+			const int32_t index1 = hull.Indices[(tri * 3) + 0];
+			const int32_t index2 = hull.Indices[(tri * 3) + 1];
+			const int32_t index3 = hull.Indices[(tri * 3) + 2];
+
+			const double crossX = (static_cast<double>(hull.Y[index2]) * hull.Z[index3]) - (static_cast<double>(hull.Z[index2]) * hull.Y[index3]);
+			const double crossY = (static_cast<double>(hull.Z[index2]) * hull.X[index3]) - (static_cast<double>(hull.X[index2]) * hull.Z[index3]);
+			const double crossZ = (static_cast<double>(hull.X[index2]) * hull.Y[index3]) - (static_cast<double>(hull.Y[index2]) * hull.X[index3]);
+			volume += (hull.X[index1] * crossX) + (hull.Y[index1] * crossY) + (hull.Z[index1] * crossZ);
+		}
+		return static_cast<float>(std::abs(volume) / 6.0);
+	}
+
+	float HullFootprintArea(const FHullData& hull)
+	{
+		// Every downward facing triangle contributes its area projected on the XY plane, half the Z of its edge cross
+		// product. Taken from the vertices, so it also works on hulls that were not finalized.
+		double area = 0.0;
+		for (int32_t tri = 0; tri < hull.NumTriangles(); ++tri)
+		{
+			const int32_t index1 = hull.Indices[(tri * 3) + 0];
+			const int32_t index2 = hull.Indices[(tri * 3) + 1];
+			const int32_t index3 = hull.Indices[(tri * 3) + 2];
+
+			const double edge1X = static_cast<double>(hull.X[index1]) - hull.X[index2];
+			const double edge1Y = static_cast<double>(hull.Y[index1]) - hull.Y[index2];
+			const double edge2X = static_cast<double>(hull.X[index2]) - hull.X[index3];
+			const double edge2Y = static_cast<double>(hull.Y[index2]) - hull.Y[index3];
+			const double crossZ = (edge1X * edge2Y) - (edge1Y * edge2X);
+			if (crossZ < 0.0)
+			{
+				area -= 0.5 * crossZ;
+			}
+		}
+		return static_cast<float>(area);
+	}
+
+	static uint64_t CellKey(float x, float y, float z, const float* boundsMin, float inverseCellSize)
+	{
+		const uint64_t cellX = static_cast<uint64_t>((x - boundsMin[0]) * inverseCellSize) & 0x1FFFFF;
+		const uint64_t cellY = static_cast<uint64_t>((y - boundsMin[1]) * inverseCellSize) & 0x1FFFFF;
+		const uint64_t cellZ = static_cast<uint64_t>((z - boundsMin[2]) * inverseCellSize) & 0x1FFFFF;
+		return cellX | (cellY << 21) | (cellZ << 42);
+	}
+
+	// Collapses all vertices sharing a grid cell into their average and drops the triangles that degenerate.
+	// Only the vertices and indices, the caller finalizes the hull it keeps.
+	static void ClusterVertices(const FHullData& source, const float* boundsMin, float cellSize, FHullData& outHull)
+	{
+		const float inverseCellSize = 1.0f / cellSize;
+		const int32_t numVertices = source.NumVertices();
+
+		std::unordered_map<uint64_t, int32_t> cells;
+		cells.reserve(numVertices);
+		std::vector<int32_t> vertexCell(numVertices);
+		std::vector<double> sumX;
+		std::vector<double> sumY;
+		std::vector<double> sumZ;
+		std::vector<int32_t> counts;
+
+		for (int32_t i = 0; i < numVertices; ++i)
+		{
+			const uint64_t key = CellKey(source.X[i], source.Y[i], source.Z[i], boundsMin, inverseCellSize);
+			std::unordered_map<uint64_t, int32_t>::iterator cell = cells.find(key);
+			if (cell == cells.end())
+			{
+				cell = cells.insert(std::make_pair(key, static_cast<int32_t>(counts.size()))).first;
+				sumX.push_back(0.0);
+				sumY.push_back(0.0);
+				sumZ.push_back(0.0);
+				counts.push_back(0);
+			}
+
+			const int32_t cellIndex = cell->second;
+			vertexCell[i] = cellIndex;
+			sumX[cellIndex] += source.X[i];
+			sumY[cellIndex] += source.Y[i];
+			sumZ[cellIndex] += source.Z[i];
+			++counts[cellIndex];
+		}
+
+		outHull = FHullData();
+		std::vector<int32_t> cellVertex(counts.size(), -1);
+		for (int32_t tri = 0; tri < source.NumTriangles(); ++tri)
+		{
+			int32_t corners[3];
+			for (int32_t corner = 0; corner < 3; ++corner)
+			{
+				corners[corner] = vertexCell[source.Indices[(tri * 3) + corner]];
+			}
+
+			if ((corners[0] == corners[1]) || (corners[1] == corners[2]) || (corners[2] == corners[0]))
+			{
+				continue;
+			}
+
+			// Only cells still referenced by a triangle become vertices.
+			for (int32_t corner = 0; corner < 3; ++corner)
+			{
+				const int32_t cellIndex = corners[corner];
+				if (cellVertex[cellIndex] < 0)
+				{
+					cellVertex[cellIndex] = outHull.NumVertices();
+					outHull.X.push_back(static_cast<float>(sumX[cellIndex] / counts[cellIndex]));
+					outHull.Y.push_back(static_cast<float>(sumY[cellIndex] / counts[cellIndex]));
+					outHull.Z.push_back(static_cast<float>(sumZ[cellIndex] / counts[cellIndex]));
+				}
+				outHull.Indices.push_back(cellVertex[cellIndex]);
+			}
+		}
+	}
+
+	void SimplifyHull(const FHullData& source, int32_t targetTriangles, FHullData& outHull)
+	{
+		if ((source.NumTriangles() <= targetTriangles) || (source.NumVertices() == 0))
+		{
+			outHull = source;
+			return;
+		}
+
+		float boundsMin[3] = { source.X[0], source.Y[0], source.Z[0] };
+		float boundsMax[3] = { source.X[0], source.Y[0], source.Z[0] };
+		for (int32_t i = 1; i < source.NumVertices(); ++i)
+		{
+			boundsMin[0] = std::min(boundsMin[0], source.X[i]);
+			boundsMin[1] = std::min(boundsMin[1], source.Y[i]);
+			boundsMin[2] = std::min(boundsMin[2], source.Z[i]);
+			boundsMax[0] = std::max(boundsMax[0], source.X[i]);
+			boundsMax[1] = std::max(boundsMax[1], source.Y[i]);
+			boundsMax[2] = std::max(boundsMax[2], source.Z[i]);
+		}
+
+		const float extent = std::max(boundsMax[0] - boundsMin[0], std::max(boundsMax[1] - boundsMin[1], boundsMax[2] - boundsMin[2]));
+
+		// Bisect the cell size in log space for the densest grid that still fits the budget.
+		float smallCell = extent / 4096.0f;
+		float largeCell = extent;
+		bool bFoundFit = false;
+		FHullData candidate;
+		for (int32_t iteration = 0; iteration < SimplifierIterations; ++iteration)
+		{
+			const float cellSize = std::sqrt(smallCell * largeCell);
+			ClusterVertices(source, boundsMin, cellSize, candidate);
+
+			if ((candidate.NumTriangles() <= targetTriangles) && (candidate.NumTriangles() > 0))
+			{
+				if (!bFoundFit || (candidate.NumTriangles() > outHull.NumTriangles()))
+				{
+					outHull = candidate;
+					bFoundFit = true;
+				}
+				largeCell = cellSize;
+			}
+			else if (candidate.NumTriangles() == 0)
+			{
+				largeCell = cellSize;
+			}
+			else
+			{
+				smallCell = cellSize;
+			}
+		}
+
+		if (!bFoundFit)
+		{
+			outHull = source;
+			return;
+		}
+
+		// Scale horizontally to restore the footprint, then vertically to restore the displaced volume. The vertical
+		// scale pivots about the keel of the full hull, so the bottom stays put and a LOD switch keeps the draft.
+		const float pivot[3] = { 0.5f * (boundsMin[0] + boundsMax[0]), 0.5f * (boundsMin[1] + boundsMax[1]), boundsMin[2] };
+
+		const float sourceFootprint = HullFootprintArea(source);
+		const float lodFootprint = HullFootprintArea(outHull);
+		const float horizontalScale = ((sourceFootprint > 0.0f) && (lodFootprint > 0.0f)) ? std::sqrt(sourceFootprint / lodFootprint) : 1.0f;
+
+		const float sourceVolume = HullVolume(source);
+		const float lodVolume = HullVolume(outHull) * horizontalScale * horizontalScale;
+		const float verticalScale = ((sourceVolume > 0.0f) && (lodVolume > 0.0f)) ? (sourceVolume / lodVolume) : 1.0f;
+
+		for (int32_t i = 0; i < outHull.NumVertices(); ++i)
+		{
+			outHull.X[i] = pivot[0] + ((outHull.X[i] - pivot[0]) * horizontalScale);
+			outHull.Y[i] = pivot[1] + ((outHull.Y[i] - pivot[1]) * horizontalScale);
+			outHull.Z[i] = pivot[2] + ((outHull.Z[i] - pivot[2]) * verticalScale);
+		}
+
+		// The buoyancy length of the coarse hull stays the one of the full hull.
+		const float lengthOfBoat = source.LengthOfBoat;
+		FinalizeHullData(outHull);
+		outHull.LengthOfBoat = lengthOfBoat;
+	}
+}
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullData.h"
+
+namespace HullKernel
+{
+	// Number of buoyancy LODs built per hull, LOD 0 being the full collision hull.
+	static const int32_t HullLODCount = 4;
+
+	// Triangle budget of a LOD: a quarter of the previous one, down to a few dozen triangles for the last.
+	int32_t HullLODTargetTriangles(int32_t sourceTriangles, int32_t lod);
+
+	/**
+	 * Decimates the source hull down to at most targetTriangles by clustering vertices on a uniform grid.
+	 * The result is then scaled so that its displaced volume and waterplane (bottom footprint) area match the source,
+	 * which keeps the buoyancy and the resting draft of the coarse hull close to the full one.
+	 */
+	void SimplifyHull(const FHullData& source, int32_t targetTriangles, FHullData& outHull);
+
+	// Absolute enclosed volume in cm3, only meaningful for closed hulls.
+	float HullVolume(const FHullData& hull);
+
+	// Area in cm2 of the hull projected on the horizontal plane from below.
+	float HullFootprintArea(const FHullData& hull);
+}
@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "VertexTransform.h"
+#include "HullForceKernel.h"
+
+#include <cstring>
+
+#if HULLKERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace HullKernel
+{
+	bool operator==(const FAffineTransform& a, const FAffineTransform& b)
+	{
+		return std::memcmp(a.M, b.M, sizeof(a.M)) == 0;
+	}
+
+	namespace
+	{
+		void TransformScalar(const FAffineTransform& t, const float* x, const float* y, const float* z, int32_t begin, int32_t count,
+			float* outX, float* outY, float* outZ)
+		{
+			for (int32_t i = begin; i < count; ++i)
+			{
+				const float localX = x[i];
+				const float localY = y[i];
+				const float localZ = z[i];
+				outX[i] = (((t.M[0][0] * localX) + (t.M[0][1] * localY)) + (t.M[0][2] * localZ)) + t.M[0][3];
+				outY[i] = (((t.M[1][0] * localX) + (t.M[1][1] * localY)) + (t.M[1][2] * localZ)) + t.M[1][3];
+				outZ[i] = (((t.M[2][0] * localX) + (t.M[2][1] * localY)) + (t.M[2][2] * localZ)) + t.M[2][3];
+			}
+		}
+
+#if HULLKERNEL_X86
+		int32_t TransformSSE(const FAffineTransform& t, const float* x, const float* y, const float* z, int32_t count,
+			float* outX, float* outY, float* outZ)
+		{
+			__m128 m[3][4];
+			for (int32_t row = 0; row < 3; ++row)
+			{
+				for (int32_t column = 0; column < 4; ++column)
+				{
+					m[row][column] = _mm_set1_ps(t.M[row][column]);
+				}
+			}
+
+			int32_t i = 0;
+			for (; (i + 4) <= count; i += 4)
+			{
+				const __m128 localX = _mm_loadu_ps(x + i);
+				const __m128 localY = _mm_loadu_ps(y + i);
+				const __m128 localZ = _mm_loadu_ps(z + i);
+				float* out[3] = { outX, outY, outZ };
+				for (int32_t row = 0; row < 3; ++row)
+				{
+					const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[row][0], localX), _mm_mul_ps(m[row][1], localY)), _mm_mul_ps(m[row][2], localZ));
+					_mm_storeu_ps(out[row] + i, _mm_add_ps(sum, m[row][3]));
+				}
+			}
+			return i;
+		}
+
+		// Only this function is compiled for AVX2, the dispatcher checks the CPU before calling into it.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+		int32_t TransformAVX2(const FAffineTransform& t, const float* x, const float* y, const float* z, int32_t count,
+			float* outX, float* outY, float* outZ)
+		{
+			__m256 m[3][4];
+			for (int32_t row = 0; row < 3; ++row)
+			{
+				for (int32_t column = 0; column < 4; ++column)
+				{
+					m[row][column] = _mm256_set1_ps(t.M[row][column]);
+				}
+			}
+
+			int32_t i = 0;
+			for (; (i + 8) <= count; i += 8)
+			{
+				const __m256 localX = _mm256_loadu_ps(x + i);
+				const __m256 localY = _mm256_loadu_ps(y + i);
+				const __m256 localZ = _mm256_loadu_ps(z + i);
+				float* out[3] = { outX, outY, outZ };
+				for (int32_t row = 0; row < 3; ++row)
+				{
+					const __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[row][0], localX), _mm256_mul_ps(m[row][1], localY)), _mm256_mul_ps(m[row][2], localZ));
+					_mm256_storeu_ps(out[row] + i, _mm256_add_ps(sum, m[row][3]));
+				}
+			}
+			return i;
+		}
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+#endif
+	}
+
+	void TransformVertices(const FAffineTransform& transform, const float* x, const float* y, const float* z, int32_t count,
+		float* outX, float* outY, float* outZ, EKernelPath path)
+	{
+		// Never run a wider path than the CPU supports.
+		const EKernelPath bestPath = DetectKernelPath();
+		if ((path == EKernelPath::Auto) || (static_cast<uint8_t>(path) > static_cast<uint8_t>(bestPath)))
+		{
+			path = bestPath;
+		}
+
+		// The wide paths leave the last few vertices to the scalar loop.
+		int32_t done = 0;
+		switch (path)
+		{
+#if HULLKERNEL_X86
+		case EKernelPath::AVX2:
+			done = TransformAVX2(transform, x, y, z, count, outX, outY, outZ);
+			break;
+		case EKernelPath::SSE:
+			done = TransformSSE(transform, x, y, z, count, outX, outY, outZ);
+			break;
+#endif
+		default:
+			break;
+		}
+
+		TransformScalar(transform, x, y, z, done, count, outX, outY, outZ);
+	}
+}
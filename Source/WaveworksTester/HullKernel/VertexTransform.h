@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernelTypes.h"
+
+namespace HullKernel
+{
+	// Rotation, scale and translation as the top three rows of a 4x4 matrix, world = M * (local, 1).
+	struct FAffineTransform
+	{
+		float M[3][4];
+	};
+
+	// Exact comparison, used to tell whether a body moved at all since the last tick.
+	bool operator==(const FAffineTransform& a, const FAffineTransform& b);
+	inline bool operator!=(const FAffineTransform& a, const FAffineTransform& b) { return !(a == b); }
+
+	/**
+	 * Transforms count structure-of-arrays vertices in one pass, 4 or 8 at a time with SSE or AVX2.
+	 * Every path sums the products in the same order, so they agree with each other.
+	 */
+	void TransformVertices(const FAffineTransform& transform, const float* x, const float* y, const float* z, int32_t count,
+		float* outX, float* outY, float* outZ, EKernelPath path = EKernelPath::Auto);
+}
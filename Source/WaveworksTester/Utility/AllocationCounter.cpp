@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "AllocationCounter.h"
+
+namespace
+{
+	// Only touched on the game thread.
+	int32 ScopeDepth = 0;
+	uint64 AllocationCount = 0;
+
+	class FCountingMalloc : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* inner) :
+			mInner(inner)
+		{
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return mInner->Malloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			// Shrinking to nothing is a free, everything else may move the block.
+			if (Count != 0)
+			{
+				CountAllocation();
+			}
+			return mInner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			mInner->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return mInner->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return mInner->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim() override
+		{
+			mInner->Trim();
+		}
+
+		virtual void SetupTLSCachesOnCurrentThread() override
+		{
+			mInner->SetupTLSCachesOnCurrentThread();
+		}
+
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+		{
+			mInner->ClearAndDisableTLSCachesOnCurrentThread();
+		}
+
+		virtual void InitializeStatsMetadata() override
+		{
+			mInner->InitializeStatsMetadata();
+		}
+
+		virtual void UpdateStats() override
+		{
+			mInner->UpdateStats();
+		}
+
+		virtual void GetAllocatorStats(FGenericMemoryStats& out_Stats) override
+		{
+			mInner->GetAllocatorStats(out_Stats);
+		}
+
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+		{
+			mInner->DumpAllocatorStats(Ar);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return mInner->IsInternallyThreadSafe();
+		}
+
+		virtual bool ValidateHeap() override
+		{
+			return mInner->ValidateHeap();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return mInner->GetDescriptiveName();
+		}
+
+	private:
+		void CountAllocation()
+		{
+			if (IsInGameThread() && (ScopeDepth > 0))
+			{
+				++AllocationCount;
+			}
+		}
+
+		FMalloc* mInner;
+	};
+
+	FCountingMalloc* CountingMalloc = nullptr;
+}
+
+void FAllocationCounter::Install()
+{
+	check(IsInGameThread());
+
+	if (!CountingMalloc)
+	{
+		// Never removed, blocks from before and after keep going through it to the same allocator.
+		CountingMalloc = new FCountingMalloc(GMalloc);
+		GMalloc = CountingMalloc;
+	}
+}
+
+bool FAllocationCounter::IsInstalled()
+{
+	return CountingMalloc != nullptr;
+}
+
+uint64 FAllocationCounter::Count()
+{
+	return AllocationCount;
+}
+
+FAllocationCounter::FScope::FScope()
+{
+	if (IsInGameThread())
+	{
+		++ScopeDepth;
+	}
+}
+
+FAllocationCounter::FScope::~FScope()
+{
+	if (IsInGameThread())
+	{
+		--ScopeDepth;
+	}
+}
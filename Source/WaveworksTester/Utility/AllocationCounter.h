@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+ * Counts the heap allocations the game thread makes inside an FAllocationCounter::FScope, to check that a hot path
+ * stays allocation free once warmed up. Works by putting a forwarding allocator in front of GMalloc the first time
+ * it is installed, which only costs a branch per allocation afterwards.
+ * Worker threads are not counted, the code they run has to be allocation free by construction.
+ */
+class WAVEWORKSTESTER_API FAllocationCounter
+{
+public:
+	// Game thread only. Installing more than once is harmless.
+	static void Install();
+
+	static bool IsInstalled();
+
+	// Allocations and reallocations made inside scopes so far.
+	static uint64 Count();
+
+	class WAVEWORKSTESTER_API FScope
+	{
+	public:
+		FScope();
+		~FScope();
+	};
+};
@@ -0,0 +1,174 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "BuoyancyCapture.h"
+
+namespace
+{
+	const int32 DefaultCaptureFrames = 600;
+
+	// Taken by the physics thread for every step while capturing, and by the game thread to start and stop.
+	FCriticalSection CaptureLock;
+	HullKernel::FHullCaptureWriter Writer;
+	FThreadSafeBool bCapturing;
+
+	// Hulls already in the file, kept alive so their address is not reused by another hull during the capture.
+	TMap<const HullKernel::FHullData*, uint32> HullIds;
+	TArray<TSharedPtr<const HullKernel::FHullData>> Hulls;
+	TSet<int32> Boats;
+	uint32 NumSteps = 0;
+
+	FString CapturePath;
+	uint64 StartFrame = 0;
+	int32 CaptureFrames = 0;
+	FDelegateHandle TickerHandle;
+
+	bool TickCapture(float DeltaTime)
+	{
+		if (!bCapturing)
+		{
+			TickerHandle.Reset();
+			return false;
+		}
+
+		if ((GFrameCounter - StartFrame) >= static_cast<uint64>(CaptureFrames))
+		{
+			// Returning false removes the ticker, Stop must not remove it a second time.
+			TickerHandle.Reset();
+			FBuoyancyCapture::Stop();
+			return false;
+		}
+		return true;
+	}
+
+	void StartFromConsole(const TArray<FString>& args)
+	{
+		if (args.Num() < 1)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("BuoyancyCapture: Usage buoyancy.Capture <file> [frames]"));
+			return;
+		}
+		FBuoyancyCapture::Start(args[0], (args.Num() > 1) ? FCString::Atoi(*args[1]) : DefaultCaptureFrames);
+	}
+
+	FAutoConsoleCommand CaptureCommand(
+		TEXT("buoyancy.Capture"),
+		TEXT("buoyancy.Capture <file> [frames]: Records the inputs and forces of every hull kernel evaluation for frames frames (600), relative to Saved, for Benchmark/HullReplay."),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&StartFromConsole));
+
+	FAutoConsoleCommand CaptureStopCommand(
+		TEXT("buoyancy.CaptureStop"),
+		TEXT("Ends the buoyancy capture early."),
+		FConsoleCommandDelegate::CreateStatic(&FBuoyancyCapture::Stop));
+}
+
+void FBuoyancyCapture::Start(const FString& path, int32 frames)
+{
+	check(IsInGameThread());
+
+	Stop();
+
+	CapturePath = FPaths::IsRelative(path) ? FPaths::Combine(*FPaths::GameSavedDir(), *path) : path;
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(CapturePath), true);
+
+	FScopeLock lock(&CaptureLock);
+	if (!Writer.Open(TCHAR_TO_UTF8(*CapturePath), HullKernel::DetectKernelPath()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BuoyancyCapture: Could not open %s."), *CapturePath);
+		return;
+	}
+
+	CaptureFrames = FMath::Max(frames, 1);
+	StartFrame = GFrameCounter;
+	NumSteps = 0;
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&TickCapture));
+	bCapturing = true;
+
+	UE_LOG(LogTemp, Log, TEXT("BuoyancyCapture: Capturing %d frames to %s."), CaptureFrames, *CapturePath);
+}
+
+void FBuoyancyCapture::Stop()
+{
+	check(IsInGameThread());
+
+	if (!bCapturing)
+	{
+		return;
+	}
+
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	// Waits for a step the physics thread may be writing.
+	FScopeLock lock(&CaptureLock);
+	bCapturing = false;
+
+	const uint64 bytes = Writer.BytesWritten();
+	const bool bWritten = Writer.Close();
+	const uint64 frames = FMath::Max<uint64>(GFrameCounter - StartFrame, 1);
+	if (bWritten)
+	{
+		UE_LOG(LogTemp, Log, TEXT("BuoyancyCapture: Wrote %u steps of %d boats over %llu frames, %.1f MB, to %s."),
+			NumSteps, Boats.Num(), frames, bytes / (1024.0 * 1024.0), *CapturePath);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BuoyancyCapture: Writing %s failed, the capture is incomplete."), *CapturePath);
+	}
+
+	HullIds.Empty();
+	Hulls.Empty();
+	Boats.Empty();
+}
+
+bool FBuoyancyCapture::IsCapturing()
+{
+	return bCapturing;
+}
+
+void FBuoyancyCapture::RecordStep(int32 boat, const AActor* owner, const TSharedPtr<const HullKernel::FHullData>& hull, double time,
+	const HullKernel::FAffineTransform& transform, const HullKernel::FHullJob& job, const HullKernel::FKernelSummary& summary, bool bChunked)
+{
+	FScopeLock lock(&CaptureLock);
+	if (!bCapturing)
+	{
+		return;
+	}
+
+	// The slamming history a boat's first step started from was written before the capture, the replay starts from
+	// the history that step left instead.
+	const bool bFirstStep = !Boats.Contains(boat);
+	if (bFirstStep)
+	{
+		Boats.Add(boat);
+		Writer.WriteBody(static_cast<uint32>(boat), TCHAR_TO_UTF8(owner ? *owner->GetName() : TEXT("")));
+	}
+
+	const uint32* hullId = HullIds.Find(hull.Get());
+	if (!hullId)
+	{
+		hullId = &HullIds.Add(hull.Get(), static_cast<uint32>(Hulls.Add(hull)));
+		Writer.WriteHull(*hullId, *hull);
+	}
+
+	HullKernel::FCaptureStep step = {};
+	step.Time = time;
+	step.Body = static_cast<uint32>(boat);
+	step.Hull = *hullId;
+	step.Transform = transform;
+	step.BodyState = job.Body;
+	step.Coefficients = job.Coefficients;
+	step.NumVertices = job.Hull.NumVertices;
+	step.Flags = (bChunked ? HullKernel::CaptureStepChunked : 0) | (bFirstStep ? HullKernel::CaptureStepSeed : 0);
+	step.Summary = summary;
+	Writer.WriteStep(step, job.WaterHeights);
+	++NumSteps;
+
+	if (bFirstStep)
+	{
+		Writer.WriteHistory(step.Body, job.Out, job.Hull.NumTriangles);
+	}
+}
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernel/HullCapture.h"
+#include "HullKernel/HullForceBatch.h"
+
+/**
+ * Records the transform, water heights and body state every boat's hull kernel ran with, and the forces it returned,
+ * into a chunked binary capture that Benchmark/HullReplay replays headless to check for divergence and to time it.
+ *   buoyancy.Capture <file> [frames]   starts a capture that stops by itself after frames frames, 600 by default.
+ *   buoyancy.CaptureStop               ends it early.
+ * Relative paths are under Saved. The steps are streamed to the file as they are evaluated, boats whose Include In
+ * Capture is off are left out. Outside a capture a step costs one flag check.
+ */
+class WAVEWORKSTESTER_API FBuoyancyCapture
+{
+public:
+	// Game thread.
+	static void Start(const FString& path, int32 frames);
+	static void Stop();
+
+	static bool IsCapturing();
+
+	// Any thread. One evaluation of boat, with the hull and transform its vertices were computed from.
+	static void RecordStep(int32 boat, const AActor* owner, const TSharedPtr<const HullKernel::FHullData>& hull, double time,
+		const HullKernel::FAffineTransform& transform, const HullKernel::FHullJob& job, const HullKernel::FKernelSummary& summary, bool bChunked);
+};
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "BuoyancyDebugDraw.h"
+
+static TAutoConsoleVariable<int32> CVarDrawMesh(
+	TEXT("buoyancy.DrawMesh"),
+	0,
+	TEXT("Draws the triangles and normals of every floating hull."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<int32> CVarDrawProjection(
+	TEXT("buoyancy.DrawProjection"),
+	0,
+	TEXT("Draws the submerged triangles of every floating hull projected onto the water."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<int32> CVarDrawForces(
+	TEXT("buoyancy.DrawForces"),
+	0,
+	TEXT("Draws the hydrostatic (red), viscous (green), pressure drag (blue) and slamming (magenta) force of every triangle."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<int32> CVarDrawSubmersion(
+	TEXT("buoyancy.DrawSubmersion"),
+	0,
+	TEXT("Draws the triangles in the water, one vertex under in yellow, two in orange, fully submerged in cyan."),
+	ECVF_Cheat);
+
+uint32 FBuoyancyDebugDraw::EnabledViews()
+{
+#if ENABLE_DRAW_DEBUG
+	return ((CVarDrawMesh.GetValueOnGameThread() != 0) ? ViewMesh : 0)
+		| ((CVarDrawProjection.GetValueOnGameThread() != 0) ? ViewProjection : 0)
+		| ((CVarDrawForces.GetValueOnGameThread() != 0) ? ViewForces : 0)
+		| ((CVarDrawSubmersion.GetValueOnGameThread() != 0) ? ViewSubmersion : 0);
+#else
+	return 0;
+#endif
+}
+
+void FBuoyancyDebugDraw::Reset()
+{
+	mLines.Reset();
+}
+
+void FBuoyancyDebugDraw::AddLine(const FVector& start, const FVector& end, const FColor& color, float thickness)
+{
+	// No lifetime, the world flushes its line batcher every frame.
+	mLines.Emplace(start, end, FLinearColor(color), 0.0f, thickness, SDPG_World);
+}
+
+void FBuoyancyDebugDraw::Submit(UWorld* world)
+{
+	if ((mLines.Num() > 0) && world && world->LineBatcher)
+	{
+		world->LineBatcher->DrawLines(mLines);
+	}
+}
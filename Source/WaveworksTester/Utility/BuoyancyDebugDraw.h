@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Components/LineBatchComponent.h"
+
+/**
+ * Debug views of the floating hulls, switched at runtime and drawn as one batch of lines per world and frame.
+ *   buoyancy.DrawMesh 1         triangles and normals of the hull.
+ *   buoyancy.DrawProjection 1   submerged triangles projected onto the water.
+ *   buoyancy.DrawForces 1       hydrostatic, viscous, pressure drag and slamming force of every triangle.
+ *   buoyancy.DrawSubmersion 1   triangles in the water, coloured by how many of their vertices are under.
+ * With every view off the scheduler skips debug drawing after one test, and builds without debug drawing compile
+ * it out. The per term forces are only kept while buoyancy.DrawForces is on.
+ */
+class WAVEWORKSTESTER_API FBuoyancyDebugDraw
+{
+public:
+	static const uint32 ViewMesh = 1 << 0;
+	static const uint32 ViewProjection = 1 << 1;
+	static const uint32 ViewForces = 1 << 2;
+	static const uint32 ViewSubmersion = 1 << 3;
+
+	// Game thread. The views the console variables enable, 0 when none or without debug drawing.
+	static uint32 EnabledViews();
+
+	// Starts the lines of a new frame, keeping the memory of the last ones.
+	void Reset();
+
+	void AddLine(const FVector& start, const FVector& end, const FColor& color, float thickness);
+
+	// Hands the lines to the world's line batcher, which draws them for one frame.
+	void Submit(UWorld* world);
+
+private:
+	TArray<FBatchedLine> mLines;
+};
@@ -0,0 +1,242 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "BuoyancyScheduler.h"
+#include "AllocationCounter.h"
+#include "BuoyancyDebugDraw.h"
+#include "BuoyancyStats.h"
+#include "CustomComponents/WaterPhysicsComponent.h"
+
+#include "Async/ParallelFor.h"
+
+static TAutoConsoleVariable<int32> CVarCountAllocations(
+	TEXT("buoyancy.CountAllocations"),
+	0,
+	TEXT("Logs every frame in which buoyancy allocated on the game thread. Debug drawing and the task setup are not counted."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<float> CVarStepRate(
+	TEXT("buoyancy.StepRate"),
+	0.0f,
+	TEXT("Most buoyancy evaluations per second, the forces are held in between. 0 evaluates every physics step."),
+	ECVF_Default);
+
+TMap<TWeakObjectPtr<UWorld>, TSharedPtr<FBuoyancyScheduler>> FBuoyancyScheduler::Schedulers;
+
+FBuoyancyScheduler* FBuoyancyScheduler::Register(UWaterPhysicsComponent* component)
+{
+	check(IsInGameThread());
+
+	// Forget the schedulers of worlds that were torn down without their components leaving first.
+	for (auto it = Schedulers.CreateIterator(); it; ++it)
+	{
+		if (!it.Key().IsValid())
+		{
+			it.RemoveCurrent();
+		}
+	}
+
+	UWorld* world = component->GetWorld();
+	TSharedPtr<FBuoyancyScheduler>& scheduler = Schedulers.FindOrAdd(world);
+	if (!scheduler.IsValid())
+	{
+		scheduler = MakeShareable(new FBuoyancyScheduler(world));
+	}
+	scheduler->mComponents.AddUnique(component);
+	return scheduler.Get();
+}
+
+void FBuoyancyScheduler::Unregister(UWaterPhysicsComponent* component)
+{
+	check(IsInGameThread());
+
+	TSharedPtr<FBuoyancyScheduler>* scheduler = Schedulers.Find(component->GetWorld());
+	if (scheduler)
+	{
+		// Also from this frame's steps, which other boats' physics callbacks may still run after it left.
+		(*scheduler)->mComponents.Remove(component);
+		(*scheduler)->mSteppedComponents.Remove(component);
+		if ((*scheduler)->mComponents.Num() == 0)
+		{
+			Schedulers.Remove(component->GetWorld());
+		}
+	}
+}
+
+FBuoyancyScheduler::FBuoyancyScheduler(UWorld* world) :
+	mPhysicsSteps(0), mStepTime(0.0), mStepInterval(0.0f), mTimeSinceEvaluation(0.0f), mAllocationsBefore(0), mDebugViews(0)
+{
+	// Before physics, so the custom physics callbacks are in place when the scene steps.
+	mTickFunction.Scheduler = this;
+	mTickFunction.bCanEverTick = true;
+	mTickFunction.TickGroup = TG_PrePhysics;
+	mTickFunction.RegisterTickFunction(world->PersistentLevel);
+}
+
+void FBuoyancyScheduler::Tick(float DeltaTime)
+{
+	BUOYANCY_SCOPE(SchedulerTick, INDEX_NONE);
+
+	// Covers this tick and the physics steps of the last frame when they ran on the game thread.
+	if (CVarCountAllocations.GetValueOnGameThread() != 0)
+	{
+		FAllocationCounter::Install();
+
+		// The arrays only grow while boats are added or switch LOD, any later allocation is a regression.
+		const uint64 allocations = FAllocationCounter::Count() - mAllocationsBefore;
+		if (allocations > 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("BuoyancyScheduler: %llu heap allocations last frame for %d hulls."), allocations, mComponents.Num());
+		}
+	}
+	mAllocationsBefore = FAllocationCounter::Count();
+
+	// Debug lines of the last frame's steps, now that physics is done with the buffers. Also runs the frame the views
+	// are switched off, to free the per term forces that only the force view needs.
+	const uint32 debugViews = FBuoyancyDebugDraw::EnabledViews();
+	if ((debugViews | mDebugViews) != 0)
+	{
+		const bool bForceTerms = (debugViews & FBuoyancyDebugDraw::ViewForces) != 0;
+		mDebugDraw.Reset();
+		for (UWaterPhysicsComponent* component : mComponents)
+		{
+			if (component->mTriForces.HasForceTerms() != bForceTerms)
+			{
+				component->mTriForces.SetForceTerms(bForceTerms);
+			}
+			if (debugViews != 0)
+			{
+				component->DrawHullDebug(debugViews, mDebugDraw);
+			}
+		}
+		mDebugDraw.Submit(mComponents[0]->GetWorld());
+		mDebugViews = debugViews;
+	}
+
+	FAllocationCounter::FScope countAllocations;
+
+	// The world clock already moved on to the end of the frame physics is about to simulate.
+	const UWorld* world = mComponents[0]->GetWorld();
+	const double time = world->GetTimeSeconds();
+	mStepTime = time - DeltaTime;
+	mPhysicsSteps = 0;
+
+	const float stepRate = CVarStepRate.GetValueOnGameThread();
+	mStepInterval = (stepRate > 0.0f) ? (1.0f / stepRate) : 0.0f;
+
+	// LODs, sleep and water samples of every hull, then a callback into each simulated body's physics steps.
+	mSteppedComponents.Reset();
+	for (UWaterPhysicsComponent* component : mComponents)
+	{
+		if (component->PrepareFrame(time))
+		{
+			mSteppedComponents.Add(component);
+			component->mMeshComponent->GetBodyInstance()->AddCustomPhysics(component->mOnPhysicsStep);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_BuoyancyHullsStepped, mSteppedComponents.Num());
+	INC_DWORD_STAT_BY(STAT_BuoyancyHullsAsleep, mComponents.Num() - mSteppedComponents.Num());
+}
+
+void FBuoyancyScheduler::OnPhysicsStep(UWaterPhysicsComponent* component, float DeltaTime, FBodyInstance* body)
+{
+	// Every simulated boat gets one callback per step, whichever comes first evaluates the step for all of them.
+	if (component->mPhysicsSteps == mPhysicsSteps)
+	{
+		EvaluateStep(DeltaTime);
+		++mPhysicsSteps;
+	}
+	++component->mPhysicsSteps;
+
+	component->ApplyStep(body);
+}
+
+void FBuoyancyScheduler::EvaluateStep(float DeltaTime)
+{
+	mStepTime += DeltaTime;
+	mTimeSinceEvaluation += DeltaTime;
+	if (mTimeSinceEvaluation < mStepInterval)
+	{
+		return;
+	}
+
+	// Never catch up on evaluations that were skipped, e.g. after a hitch.
+	mTimeSinceEvaluation -= mStepInterval;
+	if (mTimeSinceEvaluation >= mStepInterval)
+	{
+		mTimeSinceEvaluation = 0.0f;
+	}
+
+	BUOYANCY_SCOPE(Step, INDEX_NONE);
+	INC_DWORD_STAT(STAT_BuoyancyEvaluations);
+
+	// Pose and water heights of every hull at this step.
+	{
+		FAllocationCounter::FScope countAllocations;
+
+		mJobs.Reset();
+		mJobComponents.Reset();
+		for (UWaterPhysicsComponent* component : mSteppedComponents)
+		{
+			const FBodyInstance* body = component->mMeshComponent->GetBodyInstance();
+
+			HullKernel::FHullJob job;
+			if (component->PrepareStep(mStepTime, body->GetUnrealWorldTransform_AssumesLocked(), body->GetUnrealWorldVelocity_AssumesLocked(), body->GetUnrealWorldAngularVelocity_AssumesLocked(), job))
+			{
+				mJobs.Add(job);
+				mJobComponents.Add(component);
+			}
+		}
+
+		const int32 numChunks = HullKernel::CountHullChunks(mJobs.GetData(), mJobs.Num());
+		mChunks.SetNumUninitialized(numChunks, false);
+		mChunkSummaries.SetNumUninitialized(numChunks, false);
+		HullKernel::BuildHullChunks(mJobs.GetData(), mJobs.Num(), mChunks.GetData());
+	}
+
+	// The task graph hands the chunks out one at a time, whichever thread is free takes the next one.
+	// The calling thread takes chunks as well, once it runs out it waits for the last ones to finish.
+	const uint32 stepThread = FPlatformTLS::GetCurrentThreadId();
+	uint64 stepThreadIdle = FPlatformTime::Cycles64();
+	ParallelFor(mChunks.Num(), [this, stepThread, &stepThreadIdle](int32 chunk)
+	{
+		const HullKernel::FHullChunk& hullChunk = mChunks[chunk];
+		{
+			BUOYANCY_SCOPE(HullKernel, mJobComponents[hullChunk.Job]->mTraceId);
+			HullKernel::ComputeHullChunk(mJobs.GetData(), hullChunk, mChunkSummaries[chunk]);
+		}
+
+		if (FPlatformTLS::GetCurrentThreadId() == stepThread)
+		{
+			stepThreadIdle = FPlatformTime::Cycles64();
+		}
+	});
+
+	const uint64 joined = FPlatformTime::Cycles64();
+	INC_FLOAT_STAT_BY(STAT_BuoyancyChunkWait, (joined - stepThreadIdle) * FPlatformTime::GetSecondsPerCycle64() * 1000.0);
+	FBuoyancyTrace::AddEvent(EBuoyancyStage::ChunkWait, INDEX_NONE, stepThreadIdle, joined);
+
+	{
+		FAllocationCounter::FScope countAllocations;
+
+		const int32 numJobs = mJobs.Num();
+		mJobSummaries.SetNumUninitialized(numJobs, false);
+		HullKernel::ReduceHullChunks(mChunks.GetData(), mChunkSummaries.GetData(), mChunks.Num(), mJobSummaries.GetData(), numJobs);
+
+		for (int32 job = 0; job < numJobs; ++job)
+		{
+			mJobComponents[job]->FinishStep(mStepTime, mJobs[job], mJobSummaries[job], true);
+		}
+	}
+}
+
+void FBuoyancyScheduler::FSchedulerTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	Scheduler->Tick(DeltaTime);
+}
+
+FString FBuoyancyScheduler::FSchedulerTickFunction::DiagnosticMessage()
+{
+	return TEXT("FBuoyancyScheduler");
+}
@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Engine/EngineBaseTypes.h"
+#include "HullKernel/HullForceBatch.h"
+#include "BuoyancyDebugDraw.h"
+
+class UWaterPhysicsComponent;
+
+/**
+ * Computes the buoyancy of every floating hull of a world in one parallel pass instead of one component tick each.
+ * The hulls are cut into fixed size triangle chunks that the task graph threads pick up as they become free, so a
+ * large boat is spread over every core and many small ones do not leave cores idle.
+ * Each chunk sums into its own accumulator and the chunks are added up in a fixed order afterwards,
+ * so the forces do not depend on the number of threads or on which thread ran which chunk.
+ *
+ * The pass runs inside the physics steps, from the custom physics callbacks of the boats, with the pose PhysX is at
+ * and the water heights interpolated to the time of the step. With physics substepping on, the boats get a fresh
+ * evaluation every substep whatever the frame rate. buoyancy.StepRate caps the evaluations per second, the forces are
+ * held in between, so a server can step buoyancy at a lower rate than a client renders at.
+ */
+class WAVEWORKSTESTER_API FBuoyancyScheduler
+{
+public:
+	// Game thread only. The component is ticked by the scheduler until it unregisters.
+	static FBuoyancyScheduler* Register(UWaterPhysicsComponent* component);
+
+	static void Unregister(UWaterPhysicsComponent* component);
+
+	explicit FBuoyancyScheduler(UWorld* world);
+
+	// Game thread, before physics.
+	void Tick(float DeltaTime);
+
+	// From the custom physics callback of every simulated boat, once per physics step.
+	void OnPhysicsStep(UWaterPhysicsComponent* component, float DeltaTime, FBodyInstance* body);
+
+private:
+	struct FSchedulerTickFunction : public FTickFunction
+	{
+		FBuoyancyScheduler* Scheduler;
+
+		virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+		virtual FString DiagnosticMessage() override;
+	};
+
+	// Evaluates the forces of every simulated boat at the start of a physics step, unless the step rate holds them.
+	void EvaluateStep(float DeltaTime);
+
+	static TMap<TWeakObjectPtr<UWorld>, TSharedPtr<FBuoyancyScheduler>> Schedulers;
+
+	// In registration order, which fixes the order the forces are summed in.
+	TArray<UWaterPhysicsComponent*> mComponents;
+
+	// Boats PhysX simulates this frame, the rest sleep.
+	TArray<UWaterPhysicsComponent*> mSteppedComponents;
+
+	FSchedulerTickFunction mTickFunction;
+
+	// Physics steps started this frame, and the time the next one ends at.
+	int32 mPhysicsSteps;
+	double mStepTime;
+
+	// Read on the game thread, the physics steps use the value of their frame.
+	float mStepInterval;
+	float mTimeSinceEvaluation;
+
+	uint64 mAllocationsBefore;
+
+	// Views drawn last frame, and the lines of every boat, kept from frame to frame.
+	uint32 mDebugViews;
+	FBuoyancyDebugDraw mDebugDraw;
+
+	// Rebuilt every step, the arrays keep their memory.
+	TArray<HullKernel::FHullJob> mJobs;
+	TArray<UWaterPhysicsComponent*> mJobComponents;
+	TArray<HullKernel::FHullChunk> mChunks;
+	TArray<HullKernel::FKernelSummary> mChunkSummaries;
+	TArray<HullKernel::FKernelSummary> mJobSummaries;
+};
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "BuoyancyStats.h"
+
+DEFINE_STAT(STAT_BuoyancySchedulerTick);
+DEFINE_STAT(STAT_BuoyancyPrepareFrame);
+DEFINE_STAT(STAT_BuoyancyVertexTransform);
+DEFINE_STAT(STAT_BuoyancyWaterRequest);
+DEFINE_STAT(STAT_BuoyancyWaterUpdate);
+DEFINE_STAT(STAT_BuoyancyStep);
+DEFINE_STAT(STAT_BuoyancyPrepareStep);
+DEFINE_STAT(STAT_BuoyancyHullKernel);
+DEFINE_STAT(STAT_BuoyancyFinishStep);
+DEFINE_STAT(STAT_BuoyancyApplyForces);
+DEFINE_STAT(STAT_BuoyancyBatchSubmit);
+DEFINE_STAT(STAT_BuoyancyReadback);
+DEFINE_STAT(STAT_BuoyancyDebugDraw);
+DEFINE_STAT(STAT_BuoyancyRaycastSnapshot);
+DEFINE_STAT(STAT_BuoyancyRaycast);
+DEFINE_STAT(STAT_BuoyancyProps);
+
+DEFINE_STAT(STAT_BuoyancyHullsStepped);
+DEFINE_STAT(STAT_BuoyancyHullsAsleep);
+DEFINE_STAT(STAT_BuoyancyEvaluations);
+DEFINE_STAT(STAT_BuoyancyTriangles);
+DEFINE_STAT(STAT_BuoyancyTrianglesDry);
+DEFINE_STAT(STAT_BuoyancyTrianglesOneUnder);
+DEFINE_STAT(STAT_BuoyancyTrianglesTwoUnder);
+DEFINE_STAT(STAT_BuoyancyTrianglesSubmerged);
+DEFINE_STAT(STAT_BuoyancyTrianglesApplied);
+DEFINE_STAT(STAT_BuoyancySamplesRequested);
+DEFINE_STAT(STAT_BuoyancySamplesBatched);
+DEFINE_STAT(STAT_BuoyancyRays);
+DEFINE_STAT(STAT_BuoyancyPropCount);
+
+DEFINE_STAT(STAT_BuoyancyChunkWait);
+DEFINE_STAT(STAT_BuoyancyReadbackLatency);
+DEFINE_STAT(STAT_BuoyancyRequestsInFlight);
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "BuoyancyTrace.h"
+
+// stat Buoyancy
+DECLARE_STATS_GROUP(TEXT("Buoyancy"), STATGROUP_Buoyancy, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Scheduler tick"), STAT_BuoyancySchedulerTick, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Prepare frame"), STAT_BuoyancyPrepareFrame, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Vertex transform"), STAT_BuoyancyVertexTransform, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Water request"), STAT_BuoyancyWaterRequest, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Water update"), STAT_BuoyancyWaterUpdate, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Physics step"), STAT_BuoyancyStep, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Prepare step"), STAT_BuoyancyPrepareStep, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hull kernel"), STAT_BuoyancyHullKernel, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Finish step"), STAT_BuoyancyFinishStep, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply forces"), STAT_BuoyancyApplyForces, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Batch submit"), STAT_BuoyancyBatchSubmit, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Displacement readback"), STAT_BuoyancyReadback, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Debug draw"), STAT_BuoyancyDebugDraw, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ocean raycast snapshot"), STAT_BuoyancyRaycastSnapshot, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ocean raycasts"), STAT_BuoyancyRaycast, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Floating props"), STAT_BuoyancyProps, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hulls stepped"), STAT_BuoyancyHullsStepped, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hulls asleep"), STAT_BuoyancyHullsAsleep, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Evaluations"), STAT_BuoyancyEvaluations, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Triangles"), STAT_BuoyancyTriangles, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Triangles dry"), STAT_BuoyancyTrianglesDry, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Triangles one vertex under"), STAT_BuoyancyTrianglesOneUnder, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Triangles two vertices under"), STAT_BuoyancyTrianglesTwoUnder, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Triangles submerged"), STAT_BuoyancyTrianglesSubmerged, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Triangles with force"), STAT_BuoyancyTrianglesApplied, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Water samples requested"), STAT_BuoyancySamplesRequested, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Water samples batched"), STAT_BuoyancySamplesBatched, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Ocean rays"), STAT_BuoyancyRays, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Floating props"), STAT_BuoyancyPropCount, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+
+// Time the thread running a physics step sat idle waiting for the other threads to finish their hull chunks.
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Chunk wait (ms)"), STAT_BuoyancyChunkWait, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+
+// Frames between a WaveWorks request and its answer reaching the physics, of the latest answer.
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Readback latency (frames)"), STAT_BuoyancyReadbackLatency, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Requests in flight"), STAT_BuoyancyRequestsInFlight, STATGROUP_Buoyancy, WAVEWORKSTESTER_API);
+
+// Stat and trace of a block in one go. Boat is the trace id of the boat, INDEX_NONE for shared work.
+#define BUOYANCY_SCOPE(Stage, Boat) \
+	SCOPE_CYCLE_COUNTER(STAT_Buoyancy##Stage); \
+	FBuoyancyTrace::FScope BuoyancyTraceScope_##Stage(EBuoyancyStage::Stage, Boat)
@@ -0,0 +1,321 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "BuoyancyTrace.h"
+
+namespace
+{
+	struct FTraceEvent
+	{
+		uint64 Begin;
+		uint64 End;
+		uint32 ThreadId;
+		int32 Boat;
+		EBuoyancyStage Stage;
+	};
+
+	// About 30 MB, a few hundred boats over several seconds. Later events are dropped and counted.
+	const int32 MaxEvents = 1 << 20;
+	const int32 DefaultCaptureFrames = 300;
+
+	// Events written to the file per string, so the whole trace is never held as text.
+	const int32 EventsPerBlock = 4096;
+
+	const TCHAR* StageNames[] =
+	{
+		TEXT("SchedulerTick"),
+		TEXT("PrepareFrame"),
+		TEXT("VertexTransform"),
+		TEXT("WaterRequest"),
+		TEXT("WaterUpdate"),
+		TEXT("Step"),
+		TEXT("PrepareStep"),
+		TEXT("HullKernel"),
+		TEXT("ChunkWait"),
+		TEXT("FinishStep"),
+		TEXT("ApplyForces"),
+		TEXT("BatchSubmit"),
+		TEXT("Readback"),
+		TEXT("DebugDraw")
+	};
+	static_assert(ARRAY_COUNT(StageNames) == static_cast<int32>(EBuoyancyStage::Num), "Every stage needs a name.");
+
+	TArray<FString> BoatNames;
+
+	TArray<FTraceEvent> Events;
+	FThreadSafeCounter NumEvents;
+
+	// Threads between checking the capture flag and finishing their event, Stop waits for them to leave.
+	FThreadSafeCounter Writers;
+	FThreadSafeBool bCapturing;
+
+	FString TracePath;
+	uint64 StartCycles = 0;
+	uint64 StartFrame = 0;
+	int32 CaptureFrames = 0;
+	FDelegateHandle TickerHandle;
+
+	// The boat totals only add up the stages that are not nested in another one of the same boat.
+	bool IsOuterStage(EBuoyancyStage stage)
+	{
+		switch (stage)
+		{
+		case EBuoyancyStage::PrepareFrame:
+		case EBuoyancyStage::PrepareStep:
+		case EBuoyancyStage::HullKernel:
+		case EBuoyancyStage::FinishStep:
+		case EBuoyancyStage::ApplyForces:
+		case EBuoyancyStage::DebugDraw:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	void WriteText(FArchive& file, const FString& text)
+	{
+		FTCHARToUTF8 utf8(*text);
+		file.Serialize(const_cast<ANSICHAR*>(utf8.Get()), utf8.Length());
+	}
+
+	// Chrome trace event format, complete events in microseconds since the start of the capture.
+	void WriteTrace(int32 numEvents, uint64 frames, int32 dropped)
+	{
+		FArchive* file = IFileManager::Get().CreateFileWriter(*TracePath);
+		if (!file)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("BuoyancyTrace: Could not open %s."), *TracePath);
+			return;
+		}
+
+		const double microsecondsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1e6;
+
+		FString block = TEXT("{\"traceEvents\":[\n");
+		block += FString::Printf(TEXT("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"GameThread\"}}"), GGameThreadId);
+		for (int32 i = 0; i < numEvents; ++i)
+		{
+			const FTraceEvent& event = Events[i];
+			const double begin = (event.Begin - StartCycles) * microsecondsPerCycle;
+			const double duration = (event.End - event.Begin) * microsecondsPerCycle;
+
+			block += FString::Printf(TEXT(",\n{\"name\":\"%s\",\"cat\":\"buoyancy\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f"),
+				StageNames[static_cast<int32>(event.Stage)], event.ThreadId, begin, duration);
+			block += BoatNames.IsValidIndex(event.Boat) ? FString::Printf(TEXT(",\"args\":{\"boat\":\"%s\"}}"), *BoatNames[event.Boat]) : FString(TEXT("}"));
+
+			if (((i + 1) % EventsPerBlock) == 0)
+			{
+				WriteText(*file, block);
+				block.Reset();
+			}
+		}
+		block += FString::Printf(TEXT("\n],\"otherData\":{\"frames\":\"%llu\",\"dropped\":\"%d\"}}\n"), frames, dropped);
+		WriteText(*file, block);
+
+		file->Close();
+		delete file;
+	}
+
+	// Time per boat and stage, as CSV next to the trace and the most expensive boats in the log.
+	void WriteBreakdown(int32 numEvents, uint64 frames)
+	{
+		const int32 numStages = static_cast<int32>(EBuoyancyStage::Num);
+		const int32 numBoats = BoatNames.Num();
+		const double secondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+
+		// One row per boat and a last one for the work shared by every boat.
+		TArray<double> milliseconds;
+		TArray<int32> calls;
+		milliseconds.SetNumZeroed((numBoats + 1) * numStages);
+		calls.SetNumZeroed((numBoats + 1) * numStages);
+		for (int32 i = 0; i < numEvents; ++i)
+		{
+			const FTraceEvent& event = Events[i];
+			const int32 row = BoatNames.IsValidIndex(event.Boat) ? event.Boat : numBoats;
+			const int32 cell = (row * numStages) + static_cast<int32>(event.Stage);
+			milliseconds[cell] += (event.End - event.Begin) * secondsPerCycle * 1000.0;
+			++calls[cell];
+		}
+
+		FString csv = TEXT("Boat,Stage,TotalMs,MsPerFrame,Calls\n");
+		TArray<TPair<double, int32>> boatTotals;
+		for (int32 row = 0; row <= numBoats; ++row)
+		{
+			double total = 0.0;
+			for (int32 stage = 0; stage < numStages; ++stage)
+			{
+				const int32 cell = (row * numStages) + stage;
+				if (calls[cell] > 0)
+				{
+					const FString boat = (row < numBoats) ? BoatNames[row] : FString(TEXT("(shared)"));
+					csv += FString::Printf(TEXT("%s,%s,%.4f,%.4f,%d\n"), *boat, StageNames[stage], milliseconds[cell], milliseconds[cell] / frames, calls[cell]);
+					total += IsOuterStage(static_cast<EBuoyancyStage>(stage)) ? milliseconds[cell] : 0.0;
+				}
+			}
+
+			if ((row < numBoats) && (total > 0.0))
+			{
+				boatTotals.Add(TPair<double, int32>(total, row));
+			}
+		}
+		FFileHelper::SaveStringToFile(csv, *FPaths::ChangeExtension(TracePath, TEXT("csv")));
+
+		boatTotals.Sort([](const TPair<double, int32>& a, const TPair<double, int32>& b) { return a.Key > b.Key; });
+		const int32 numLogged = FMath::Min(boatTotals.Num(), 10);
+		for (int32 i = 0; i < numLogged; ++i)
+		{
+			const int32 row = boatTotals[i].Value;
+			FString stages;
+			for (int32 stage = 0; stage < numStages; ++stage)
+			{
+				const double stageMilliseconds = milliseconds[(row * numStages) + stage];
+				if (stageMilliseconds > 0.0)
+				{
+					stages += FString::Printf(TEXT(" %s %.3f"), StageNames[stage], stageMilliseconds / frames);
+				}
+			}
+			UE_LOG(LogTemp, Log, TEXT("BuoyancyTrace: %s %.3f ms/frame:%s"), *BoatNames[row], boatTotals[i].Key / frames, *stages);
+		}
+	}
+
+	bool TickCapture(float DeltaTime)
+	{
+		if (!bCapturing)
+		{
+			TickerHandle.Reset();
+			return false;
+		}
+
+		if ((GFrameCounter - StartFrame) >= static_cast<uint64>(CaptureFrames))
+		{
+			// Returning false removes the ticker, Stop must not remove it a second time.
+			TickerHandle.Reset();
+			FBuoyancyTrace::Stop();
+			return false;
+		}
+		return true;
+	}
+
+	void StartFromConsole(const TArray<FString>& args)
+	{
+		if (args.Num() < 1)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("BuoyancyTrace: Usage buoyancy.Trace <file> [frames]"));
+			return;
+		}
+		FBuoyancyTrace::Start(args[0], (args.Num() > 1) ? FCString::Atoi(*args[1]) : DefaultCaptureFrames);
+	}
+
+	FAutoConsoleCommand TraceCommand(
+		TEXT("buoyancy.Trace"),
+		TEXT("buoyancy.Trace <file> [frames]: Records every buoyancy stage of every boat for frames frames (300) into a Chrome trace, relative to Saved, and a per boat CSV next to it."),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&StartFromConsole));
+
+	FAutoConsoleCommand TraceStopCommand(
+		TEXT("buoyancy.TraceStop"),
+		TEXT("Ends the buoyancy trace early and writes it."),
+		FConsoleCommandDelegate::CreateStatic(&FBuoyancyTrace::Stop));
+}
+
+int32 FBuoyancyTrace::RegisterBoat(const FString& name)
+{
+	check(IsInGameThread());
+	return BoatNames.Add(name);
+}
+
+void FBuoyancyTrace::Start(const FString& path, int32 frames)
+{
+	check(IsInGameThread());
+
+	Stop();
+
+	TracePath = FPaths::IsRelative(path) ? FPaths::Combine(*FPaths::GameSavedDir(), *path) : path;
+	CaptureFrames = FMath::Max(frames, 1);
+	StartFrame = GFrameCounter;
+	StartCycles = FPlatformTime::Cycles64();
+
+	Events.SetNumUninitialized(MaxEvents);
+	NumEvents.Reset();
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&TickCapture));
+	bCapturing = true;
+
+	UE_LOG(LogTemp, Log, TEXT("BuoyancyTrace: Capturing %d frames to %s."), CaptureFrames, *TracePath);
+}
+
+void FBuoyancyTrace::Stop()
+{
+	check(IsInGameThread());
+
+	if (!bCapturing)
+	{
+		return;
+	}
+
+	// The physics, worker and render threads may be in the middle of an event.
+	bCapturing = false;
+	while (Writers.GetValue() > 0)
+	{
+		FPlatformProcess::Sleep(0.0f);
+	}
+
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	const int32 numEvents = FMath::Min(NumEvents.GetValue(), MaxEvents);
+	const int32 dropped = NumEvents.GetValue() - numEvents;
+	const uint64 frames = FMath::Max<uint64>(GFrameCounter - StartFrame, 1);
+
+	WriteTrace(numEvents, frames, dropped);
+	WriteBreakdown(numEvents, frames);
+	UE_LOG(LogTemp, Log, TEXT("BuoyancyTrace: Wrote %d events over %llu frames to %s, %d dropped."), numEvents, frames, *TracePath, dropped);
+
+	Events.Empty();
+}
+
+bool FBuoyancyTrace::IsCapturing()
+{
+	return bCapturing;
+}
+
+void FBuoyancyTrace::AddEvent(EBuoyancyStage stage, int32 boat, uint64 beginCycles, uint64 endCycles)
+{
+	if (!bCapturing)
+	{
+		return;
+	}
+
+	Writers.Increment();
+	if (bCapturing)
+	{
+		const int32 index = NumEvents.Increment() - 1;
+		if (index < MaxEvents)
+		{
+			FTraceEvent& event = Events[index];
+			event.Begin = beginCycles;
+			event.End = endCycles;
+			event.ThreadId = FPlatformTLS::GetCurrentThreadId();
+			event.Boat = boat;
+			event.Stage = stage;
+		}
+	}
+	Writers.Decrement();
+}
+
+FBuoyancyTrace::FScope::FScope(EBuoyancyStage stage, int32 boat) :
+	mBegin(0), mBoat(boat), mStage(stage), mActive(FBuoyancyTrace::IsCapturing())
+{
+	if (mActive)
+	{
+		mBegin = FPlatformTime::Cycles64();
+	}
+}
+
+FBuoyancyTrace::FScope::~FScope()
+{
+	if (mActive)
+	{
+		FBuoyancyTrace::AddEvent(mStage, mBoat, mBegin, FPlatformTime::Cycles64());
+	}
+}
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Stages of the buoyancy pipeline, as they show up in the trace and in the per boat breakdown.
+enum class EBuoyancyStage : uint8
+{
+	SchedulerTick,
+	PrepareFrame,
+	VertexTransform,
+	WaterRequest,
+	WaterUpdate,
+	Step,
+	PrepareStep,
+	HullKernel,
+	ChunkWait,
+	FinishStep,
+	ApplyForces,
+	BatchSubmit,
+	Readback,
+	DebugDraw,
+	Num
+};
+
+/**
+ * Records the buoyancy stages of every boat with their thread and cycle timestamps, and writes them as a Chrome
+ * trace (chrome://tracing, Perfetto) plus a per boat cost breakdown once the capture ends.
+ *   buoyancy.Trace <file> [frames]   starts a capture that stops by itself after frames frames, 300 by default.
+ *   buoyancy.TraceStop               ends it early.
+ * Relative paths are under Saved. Works headless, e.g. with -nullrhi -ExecCmds="buoyancy.Trace Buoyancy.json 600".
+ * Outside a capture a scope costs one flag check. Events come from any thread into a buffer allocated at start.
+ */
+class WAVEWORKSTESTER_API FBuoyancyTrace
+{
+public:
+	// Game thread. Name the breakdown lists the boat under, the id goes into its scopes.
+	static int32 RegisterBoat(const FString& name);
+
+	// Game thread.
+	static void Start(const FString& path, int32 frames);
+	static void Stop();
+
+	static bool IsCapturing();
+
+	// Times the enclosing block as stage of boat, INDEX_NONE when it is not one boat's work.
+	class WAVEWORKSTESTER_API FScope
+	{
+	public:
+		FScope(EBuoyancyStage stage, int32 boat);
+		~FScope();
+
+	private:
+		uint64 mBegin;
+		int32 mBoat;
+		EBuoyancyStage mStage;
+		bool mActive;
+	};
+
+	// Same for a span measured by the caller.
+	static void AddEvent(EBuoyancyStage stage, int32 boat, uint64 beginCycles, uint64 endCycles);
+};
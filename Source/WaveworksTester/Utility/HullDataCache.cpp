@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "HullDataCache.h"
+#include "HullIngestion.h"
+
+#include "Components/StaticMeshComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+
+TMap<TWeakObjectPtr<UStaticMesh>, HullDataCache::FEntry> HullDataCache::Entries;
+
+TSharedPtr<const HullKernel::FHullData> HullDataCache::Get(UStaticMeshComponent* meshComponent, int32 lod)
+{
+	check(IsInGameThread());
+	check(meshComponent);
+
+	UStaticMesh* staticMesh = meshComponent->GetStaticMesh();
+	UBodySetup* bodySetup = meshComponent->GetBodySetup();
+	check(staticMesh);
+	check(bodySetup);
+
+	lod = FMath::Clamp(lod, 0, HullKernel::HullLODCount - 1);
+
+	FEntry* entry = Entries.Find(staticMesh);
+	if (entry)
+	{
+		TSharedPtr<const HullKernel::FHullData> hull = entry->LODs[lod].Pin();
+		if (hull.IsValid())
+		{
+			return hull;
+		}
+	}
+
+	const FString path = CookedPath(staticMesh, bodySetup, lod);
+
+	TSharedPtr<HullKernel::FHullData> hull = MakeShareable(new HullKernel::FHullData);
+	if (!LoadCooked(path, *hull))
+	{
+		if (lod == 0)
+		{
+			hull = Build(bodySetup);
+		}
+		else
+		{
+			// Coarser LODs are decimated from the full hull.
+			TSharedPtr<const HullKernel::FHullData> source = Get(meshComponent, 0);
+			HullKernel::SimplifyHull(*source, HullKernel::HullLODTargetTriangles(source->NumTriangles(), lod), *hull);
+		}
+
+		if (hull->NumTriangles() > 0)
+		{
+			SaveCooked(path, *hull);
+		}
+	}
+
+	// Forget hulls whose components are all gone before adding the new one.
+	for (auto it = Entries.CreateIterator(); it; ++it)
+	{
+		bool bInUse = false;
+		for (const TWeakPtr<const HullKernel::FHullData>& lodHull : it.Value().LODs)
+		{
+			bInUse |= lodHull.IsValid();
+		}
+
+		if (!bInUse && (it.Key().Get() != staticMesh))
+		{
+			it.RemoveCurrent();
+		}
+	}
+
+	TSharedPtr<const HullKernel::FHullData> sharedHull = hull;
+	Entries.FindOrAdd(staticMesh).LODs[lod] = sharedHull;
+	return sharedHull;
+}
+
+TSharedPtr<HullKernel::FHullData> HullDataCache::Build(UBodySetup* bodySetup)
+{
+	TSharedPtr<HullKernel::FHullData> hull = MakeShareable(new HullKernel::FHullData);
+
+	// Every triangle mesh (16 or 32 bit indices) or convex element of the body, merged into one flat buffer.
+	if (!HullIngestion::BuildFromBodySetup(bodySetup, *hull))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("HullDataCache: %s has no collision triangles to build a buoyancy hull from."), *bodySetup->GetPathName());
+	}
+
+	return hull;
+}
+
+FString HullDataCache::CookedPath(UStaticMesh* staticMesh, UBodySetup* bodySetup, int32 lod)
+{
+	// The body setup guid changes whenever the collision is rebuilt, which invalidates the cooked file.
+	const FString fileName = FString::Printf(TEXT("%s_%s_LOD%d.hull"), *staticMesh->GetName(), *bodySetup->BodySetupGuid.ToString(), lod);
+	return FPaths::Combine(*FPaths::GameSavedDir(), TEXT("HullCache"), *fileName);
+}
+
+bool HullDataCache::LoadCooked(const FString& path, HullKernel::FHullData& outHull)
+{
+	TArray<uint8> bytes;
+	if (!FFileHelper::LoadFileToArray(bytes, *path, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	return HullKernel::DeserializeHullData(bytes.GetData(), bytes.Num(), outHull);
+}
+
+void HullDataCache::SaveCooked(const FString& path, const HullKernel::FHullData& hull)
+{
+	std::vector<uint8_t> cooked;
+	HullKernel::SerializeHullData(hull, cooked);
+
+	TArray<uint8> bytes;
+	bytes.Append(cooked.data(), cooked.size());
+	FFileHelper::SaveArrayToFile(bytes, *path);
+}
@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernel/HullData.h"
+#include "HullKernel/HullSimplifier.h"
+
+/**
+ * Shares one copy of the hull topology between every component using the same static mesh.
+ * Besides the full collision hull (LOD 0) it holds the decimated buoyancy LODs built from it.
+ * Hulls are kept alive by the components holding them and cooked to Saved/HullCache so later loads skip the build.
+ * Only used from the game thread.
+ */
+class WAVEWORKSTESTER_API HullDataCache
+{
+public:
+	~HullDataCache() = default;
+
+	static TSharedPtr<const HullKernel::FHullData> Get(UStaticMeshComponent* meshComponent, int32 lod = 0);
+
+private:
+	HullDataCache() = default;
+
+	static TSharedPtr<HullKernel::FHullData> Build(class UBodySetup* bodySetup);
+
+	static FString CookedPath(UStaticMesh* staticMesh, class UBodySetup* bodySetup, int32 lod);
+
+	static bool LoadCooked(const FString& path, HullKernel::FHullData& outHull);
+
+	static void SaveCooked(const FString& path, const HullKernel::FHullData& hull);
+
+	struct FEntry
+	{
+		TWeakPtr<const HullKernel::FHullData> LODs[HullKernel::HullLODCount];
+	};
+
+	static TMap<TWeakObjectPtr<UStaticMesh>, FEntry> Entries;
+};
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "HullForceModel.h"
+#include "BoatPhysicsUtil.h"
+
+UHullForceModel::UHullForceModel()
+{
+	const HullKernel::FForceCoefficients defaults = BoatPhysicsUtil::ForceCoefficients();
+	mDensityOfWater = defaults.DensityOfWater;
+	mViscousResistance = (defaults.Terms & HullKernel::ForceTermViscous) != 0;
+	mPressureDrag = (defaults.Terms & HullKernel::ForceTermPressureDrag) != 0;
+	mLinearPressureDrag = defaults.LinearPressureDrag;
+	mQuadraticPressureDrag = defaults.QuadraticPressureDrag;
+	mPressureFalloffPower = defaults.PressureFalloffPower;
+	mLinearSuctionDrag = defaults.LinearSuctionDrag;
+	mQuadraticSuctionDrag = defaults.QuadraticSuctionDrag;
+	mSuctionFalloffPower = defaults.SuctionFalloffPower;
+	mSlamming = (defaults.Terms & HullKernel::ForceTermSlamming) != 0;
+	mSlammingScale = defaults.SlammingScale;
+	mSlammingMaxAcceleration = defaults.SlammingMaxAcceleration;
+	mSlammingRampPower = defaults.SlammingRampPower;
+}
+
+HullKernel::FForceCoefficients UHullForceModel::ForceCoefficients() const
+{
+	HullKernel::FForceCoefficients coefficients;
+	coefficients.Terms = (mViscousResistance ? HullKernel::ForceTermViscous : 0) | (mPressureDrag ? HullKernel::ForceTermPressureDrag : 0)
+		| (mSlamming ? HullKernel::ForceTermSlamming : 0);
+	coefficients.DensityOfWater = mDensityOfWater;
+	coefficients.LinearPressureDrag = mLinearPressureDrag;
+	coefficients.QuadraticPressureDrag = mQuadraticPressureDrag;
+	coefficients.PressureFalloffPower = mPressureFalloffPower;
+	coefficients.LinearSuctionDrag = mLinearSuctionDrag;
+	coefficients.QuadraticSuctionDrag = mQuadraticSuctionDrag;
+	coefficients.SuctionFalloffPower = mSuctionFalloffPower;
+	coefficients.SlammingScale = mSlammingScale;
+	coefficients.SlammingMaxAcceleration = mSlammingMaxAcceleration;
+	coefficients.SlammingRampPower = mSlammingRampPower;
+	return coefficients;
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Engine/DataAsset.h"
+#include "HullKernel/HullKernelTypes.h"
+#include "HullForceModel.generated.h"
+
+/**
+ * Force terms and coefficients of one kind of hull, shared by every boat that references it.
+ * The hull kernel is specialized on the enabled terms and on falloff powers of 0.5, 1 and 2, so e.g. a buoy
+ * with only the hydrostatic force never runs the drag math of a ship. Defaults are the BoatPhysicsUtil constants.
+ */
+UCLASS(BlueprintType)
+class WAVEWORKSTESTER_API UHullForceModel : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UHullForceModel();
+
+	HullKernel::FForceCoefficients ForceCoefficients() const;
+
+protected:
+	// kg/cm3
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hydrostatic", DisplayName = "Density Of Water", Meta = (ClampMin = "0.0"))
+	float mDensityOfWater;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Viscous", DisplayName = "Viscous Resistance")
+	bool mViscousResistance;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pressure Drag", DisplayName = "Pressure Drag")
+	bool mPressureDrag;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pressure Drag", DisplayName = "Linear Pressure Drag")
+	float mLinearPressureDrag;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pressure Drag", DisplayName = "Quadratic Pressure Drag")
+	float mQuadraticPressureDrag;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pressure Drag", DisplayName = "Pressure Falloff Power", Meta = (ClampMin = "0.0"))
+	float mPressureFalloffPower;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pressure Drag", DisplayName = "Linear Suction Drag")
+	float mLinearSuctionDrag;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pressure Drag", DisplayName = "Quadratic Suction Drag")
+	float mQuadraticSuctionDrag;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pressure Drag", DisplayName = "Suction Falloff Power", Meta = (ClampMin = "0.0"))
+	float mSuctionFalloffPower;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Slamming", DisplayName = "Slamming")
+	bool mSlamming;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Slamming", DisplayName = "Slamming Scale", Meta = (ClampMin = "0.0"))
+	float mSlammingScale;
+
+	// cm/s2
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Slamming", DisplayName = "Slamming Max Acceleration", Meta = (ClampMin = "0.0"))
+	float mSlammingMaxAcceleration;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Slamming", DisplayName = "Slamming Ramp Power", Meta = (ClampMin = "0.0"))
+	float mSlammingRampPower;
+};
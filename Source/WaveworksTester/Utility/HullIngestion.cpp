@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "HullIngestion.h"
+#include "HullKernel/HullBuilder.h"
+
+//PhysX includes
+#include "PhysicsPublic.h"
+#include "PhysXPublic.h"
+#include "PhysXIncludes.h"
+#include "ThirdParty/PhysX/PhysX_3.4/Include/geometry/PxTriangleMesh.h"
+#include "ThirdParty/PhysX/PhysX_3.4/Include/geometry/PxConvexMesh.h"
+#include "ThirdParty/PhysX/PxShared/include/foundation/PxSimpleTypes.h"
+
+#include "PhysicsEngine/BodySetup.h"
+
+static void AppendTriangleMesh(HullKernel::FHullBuilder& builder, const PxTriangleMesh* triMesh)
+{
+	// Large meshes are cooked with 32 bit indices, only the small ones have e16_BIT_INDICES set.
+	const bool b16BitIndices = triMesh->getTriangleMeshFlags().isSet(PxTriangleMeshFlag::e16_BIT_INDICES);
+
+	builder.AppendMesh(&triMesh->getVertices()[0].x, sizeof(PxVec3), triMesh->getNbVertices(),
+		triMesh->getTriangles(), b16BitIndices ? HullKernel::EIndexWidth::Bits16 : HullKernel::EIndexWidth::Bits32, triMesh->getNbTriangles());
+}
+
+static void AppendConvexElement(HullKernel::FHullBuilder& builder, const FKConvexElem& convexElem)
+{
+	const PxConvexMesh* convexMesh = convexElem.GetConvexMesh();
+	if (!convexMesh)
+	{
+		return;
+	}
+
+	// Convex meshes are stored as polygons, fan them into triangles keeping the outward winding.
+	const PxU8* indexBuffer = convexMesh->getIndexBuffer();
+	TArray<uint32> indices;
+	for (PxU32 polygonIndex = 0; polygonIndex < convexMesh->getNbPolygons(); ++polygonIndex)
+	{
+		PxHullPolygon polygon;
+		convexMesh->getPolygonData(polygonIndex, polygon);
+
+		const PxU8* polygonIndices = indexBuffer + polygon.mIndexBase;
+		for (PxU16 corner = 2; corner < polygon.mNbVerts; ++corner)
+		{
+			indices.Add(polygonIndices[0]);
+			indices.Add(polygonIndices[corner - 1]);
+			indices.Add(polygonIndices[corner]);
+		}
+	}
+
+	// The element transform takes the convex into the space of the mesh, FMatrix uses row vectors.
+	const FMatrix matrix = convexElem.GetTransform().ToMatrixWithScale();
+	const float transform[12] =
+	{
+		matrix.M[0][0], matrix.M[1][0], matrix.M[2][0], matrix.M[3][0],
+		matrix.M[0][1], matrix.M[1][1], matrix.M[2][1], matrix.M[3][1],
+		matrix.M[0][2], matrix.M[1][2], matrix.M[2][2], matrix.M[3][2]
+	};
+
+	builder.AppendMesh(&convexMesh->getVertices()[0].x, sizeof(PxVec3), convexMesh->getNbVertices(),
+		indices.GetData(), HullKernel::EIndexWidth::Bits32, indices.Num() / 3, transform);
+}
+
+bool HullIngestion::BuildFromBodySetup(UBodySetup* bodySetup, HullKernel::FHullData& outHull)
+{
+	check(bodySetup);
+
+	HullKernel::FHullBuilder builder;
+
+	for (const PxTriangleMesh* triMesh : bodySetup->TriMeshes)
+	{
+		if (triMesh)
+		{
+			AppendTriangleMesh(builder, triMesh);
+		}
+	}
+
+	// The simple collision usually approximates the same hull as the complex one, so it is only used when there is
+	// no triangle mesh. Merging both would count the buoyancy of the hull twice.
+	if (builder.NumTriangles() == 0)
+	{
+		for (const FKConvexElem& convexElem : bodySetup->AggGeom.ConvexElems)
+		{
+			AppendConvexElement(builder, convexElem);
+		}
+	}
+
+	const bool bFoundTriangles = builder.NumTriangles() > 0;
+	builder.Finish(outHull);
+	return bFoundTriangles;
+}
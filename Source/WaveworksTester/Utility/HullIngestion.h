@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernel/HullData.h"
+
+/**
+ * Extracts the buoyancy hull of a body setup from its cooked PhysX geometry.
+ */
+class WAVEWORKSTESTER_API HullIngestion
+{
+public:
+	~HullIngestion() = default;
+
+	// Merges every triangle mesh of the body setup, or every convex element when there are none, into one hull in the
+	// space of the mesh. Both 16 and 32 bit index buffers are supported. Returns false if no triangles were found.
+	static bool BuildFromBodySetup(class UBodySetup* bodySetup, HullKernel::FHullData& outHull);
+
+private:
+	HullIngestion() = default;
+};
@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "HullKernelAdapter.h"
+#include "BoatPhysicsUtil.h"
+
+const float HullKernelAdapter::TunedStepRate = 60.0f;
+
+void FHullForceBuffers::SetNum(int32 numTriangles, bool bWithForceTerms)
+{
+	Submersion.SetNumZeroed(numTriangles);
+	Applied.SetNumZeroed(numTriangles);
+
+	for (TArray<float>* buffer : { &ForceX, &ForceY, &ForceZ, &CentroidX, &CentroidY, &CentroidZ, &SubmergedAreaHistory, &VelocityHistoryX, &VelocityHistoryY, &VelocityHistoryZ })
+	{
+		buffer->SetNumZeroed(numTriangles);
+	}
+
+	const int32 numTermElements = bWithForceTerms ? numTriangles : 0;
+	for (TArray<float>* buffer : { &HydrostaticX, &HydrostaticY, &HydrostaticZ, &ViscousX, &ViscousY, &ViscousZ, &PressureDragX, &PressureDragY, &PressureDragZ, &SlammingX, &SlammingY, &SlammingZ })
+	{
+		buffer->SetNumZeroed(numTermElements);
+	}
+}
+
+void FHullForceBuffers::SetForceTerms(bool bWithForceTerms)
+{
+	for (TArray<float>* buffer : { &HydrostaticX, &HydrostaticY, &HydrostaticZ, &ViscousX, &ViscousY, &ViscousZ, &PressureDragX, &PressureDragY, &PressureDragZ, &SlammingX, &SlammingY, &SlammingZ })
+	{
+		// Emptied rather than resized, an array holding memory would still hand the kernel a pointer.
+		if (bWithForceTerms)
+		{
+			buffer->SetNumZeroed(ForceX.Num());
+		}
+		else
+		{
+			buffer->Empty();
+		}
+	}
+}
+
+void FHullForceBuffers::ResetHistory()
+{
+	for (TArray<float>* buffer : { &SubmergedAreaHistory, &VelocityHistoryX, &VelocityHistoryY, &VelocityHistoryZ })
+	{
+		FMemory::Memzero(buffer->GetData(), buffer->Num() * sizeof(float));
+	}
+}
+
+HullKernel::FTriangleForces FHullForceBuffers::View()
+{
+	HullKernel::FTriangleForces view;
+	view.Submersion = Submersion.GetData();
+	view.Applied = Applied.GetData();
+	view.ForceX = ForceX.GetData();
+	view.ForceY = ForceY.GetData();
+	view.ForceZ = ForceZ.GetData();
+	view.CentroidX = CentroidX.GetData();
+	view.CentroidY = CentroidY.GetData();
+	view.CentroidZ = CentroidZ.GetData();
+
+	// Empty arrays return null, which tells the kernel to skip the term.
+	view.HydrostaticX = HydrostaticX.GetData();
+	view.HydrostaticY = HydrostaticY.GetData();
+	view.HydrostaticZ = HydrostaticZ.GetData();
+	view.ViscousX = ViscousX.GetData();
+	view.ViscousY = ViscousY.GetData();
+	view.ViscousZ = ViscousZ.GetData();
+	view.PressureDragX = PressureDragX.GetData();
+	view.PressureDragY = PressureDragY.GetData();
+	view.PressureDragZ = PressureDragZ.GetData();
+	view.SlammingX = SlammingX.GetData();
+	view.SlammingY = SlammingY.GetData();
+	view.SlammingZ = SlammingZ.GetData();
+
+	view.SubmergedAreaHistory = SubmergedAreaHistory.GetData();
+	view.VelocityHistoryX = VelocityHistoryX.GetData();
+	view.VelocityHistoryY = VelocityHistoryY.GetData();
+	view.VelocityHistoryZ = VelocityHistoryZ.GetData();
+	return view;
+}
+
+HullKernel::FHullView HullKernelAdapter::MakeHullView(const TArray<float>& x, const TArray<float>& y, const TArray<float>& z, const HullKernel::FHullData& hull)
+{
+	check((x.Num() == hull.NumVertices()) && (y.Num() == hull.NumVertices()) && (z.Num() == hull.NumVertices()));
+
+	HullKernel::FHullView view;
+	view.X = x.GetData();
+	view.Y = y.GetData();
+	view.Z = z.GetData();
+	view.Indices = hull.Indices.data();
+	view.NumVertices = hull.NumVertices();
+	view.NumTriangles = hull.NumTriangles();
+	view.Nodes = nullptr;
+	view.NodeVertices = nullptr;
+	view.NumNodes = 0;
+	return view;
+}
+
+HullKernel::FAffineTransform HullKernelAdapter::MakeAffineTransform(const FTransform& transform)
+{
+	// Unreal matrices transform row vectors, the kernel takes the transpose.
+	const FMatrix matrix = transform.ToMatrixWithScale();
+
+	HullKernel::FAffineTransform result;
+	for (int32 row = 0; row < 3; ++row)
+	{
+		for (int32 column = 0; column < 4; ++column)
+		{
+			result.M[row][column] = matrix.M[column][row];
+		}
+	}
+	return result;
+}
+
+HullKernel::FBodyState HullKernelAdapter::MakeBodyState(UStaticMeshComponent* boatMesh, float lengthOfSubmerged)
+{
+	const float mass = boatMesh->GetBodyInstance()->GetBodyMass();
+	const float weight = boatMesh->GetWorld()->GetGravityZ() * mass;
+	return MakeBodyState(boatMesh->GetComponentVelocity(), boatMesh->GetPhysicsAngularVelocity(), boatMesh->GetCenterOfMass(), weight, lengthOfSubmerged,
+		mass, 0.0f, 0.0f);
+}
+
+HullKernel::FBodyState HullKernelAdapter::MakeBodyState(const FVector& linearVelocity, const FVector& angularVelocity, const FVector& centerOfMass,
+	float weight, float lengthOfSubmerged, float mass, float surfaceArea, float timeStep)
+{
+	HullKernel::FBodyState body;
+	body.LinearVelocity[0] = linearVelocity.X;
+	body.LinearVelocity[1] = linearVelocity.Y;
+	body.LinearVelocity[2] = linearVelocity.Z;
+	body.AngularVelocity[0] = angularVelocity.X;
+	body.AngularVelocity[1] = angularVelocity.Y;
+	body.AngularVelocity[2] = angularVelocity.Z;
+	body.CenterOfMass[0] = centerOfMass.X;
+	body.CenterOfMass[1] = centerOfMass.Y;
+	body.CenterOfMass[2] = centerOfMass.Z;
+	body.Weight = weight;
+	body.Mass = mass;
+	body.SurfaceArea = surfaceArea;
+	body.TimeStep = timeStep;
+
+	// The resistance coefficient only depends on the whole body, so it is evaluated once instead of per triangle.
+	body.ResistanceCoefficient = BoatPhysicsUtil::ResistanceCoefficient(linearVelocity.Size(), lengthOfSubmerged);
+	return body;
+}
+
+void HullKernelAdapter::ApplyWrench(FBodyInstance* body, const HullKernel::FWrench& wrench)
+{
+	const FVector force(wrench.Force[0], wrench.Force[1], wrench.Force[2]);
+	const FVector torque(wrench.Torque[0], wrench.Torque[1], wrench.Torque[2]);
+
+	// Substepping is off, the callback already runs once per substep.
+	if (!force.IsZero())
+	{
+		body->AddForce(force * TunedStepRate, false);
+	}
+	if (!torque.IsZero())
+	{
+		body->AddTorque(torque * TunedStepRate, false);
+	}
+}
+
+void HullKernelAdapter::ApplyForceAtPosition(FBodyInstance* body, const FVector& force, const FVector& position)
+{
+	body->AddForceAtPosition(force * TunedStepRate, position, false);
+}
+
+FVector HullKernelAdapter::ToVector(const float* x, const float* y, const float* z, int32 index)
+{
+	return FVector(x[index], y[index], z[index]);
+}
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernel/HullForceKernel.h"
+#include "HullKernel/HullData.h"
+#include "HullKernel/VertexTransform.h"
+
+/**
+ * Per triangle output buffers of the hull force kernel, sized once and reused every tick.
+ */
+struct WAVEWORKSTESTER_API FHullForceBuffers
+{
+	TArray<uint8> Submersion;
+	TArray<uint8> Applied;
+
+	TArray<float> ForceX;
+	TArray<float> ForceY;
+	TArray<float> ForceZ;
+
+	TArray<float> CentroidX;
+	TArray<float> CentroidY;
+	TArray<float> CentroidZ;
+
+	// Individual force terms, only allocated while buoyancy.DrawForces is on.
+	TArray<float> HydrostaticX;
+	TArray<float> HydrostaticY;
+	TArray<float> HydrostaticZ;
+
+	TArray<float> ViscousX;
+	TArray<float> ViscousY;
+	TArray<float> ViscousZ;
+
+	TArray<float> PressureDragX;
+	TArray<float> PressureDragY;
+	TArray<float> PressureDragZ;
+
+	TArray<float> SlammingX;
+	TArray<float> SlammingY;
+	TArray<float> SlammingZ;
+
+	// Previous evaluation of every triangle, for the slamming force.
+	TArray<float> SubmergedAreaHistory;
+	TArray<float> VelocityHistoryX;
+	TArray<float> VelocityHistoryY;
+	TArray<float> VelocityHistoryZ;
+
+	void SetNum(int32 numTriangles, bool bWithForceTerms);
+
+	// Allocates or frees the individual force terms, keeping everything else.
+	void SetForceTerms(bool bWithForceTerms);
+
+	bool HasForceTerms() const { return HydrostaticX.Num() > 0; }
+
+	// Forgets the previous evaluation, when the hull changes.
+	void ResetHistory();
+
+	HullKernel::FTriangleForces View();
+};
+
+/**
+ * Thin layer between the engine independent hull kernel and Unreal types.
+ */
+class WAVEWORKSTESTER_API HullKernelAdapter
+{
+public:
+	~HullKernelAdapter() = default;
+
+	// The force coefficients were tuned with the kernel output applied as an impulse once per 60 Hz frame.
+	// Applied as a force it is scaled by that rate, which keeps the tuning and no longer depends on the step length.
+	static const float TunedStepRate;
+
+	// Shared topology of the hull combined with the world space vertices of one body, without the hierarchy until
+	// HullKernel::BindHullBVH bounds the water under them.
+	static HullKernel::FHullView MakeHullView(const TArray<float>& x, const TArray<float>& y, const TArray<float>& z, const HullKernel::FHullData& hull);
+
+	static HullKernel::FAffineTransform MakeAffineTransform(const FTransform& transform);
+
+	// Without a time step, so the kernel applies no slamming force.
+	static HullKernel::FBodyState MakeBodyState(UStaticMeshComponent* boatMesh, float lengthOfSubmerged);
+
+	// Same from state read inside a physics step. The centre of mass is in world space, the angular velocity in deg/s.
+	// timeStep is the time since the evaluation the triangle history holds, 0 when it holds none.
+	static HullKernel::FBodyState MakeBodyState(const FVector& linearVelocity, const FVector& angularVelocity, const FVector& centerOfMass,
+		float weight, float lengthOfSubmerged, float mass, float surfaceArea, float timeStep);
+
+	// Pushes the summed force at the centre of mass plus the torque about it for the coming physics step, equivalent to
+	// one force per triangle. Only valid inside a custom physics callback.
+	static void ApplyWrench(FBodyInstance* body, const HullKernel::FWrench& wrench);
+
+	// One triangle force at its centroid, for inspecting the force distribution. Same restrictions.
+	static void ApplyForceAtPosition(FBodyInstance* body, const FVector& force, const FVector& position);
+
+	static FVector ToVector(const float* x, const float* y, const float* z, int32 index);
+
+private:
+	HullKernelAdapter() = default;
+};
@@ -0,0 +1,177 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "OceanQuery.h"
+#include "CustomComponents/GerstnerOceanComponent.h"
+#include "HullKernel/DisplacementInversion.h"
+#include "HullKernel/GerstnerOcean.h"
+
+namespace
+{
+	// Furthest (m) the CPU backend looks for the surface along a ray.
+	const float RaycastMaxDistance = 2000.0f;
+
+	// Points converted to and from structure-of-arrays on the stack at a time.
+	const int32 HeightBlockSize = 256;
+
+	class FWaveWorksOceanQuery : public IOceanQuery
+	{
+	public:
+		explicit FWaveWorksOceanQuery(UWaveWorksComponent* waveWorksComponent) : mWaveWorksComponent(waveWorksComponent)
+		{
+		}
+
+		virtual float GetSeaLevel() const override
+		{
+			return mWaveWorksComponent->SeaLevel;
+		}
+
+		virtual bool IsSynchronous() const override
+		{
+			return false;
+		}
+
+		virtual void SampleHeights(const float* x, const float* y, int32 count, float* outHeights) override
+		{
+			checkf(false, TEXT("WaveWorks can only be sampled asynchronously, check IsSynchronous first."));
+		}
+
+		virtual void SampleDisplacements(const TArray<FVector2D>& samplePoints, const FVectorArrayDelegate& onDisplacements) override
+		{
+			mWaveWorksComponent->SampleDisplacements(samplePoints, onDisplacements);
+		}
+
+		virtual void GetIntersectPointWithRay(const FVector& origin, const FVector& direction, const FWaveWorksRaycastResultDelegate& onIntersect) override
+		{
+			mWaveWorksComponent->GetIntersectPointWithRay(origin, direction, onIntersect);
+		}
+
+	private:
+		UWaveWorksComponent* mWaveWorksComponent;
+	};
+
+	class FGerstnerOceanQuery : public IOceanQuery
+	{
+	public:
+		FGerstnerOceanQuery(TSharedPtr<const HullKernel::FGerstnerOcean> ocean, UWorld* world, float seaLevel) :
+			mOcean(ocean), mWorld(world), mSeaLevel(seaLevel)
+		{
+		}
+
+		virtual float GetSeaLevel() const override
+		{
+			return mSeaLevel;
+		}
+
+		virtual bool IsSynchronous() const override
+		{
+			return true;
+		}
+
+		virtual void SampleHeights(const float* x, const float* y, int32 count, float* outHeights) override
+		{
+			mHeightPointX.SetNumUninitialized(count, false);
+			mHeightPointY.SetNumUninitialized(count, false);
+			for (int32 i = 0; i < count; ++i)
+			{
+				mHeightPointX[i] = x[i] / 100.0f;
+				mHeightPointY[i] = y[i] / 100.0f;
+			}
+
+			// The water above each point, not the water displaced away from it by a choppy wave.
+			mOcean->SampleSurfaceHeights(mHeightPointX.GetData(), mHeightPointY.GetData(), count, GetTime(), mInversion, outHeights);
+			for (int32 i = 0; i < count; ++i)
+			{
+				outHeights[i] = (outHeights[i] * 100.0f) + mSeaLevel;
+			}
+		}
+
+		virtual void SampleDisplacements(const TArray<FVector2D>& samplePoints, const FVectorArrayDelegate& onDisplacements) override
+		{
+			const double time = GetTime();
+
+			// Block by block, so large batches such as the floating props share the per wave setup.
+			float blockX[HeightBlockSize];
+			float blockY[HeightBlockSize];
+			float displacementX[HeightBlockSize];
+			float displacementY[HeightBlockSize];
+			float displacementZ[HeightBlockSize];
+
+			const int32 count = samplePoints.Num();
+			mDisplacements.SetNumUninitialized(count, false);
+			for (int32 blockBegin = 0; blockBegin < count; blockBegin += HeightBlockSize)
+			{
+				const int32 blockCount = FMath::Min(HeightBlockSize, count - blockBegin);
+				for (int32 i = 0; i < blockCount; ++i)
+				{
+					blockX[i] = samplePoints[blockBegin + i].X;
+					blockY[i] = samplePoints[blockBegin + i].Y;
+				}
+
+				mOcean->SampleDisplacements(blockX, blockY, blockCount, time, displacementX, displacementY, displacementZ);
+				for (int32 i = 0; i < blockCount; ++i)
+				{
+					mDisplacements[blockBegin + i] = FVector4(displacementX[i], displacementY[i], displacementZ[i], 0.0f);
+				}
+			}
+
+			onDisplacements.ExecuteIfBound(mDisplacements);
+		}
+
+		virtual void GetIntersectPointWithRay(const FVector& origin, const FVector& direction, const FWaveWorksRaycastResultDelegate& onIntersect) override
+		{
+			// The CPU ocean is centred on zero, WaveWorks on the sea level.
+			const float seaLevel = mSeaLevel / 100.0f;
+			const float rayOrigin[3] = { origin.X, origin.Y, origin.Z - seaLevel };
+			const FVector rayDirection = direction.GetSafeNormal();
+			const float rayDirectionArray[3] = { rayDirection.X, rayDirection.Y, rayDirection.Z };
+
+			float hit[3];
+			const bool bHit = mOcean->Raycast(rayOrigin, rayDirectionArray, RaycastMaxDistance, GetTime(), hit);
+			onIntersect.ExecuteIfBound(bHit ? FVector(hit[0], hit[1], hit[2] + seaLevel) : FVector::ZeroVector, bHit);
+		}
+
+	private:
+		double GetTime() const
+		{
+			const UWorld* world = mWorld.Get();
+			return world ? world->GetTimeSeconds() : 0.0;
+		}
+
+		TSharedPtr<const HullKernel::FGerstnerOcean> mOcean;
+		TWeakObjectPtr<UWorld> mWorld;
+		float mSeaLevel;
+
+		// Reused by SampleDisplacements, every client has its own query.
+		TArray<FVector4> mDisplacements;
+
+		// Points of SampleHeights in metres, and the inversion warm started from its previous call.
+		TArray<float> mHeightPointX;
+		TArray<float> mHeightPointY;
+		HullKernel::FDisplacementInversion mInversion;
+	};
+}
+
+TSharedPtr<IOceanQuery> IOceanQuery::Create(UWorld* world, AActor* oceanActor)
+{
+	UWaveWorksComponent* waveWorksComponent = oceanActor ? oceanActor->FindComponentByClass<UWaveWorksComponent>() : nullptr;
+	UGerstnerOceanComponent* gerstnerComponent = oceanActor ? oceanActor->FindComponentByClass<UGerstnerOceanComponent>() : nullptr;
+
+	// WaveWorks simulates on the GPU, so dedicated servers and -nullrhi runs fall back to the CPU ocean.
+	const bool bPreferGerstner = gerstnerComponent && gerstnerComponent->PrefersOverWaveWorks();
+	if (waveWorksComponent && FApp::CanEverRender() && !bPreferGerstner)
+	{
+		return MakeShareable(new FWaveWorksOceanQuery(waveWorksComponent));
+	}
+
+	if (gerstnerComponent)
+	{
+		return MakeShareable(new FGerstnerOceanQuery(gerstnerComponent->GetOcean(), world, gerstnerComponent->GetSeaLevel()));
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("IOceanQuery: %s has no usable ocean, falling back to a default CPU ocean."), oceanActor ? *oceanActor->GetName() : TEXT("None"));
+
+	TSharedPtr<HullKernel::FGerstnerOcean> ocean = MakeShareable(new HullKernel::FGerstnerOcean);
+	ocean->Build(HullKernel::DefaultGerstnerSettings());
+	return MakeShareable(new FGerstnerOceanQuery(ocean, world, waveWorksComponent ? waveWorksComponent->SeaLevel : 0.0f));
+}
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+ * Water surface queries, independent of where the ocean is simulated.
+ * The WaveWorks backend answers asynchronously from the render thread, the CPU Gerstner backend answers
+ * synchronously on the calling thread, which also works on dedicated servers and headless runs.
+ * Positions follow the WaveWorks API: metres for displacements and rays, centimetres for heights.
+ */
+class WAVEWORKSTESTER_API IOceanQuery
+{
+public:
+	virtual ~IOceanQuery() = default;
+
+	// WaveWorks when the actor has it and it can render, otherwise the actor's UGerstnerOceanComponent or a default CPU ocean.
+	static TSharedPtr<IOceanQuery> Create(UWorld* world, AActor* oceanActor);
+
+	// World height (cm) the displacements are relative to.
+	virtual float GetSeaLevel() const = 0;
+
+	// True when the delegates run before the query returns and SampleHeights can be used.
+	virtual bool IsSynchronous() const = 0;
+
+	// Absolute heights (cm) of the water right above world positions (cm). Only for synchronous backends.
+	virtual void SampleHeights(const float* x, const float* y, int32 count, float* outHeights) = 0;
+
+	// Displacement (m) of the surface at each point (m). WaveWorks calls back on the render thread one or more frames later.
+	virtual void SampleDisplacements(const TArray<FVector2D>& samplePoints, const FVectorArrayDelegate& onDisplacements) = 0;
+
+	// Intersection (m) of the ray starting at origin (m) with the surface.
+	virtual void GetIntersectPointWithRay(const FVector& origin, const FVector& direction, const FWaveWorksRaycastResultDelegate& onIntersect) = 0;
+};
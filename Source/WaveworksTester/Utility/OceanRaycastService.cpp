@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "OceanRaycastService.h"
+#include "BuoyancyStats.h"
+
+static TAutoConsoleVariable<float> CVarRaycastExtent(
+	TEXT("ocean.RaycastExtent"),
+	25600.0f,
+	TEXT("Side (cm) of the square of water around the focus that batched ocean raycasts are tested against."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRaycastCellSize(
+	TEXT("ocean.RaycastCellSize"),
+	200.0f,
+	TEXT("Spacing (cm) of the water heights batched ocean raycasts are tested against."),
+	ECVF_Default);
+
+// Seconds between height requests, the heights are extrapolated in between.
+static const float SnapshotRequestInterval = 0.1f;
+
+// Rays converted to structure-of-arrays at a time, so batches of any size run without allocating.
+static const int32 RayBlockSize = 256;
+
+TMap<TWeakObjectPtr<AActor>, TSharedPtr<FOceanRaycastService>> FOceanRaycastService::Services;
+
+TSharedPtr<FOceanRaycastService> FOceanRaycastService::Get(UWorld* world, AActor* oceanActor)
+{
+	check(IsInGameThread());
+	check(oceanActor);
+
+	// Forget the services of oceans that were destroyed, e.g. by a level change.
+	for (auto it = Services.CreateIterator(); it; ++it)
+	{
+		if (!it.Key().IsValid())
+		{
+			it.RemoveCurrent();
+		}
+	}
+
+	TSharedPtr<FOceanRaycastService>& service = Services.FindOrAdd(oceanActor);
+	if (!service.IsValid())
+	{
+		service = MakeShareable(new FOceanRaycastService(world, oceanActor));
+	}
+	return service;
+}
+
+FOceanRaycastService::FOceanRaycastService(UWorld* world, AActor* oceanActor) :
+	mWorld(world), mOceanActor(oceanActor), mExtent(0.0f), mCellSize(0.0f), mFocus(FVector::ZeroVector), mHasFocus(false),
+	mSnapshotFrame(0)
+{
+	CreateSampler();
+}
+
+FOceanRaycastService::~FOceanRaycastService()
+{
+	if (mSampler.IsValid())
+	{
+		mSampler->Unregister();
+	}
+}
+
+void FOceanRaycastService::CreateSampler()
+{
+	if (mSampler.IsValid())
+	{
+		mSampler->Unregister();
+		mSampler.Reset();
+	}
+
+	mExtent = FMath::Max(CVarRaycastExtent.GetValueOnGameThread(), 100.0f);
+	mCellSize = FMath::Clamp(CVarRaycastCellSize.GetValueOnGameThread(), 10.0f, mExtent);
+	mPyramid.Reset();
+
+	if (!mWorld.IsValid() || !mOceanActor.IsValid())
+	{
+		return;
+	}
+
+	mSampler = MakeShareable(new FWaterHeightSampler(mWorld.Get(), mOceanActor.Get()));
+	mSampler->SetQuality(mCellSize, SnapshotRequestInterval);
+	mSampler->Initialize(4, mExtent);
+}
+
+void FOceanRaycastService::SetFocus(const FVector& location)
+{
+	mFocus = location;
+	mHasFocus = true;
+}
+
+bool FOceanRaycastService::IsReady() const
+{
+	return !mPyramid.IsEmpty();
+}
+
+void FOceanRaycastService::Tick(float DeltaTime)
+{
+	if ((CVarRaycastExtent.GetValueOnGameThread() != mExtent) || (CVarRaycastCellSize.GetValueOnGameThread() != mCellSize))
+	{
+		CreateSampler();
+	}
+	if (!mSampler.IsValid())
+	{
+		return;
+	}
+
+	UWorld* world = mWorld.Get();
+	if (!mHasFocus)
+	{
+		APlayerController* player = world->GetFirstPlayerController();
+		if (player && player->PlayerCameraManager)
+		{
+			mFocus = player->PlayerCameraManager->GetCameraLocation();
+		}
+	}
+
+	// The corners of the square, the sampler fits its grid around them.
+	const float halfExtent = mExtent * 0.5f;
+	const float x[4] = { mFocus.X - halfExtent, mFocus.X + halfExtent, mFocus.X - halfExtent, mFocus.X + halfExtent };
+	const float y[4] = { mFocus.Y - halfExtent, mFocus.Y - halfExtent, mFocus.Y + halfExtent, mFocus.Y + halfExtent };
+	mSampler->Request(x, y, 4, world->GetTimeSeconds());
+}
+
+void FOceanRaycastService::UpdateSnapshot()
+{
+	if ((mSnapshotFrame == GFrameCounter) || !mSampler.IsValid())
+	{
+		return;
+	}
+	mSnapshotFrame = GFrameCounter;
+
+	SCOPE_CYCLE_COUNTER(STAT_BuoyancyRaycastSnapshot);
+
+	mSampler->Update();
+
+	HullKernel::FHeightGridLayout layout;
+	const float* nodeHeights;
+	if (mSampler->EvaluateGrid(mWorld->GetTimeSeconds(), layout, nodeHeights))
+	{
+		mPyramid.Build(layout, nodeHeights);
+	}
+}
+
+void FOceanRaycastService::Raycast(const FVector* origins, const FVector* directions, int32 count, float maxDistance, FOceanRayHit* outHits)
+{
+	check(IsInGameThread());
+
+	UpdateSnapshot();
+
+	SCOPE_CYCLE_COUNTER(STAT_BuoyancyRaycast);
+	INC_DWORD_STAT_BY(STAT_BuoyancyRays, count);
+
+	float originX[RayBlockSize];
+	float originY[RayBlockSize];
+	float originZ[RayBlockSize];
+	float directionX[RayBlockSize];
+	float directionY[RayBlockSize];
+	float directionZ[RayBlockSize];
+	float distances[RayBlockSize];
+
+	for (int32 blockBegin = 0; blockBegin < count; blockBegin += RayBlockSize)
+	{
+		const int32 blockCount = FMath::Min(RayBlockSize, count - blockBegin);
+		for (int32 i = 0; i < blockCount; ++i)
+		{
+			const FVector& origin = origins[blockBegin + i];
+			const FVector direction = directions[blockBegin + i].GetSafeNormal();
+			originX[i] = origin.X;
+			originY[i] = origin.Y;
+			originZ[i] = origin.Z;
+			directionX[i] = direction.X;
+			directionY[i] = direction.Y;
+			directionZ[i] = direction.Z;
+		}
+
+		HullKernel::FRayBatch rays;
+		rays.OriginX = originX;
+		rays.OriginY = originY;
+		rays.OriginZ = originZ;
+		rays.DirectionX = directionX;
+		rays.DirectionY = directionY;
+		rays.DirectionZ = directionZ;
+		rays.Count = blockCount;
+		HullKernel::RaycastHeightField(mPyramid, rays, maxDistance, distances);
+
+		for (int32 i = 0; i < blockCount; ++i)
+		{
+			FOceanRayHit& hit = outHits[blockBegin + i];
+			hit.bHit = (distances[i] >= 0.0f);
+			hit.Distance = distances[i];
+
+			const float along = hit.bHit ? distances[i] : maxDistance;
+			hit.Location = FVector(originX[i] + (directionX[i] * along), originY[i] + (directionY[i] * along), originZ[i] + (directionZ[i] * along));
+		}
+	}
+}
+
+void FOceanRaycastService::Raycast(const TArray<FVector>& origins, const TArray<FVector>& directions, float maxDistance, TArray<FOceanRayHit>& outHits)
+{
+	check(origins.Num() == directions.Num());
+
+	outHits.SetNumUninitialized(origins.Num(), false);
+	Raycast(origins.GetData(), directions.GetData(), origins.Num(), maxDistance, outHits.GetData());
+}
+
+bool FOceanRaycastService::IsTickable() const
+{
+	return mWorld.IsValid();
+}
+
+TStatId FOceanRaycastService::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FOceanRaycastService, STATGROUP_Tickables);
+}
+
+UWorld* FOceanRaycastService::GetTickableGameObjectWorld() const
+{
+	return mWorld.Get();
+}
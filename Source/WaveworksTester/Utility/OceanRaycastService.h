@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Tickable.h"
+#include "HullKernel/HeightFieldRaycast.h"
+#include "WaterHeightSampler.h"
+
+struct FOceanRayHit
+{
+	// World position (cm) where the ray enters the water, the ray's end when it misses.
+	FVector Location;
+
+	// Distance (cm) along the ray, -1 when it misses.
+	float Distance;
+
+	bool bHit;
+};
+
+/**
+ * Answers batches of water rays synchronously on the game thread, for gunfire splashes, sonar, line of sight
+ * and camera collision, instead of one asynchronous GetIntersectPointWithRay round trip per ray.
+ * The rays march against a CPU snapshot of the water heights around a focus, the first local player's view
+ * unless SetFocus moves it, with a min/max pyramid so they skip the water they pass high above. The snapshot is
+ * filled like the hull heights, synchronously from the CPU ocean or through the WaveWorks batch, and moved to
+ * the current time on the first raycast of a frame. Rays are only tested where they pass over the snapshot.
+ *   ocean.RaycastExtent    side (cm) of the square around the focus.
+ *   ocean.RaycastCellSize  spacing (cm) of the heights.
+ */
+class WAVEWORKSTESTER_API FOceanRaycastService : public FTickableGameObject
+{
+public:
+	// One service per ocean actor, kept until the actor is gone. Game thread only.
+	static TSharedPtr<FOceanRaycastService> Get(UWorld* world, AActor* oceanActor);
+
+	FOceanRaycastService(UWorld* world, AActor* oceanActor);
+	virtual ~FOceanRaycastService();
+
+	// Centre (cm) of the snapshot from now on, instead of the player's view.
+	void SetFocus(const FVector& location);
+
+	// False until the first heights have arrived.
+	bool IsReady() const;
+
+	// First water along each ray within maxDistance (cm), the directions need not be normalized. outHits holds count hits.
+	void Raycast(const FVector* origins, const FVector* directions, int32 count, float maxDistance, FOceanRayHit* outHits);
+	void Raycast(const TArray<FVector>& origins, const TArray<FVector>& directions, float maxDistance, TArray<FOceanRayHit>& outHits);
+
+	// Requests the heights around the focus.
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+private:
+	void CreateSampler();
+
+	// Brings the pyramid to the current time, once per frame.
+	void UpdateSnapshot();
+
+	static TMap<TWeakObjectPtr<AActor>, TSharedPtr<FOceanRaycastService>> Services;
+
+	TWeakObjectPtr<UWorld> mWorld;
+	TWeakObjectPtr<AActor> mOceanActor;
+
+	TSharedPtr<FWaterHeightSampler, ESPMode::ThreadSafe> mSampler;
+	float mExtent;
+	float mCellSize;
+
+	FVector mFocus;
+	bool mHasFocus;
+
+	HullKernel::FHeightFieldPyramid mPyramid;
+	uint64 mSnapshotFrame;
+};
@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "OceanSampleBatcher.h"
+#include "BuoyancyStats.h"
+
+TMap<TWeakObjectPtr<AActor>, TSharedPtr<FOceanSampleBatcher, ESPMode::ThreadSafe>> FOceanSampleBatcher::Batchers;
+
+TSharedPtr<FOceanSampleBatcher, ESPMode::ThreadSafe> FOceanSampleBatcher::Get(UWorld* world, AActor* oceanActor)
+{
+	check(IsInGameThread());
+	check(oceanActor);
+
+	// Forget the batchers of oceans that were destroyed, e.g. by a level change.
+	for (auto it = Batchers.CreateIterator(); it; ++it)
+	{
+		if (!it.Key().IsValid())
+		{
+			it.RemoveCurrent();
+		}
+	}
+
+	TSharedPtr<FOceanSampleBatcher, ESPMode::ThreadSafe>& batcher = Batchers.FindOrAdd(oceanActor);
+	if (!batcher.IsValid())
+	{
+		batcher = MakeShareable(new FOceanSampleBatcher(world, oceanActor));
+	}
+	return batcher;
+}
+
+FOceanSampleBatcher::FOceanSampleBatcher(UWorld* world, AActor* oceanActor) :
+	mWorld(world), mOcean(IOceanQuery::Create(world, oceanActor)), mPendingSerial(1)
+{
+}
+
+int32 FOceanSampleBatcher::Register(const FOceanSampleRangeDelegate& onSamples)
+{
+	check(IsInGameThread());
+
+	FClientPtr client = MakeShareable(new FClient);
+	client->OnSamples = onSamples;
+	client->bActive = true;
+
+	// Reuse the handle of a client that left.
+	int32 handle = mClients.IndexOfByKey(FClientPtr());
+	if (handle == INDEX_NONE)
+	{
+		handle = mClients.Add(client);
+	}
+	else
+	{
+		mClients[handle] = client;
+	}
+	return handle;
+}
+
+void FOceanSampleBatcher::Unregister(int32 handle)
+{
+	check(IsInGameThread());
+
+	if (mClients.IsValidIndex(handle) && mClients[handle].IsValid())
+	{
+		// Ranges in flight keep the client alive but no longer call it.
+		mClients[handle]->bActive = false;
+		mClients[handle].Reset();
+	}
+}
+
+FVector2D* FOceanSampleBatcher::WritePoints(int32 handle, int32 count, uint32& outSerial)
+{
+	check(IsInGameThread());
+	check(mClients.IsValidIndex(handle) && mClients[handle].IsValid());
+
+	FRange range;
+	range.Client = mClients[handle];
+	range.Offset = mPendingPoints.AddUninitialized(count);
+	range.Num = count;
+	mPendingRanges.Add(range);
+
+	outSerial = mPendingSerial;
+
+	return mPendingPoints.GetData() + range.Offset;
+}
+
+void FOceanSampleBatcher::Tick(float DeltaTime)
+{
+	if (mPendingRanges.Num() == 0)
+	{
+		return;
+	}
+
+	BUOYANCY_SCOPE(BatchSubmit, INDEX_NONE);
+	INC_DWORD_STAT_BY(STAT_BuoyancySamplesBatched, mPendingPoints.Num());
+
+	// A request that never comes back only takes its own slot out of rotation.
+	int32 slot = INDEX_NONE;
+	int32 inFlight = 0;
+	for (int32 i = 0; i < SubmissionSlots; ++i)
+	{
+		if (mSubmissions[i].bInFlight)
+		{
+			++inFlight;
+		}
+		else if (slot == INDEX_NONE)
+		{
+			slot = i;
+		}
+	}
+	INC_DWORD_STAT_BY(STAT_BuoyancyRequestsInFlight, inFlight);
+
+	if (slot != INDEX_NONE)
+	{
+		FSubmission& submission = mSubmissions[slot];
+		submission.Ranges.Reset();
+		submission.Ranges.Append(mPendingRanges);
+		submission.Serial = mPendingSerial;
+		submission.bInFlight = true;
+
+		if (!submission.OnDisplacements.IsBound())
+		{
+			submission.OnDisplacements = FVectorArrayDelegate::CreateThreadSafeSP(AsShared(), &FOceanSampleBatcher::OnDisplacements, slot);
+		}
+
+		mOcean->SampleDisplacements(mPendingPoints, submission.OnDisplacements);
+	}
+
+	// With every slot waiting the components keep their previous heights for one more frame.
+	mPendingPoints.Reset();
+	mPendingRanges.Reset();
+	++mPendingSerial;
+}
+
+void FOceanSampleBatcher::OnDisplacements(const TArray<FVector4>& displacements, int32 slot)
+{
+	BUOYANCY_SCOPE(Readback, INDEX_NONE);
+
+	FSubmission& submission = mSubmissions[slot];
+	for (const FRange& range : submission.Ranges)
+	{
+		if (range.Client->bActive && ((range.Offset + range.Num) <= displacements.Num()))
+		{
+			range.Client->OnSamples.ExecuteIfBound(displacements.GetData() + range.Offset, range.Num, submission.Serial);
+		}
+	}
+
+	submission.bInFlight = false;
+}
+
+bool FOceanSampleBatcher::IsTickable() const
+{
+	return mWorld.IsValid();
+}
+
+TStatId FOceanSampleBatcher::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FOceanSampleBatcher, STATGROUP_Tickables);
+}
+
+UWorld* FOceanSampleBatcher::GetTickableGameObjectWorld() const
+{
+	return mWorld.Get();
+}
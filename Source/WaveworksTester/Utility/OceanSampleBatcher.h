@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Tickable.h"
+#include "OceanQuery.h"
+
+// Displacements (m) of one client's points in the order it wrote them, and the serial WritePoints returned for them.
+DECLARE_DELEGATE_ThreeParams(FOceanSampleRangeDelegate, const FVector4* /* Displacements */, int32 /* Num */, uint32 /* Serial */);
+
+/**
+ * Collects the sample points of every floating component using the same asynchronous ocean and sends them as one
+ * contiguous SampleDisplacements request at the end of the frame, instead of one readback job per component.
+ * The results are scattered back to each component through its index range in the batch.
+ * Synchronous oceans have no per request overhead and are sampled directly by the components instead.
+ */
+class WAVEWORKSTESTER_API FOceanSampleBatcher : public FTickableGameObject, public TSharedFromThis<FOceanSampleBatcher, ESPMode::ThreadSafe>
+{
+public:
+	// One batcher per ocean actor, kept until the actor is gone. Game thread only.
+	static TSharedPtr<FOceanSampleBatcher, ESPMode::ThreadSafe> Get(UWorld* world, AActor* oceanActor);
+
+	FOceanSampleBatcher(UWorld* world, AActor* oceanActor);
+
+	// The delegate is called on the thread the ocean answers on, the render thread for WaveWorks.
+	int32 Register(const FOceanSampleRangeDelegate& onSamples);
+
+	// Results still in flight for the client are dropped.
+	void Unregister(int32 handle);
+
+	// Space for count points (m) in this frame's batch. Fill it right away, the next call may move it.
+	// outSerial identifies the batch, so the client can tell which of its requests an answer belongs to.
+	FVector2D* WritePoints(int32 handle, int32 count, uint32& outSerial);
+
+	// Sends the batch, after every actor and component has ticked.
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+private:
+	struct FClient
+	{
+		FOceanSampleRangeDelegate OnSamples;
+		FThreadSafeBool bActive;
+	};
+
+	typedef TSharedPtr<FClient, ESPMode::ThreadSafe> FClientPtr;
+
+	struct FRange
+	{
+		FClientPtr Client;
+		int32 Offset;
+		int32 Num;
+	};
+
+	// Layout of one request until its results come back.
+	struct FSubmission
+	{
+		TArray<FRange> Ranges;
+		uint32 Serial;
+		FVectorArrayDelegate OnDisplacements;
+		FThreadSafeBool bInFlight;
+	};
+
+	// WaveWorks answers a few frames later, so several requests can be in flight at once.
+	static const int32 SubmissionSlots = 8;
+
+	void OnDisplacements(const TArray<FVector4>& displacements, int32 slot);
+
+	static TMap<TWeakObjectPtr<AActor>, TSharedPtr<FOceanSampleBatcher, ESPMode::ThreadSafe>> Batchers;
+
+	TWeakObjectPtr<UWorld> mWorld;
+	TSharedPtr<IOceanQuery> mOcean;
+
+	// Indexed by handle, null for free handles.
+	TArray<FClientPtr> mClients;
+
+	// This frame's batch, reused every frame.
+	TArray<FVector2D> mPendingPoints;
+	TArray<FRange> mPendingRanges;
+	uint32 mPendingSerial;
+
+	FSubmission mSubmissions[SubmissionSlots];
+};
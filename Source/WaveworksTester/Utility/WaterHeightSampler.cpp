@@ -0,0 +1,193 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+#include "WaterHeightSampler.h"
+#include "BuoyancyStats.h"
+
+// Longest time (s) the heights are extrapolated past the latest sample, beyond that they are held.
+static const double MaxExtrapolationTime = 0.2;
+
+FWaterHeightSampler::FWaterHeightSampler(UWorld* world, AActor* oceanActor) :
+	mOcean(IOceanQuery::Create(world, oceanActor)), mBatcherHandle(INDEX_NONE), mGridSpacing(0.0f), mRequestInterval(0.0f),
+	mLayout(HullKernel::PerPointHeightGrid(0)), mHasLayout(false), mLastRequestTime(0.0), mLastSequence(0)
+{
+	for (FPendingRequest& request : mPendingRequests)
+	{
+		request.Serial = 0;
+	}
+
+	if (!mOcean->IsSynchronous())
+	{
+		mBatcher = FOceanSampleBatcher::Get(world, oceanActor);
+	}
+}
+
+void FWaterHeightSampler::Initialize(int32 maxPoints, float extent)
+{
+	// Room for the largest grid as well, so neither thread allocates once the hull is moving.
+	if (mGridSpacing > 0.0f)
+	{
+		maxPoints = FMath::Max(maxPoints, HullKernel::MaxHeightGridNodes(extent, mGridSpacing, mGridSpacing));
+	}
+
+	mNodeX.Reserve(maxPoints);
+	mNodeY.Reserve(maxPoints);
+	mNodeHeights.Reserve(maxPoints);
+	mEvaluatedHeights.Reserve(maxPoints);
+	mHistory.Reserve(maxPoints);
+	mHandoff.Reserve(maxPoints * HandoffChannels);
+	mInversion.Reserve(maxPoints);
+
+	if (mBatcher.IsValid())
+	{
+		mBatcherHandle = mBatcher->Register(FOceanSampleRangeDelegate::CreateThreadSafeSP(AsShared(), &FWaterHeightSampler::OnDisplacements));
+	}
+}
+
+void FWaterHeightSampler::Unregister()
+{
+	if (mBatcher.IsValid())
+	{
+		mBatcher->Unregister(mBatcherHandle);
+		mBatcher.Reset();
+	}
+}
+
+void FWaterHeightSampler::SetQuality(float gridSpacing, float requestInterval)
+{
+	mGridSpacing = FMath::Max(gridSpacing, 0.0f);
+	mRequestInterval = FMath::Max(requestInterval, 0.0f);
+}
+
+void FWaterHeightSampler::Request(const float* x, const float* y, int32 count, double time)
+{
+	const bool bPerPoint = (mGridSpacing <= 0.0f);
+	const bool bQualityChanged = (bPerPoint != mLayout.IsPerPoint()) || (!bPerPoint && (mLayout.CellSize != mGridSpacing));
+
+	const bool bNewLayout = !mHasLayout || bQualityChanged || !HullKernel::HeightGridCovers(mLayout, x, y, count, 0.0f);
+	if (bNewLayout)
+	{
+		// One cell of margin, so the hull can drift that far before the grid has to move.
+		mLayout = bPerPoint ? HullKernel::PerPointHeightGrid(count) : HullKernel::FitHeightGrid(x, y, count, mGridSpacing, mGridSpacing);
+		mHasLayout = true;
+	}
+	else if (!mHistory.IsEmpty() && ((time - mLastRequestTime) < mRequestInterval))
+	{
+		// Still inside the grid and the heights are recent enough to extrapolate.
+		return;
+	}
+	mLastRequestTime = time;
+
+	const int32 numNodes = mLayout.NumNodes();
+	INC_DWORD_STAT_BY(STAT_BuoyancySamplesRequested, numNodes);
+	mNodeX.SetNumUninitialized(numNodes, false);
+	mNodeY.SetNumUninitialized(numNodes, false);
+	if (bPerPoint)
+	{
+		FMemory::Memcpy(mNodeX.GetData(), x, numNodes * sizeof(float));
+		FMemory::Memcpy(mNodeY.GetData(), y, numNodes * sizeof(float));
+	}
+	else
+	{
+		HullKernel::HeightGridNodePositions(mLayout, mNodeX.GetData(), mNodeY.GetData());
+	}
+
+	if (mOcean->IsSynchronous())
+	{
+		mNodeHeights.SetNumUninitialized(numNodes, false);
+		mOcean->SampleHeights(mNodeX.GetData(), mNodeY.GetData(), numNodes, mNodeHeights.GetData());
+		mHistory.Add(mLayout, mNodeHeights.GetData(), time);
+		return;
+	}
+
+	// Offsets of another layout belong to other nodes, the new ones start from the nodes themselves.
+	if (bNewLayout || (mInversion.NumPoints() != numNodes))
+	{
+		mInversion.Reset(numNodes);
+	}
+
+	uint32 serial;
+	FVector2D* points = mBatcher->WritePoints(mBatcherHandle, numNodes, serial);
+	const float* offsetX = mInversion.OffsetX();
+	const float* offsetY = mInversion.OffsetY();
+	for (int32 node = 0; node < numNodes; ++node)
+	{
+		points[node] = FVector2D((mNodeX[node] / 100.0f) - offsetX[node], (mNodeY[node] / 100.0f) - offsetY[node]);
+	}
+
+	FPendingRequest& request = mPendingRequests[serial % PendingRequestSlots];
+	request.Serial = serial;
+	request.Layout = mLayout;
+	request.Time = time;
+	request.Frame = GFrameCounter;
+}
+
+void FWaterHeightSampler::OnDisplacements(const FVector4* displacements, int32 num, uint32 serial)
+{
+	const float seaLevel = mOcean->GetSeaLevel();
+
+	float* heights = mHandoff.BeginWrite(num * HandoffChannels);
+	float* offsetX = heights + num;
+	float* offsetY = offsetX + num;
+	for (int32 i = 0; i < num; ++i)
+	{
+		heights[i] = (displacements[i].Z * 100.0f) + seaLevel;
+		offsetX[i] = displacements[i].X;
+		offsetY[i] = displacements[i].Y;
+	}
+	mHandoff.Publish(serial);
+}
+
+void FWaterHeightSampler::Update()
+{
+	// Latest heights published by the render thread, matched back to the grid they were requested for.
+	const HullKernel::FHeightSnapshot snapshot = mHandoff.Acquire();
+	if (snapshot.Sequence != mLastSequence)
+	{
+		mLastSequence = snapshot.Sequence;
+
+		const FPendingRequest& request = mPendingRequests[snapshot.Tag % PendingRequestSlots];
+		const int32 numNodes = request.Layout.NumNodes();
+		if ((request.Serial == snapshot.Tag) && ((numNodes * HandoffChannels) == snapshot.Num))
+		{
+			mHistory.Add(request.Layout, snapshot.Heights, request.Time);
+			SET_DWORD_STAT(STAT_BuoyancyReadbackLatency, GFrameCounter - request.Frame);
+
+			// The next request of the same nodes samples where this answer says their water came from.
+			if (request.Layout == mLayout)
+			{
+				mInversion.Advance(snapshot.Heights + numNodes, snapshot.Heights + (2 * numNodes), numNodes);
+			}
+		}
+	}
+}
+
+bool FWaterHeightSampler::Evaluate(const float* x, const float* y, int32 count, double time, float* outHeights)
+{
+	// Per point samples only fit the same number of points, e.g. not right after a hull LOD switch.
+	const HullKernel::FHeightGridLayout& layout = mHistory.Layout();
+	if (mHistory.IsEmpty() || (layout.IsPerPoint() && (layout.NumX != count)))
+	{
+		return false;
+	}
+
+	mEvaluatedHeights.SetNumUninitialized(layout.NumNodes(), false);
+	mHistory.Evaluate(time, MaxExtrapolationTime, mEvaluatedHeights.GetData());
+	HullKernel::InterpolateHeightGrid(layout, mEvaluatedHeights.GetData(), x, y, count, outHeights);
+	return true;
+}
+
+bool FWaterHeightSampler::EvaluateGrid(double time, HullKernel::FHeightGridLayout& outLayout, const float*& outNodeHeights)
+{
+	const HullKernel::FHeightGridLayout& layout = mHistory.Layout();
+	if (mHistory.IsEmpty() || layout.IsPerPoint())
+	{
+		return false;
+	}
+
+	mEvaluatedHeights.SetNumUninitialized(layout.NumNodes(), false);
+	mHistory.Evaluate(time, MaxExtrapolationTime, mEvaluatedHeights.GetData());
+	outLayout = layout;
+	outNodeHeights = mEvaluatedHeights.GetData();
+	return true;
+}
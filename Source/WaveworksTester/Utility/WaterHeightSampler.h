@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HullKernel/DisplacementInversion.h"
+#include "HullKernel/HeightGrid.h"
+#include "HullKernel/HeightHandoff.h"
+#include "OceanSampleBatcher.h"
+
+/**
+ * Water heights under a set of points that move every tick, such as the vertices of a hull.
+ * Instead of every point it samples a coarse grid under them and interpolates bilinearly. The grid stays in place
+ * while the points move around inside it, and between requests the last two samples are extrapolated in time.
+ * Requests go to the CPU ocean synchronously, or into the per frame WaveWorks batch. Either way the heights are the
+ * ones of the water right above the nodes: the CPU ocean inverts the choppy displacement within the request, the
+ * WaveWorks requests are moved by the horizontal displacement of the previous answer, one iteration per round trip.
+ * Game thread only, apart from the WaveWorks callback and Evaluate, which the physics thread may call while the
+ * game thread leaves the sampler alone.
+ */
+class WAVEWORKSTESTER_API FWaterHeightSampler : public TSharedFromThis<FWaterHeightSampler, ESPMode::ThreadSafe>
+{
+public:
+	FWaterHeightSampler(UWorld* world, AActor* oceanActor);
+
+	// Preallocates for up to maxPoints points spread over at most extent (cm) horizontally, at the current quality,
+	// and joins the WaveWorks batch. Call once right after construction and SetQuality.
+	void Initialize(int32 maxPoints, float extent);
+
+	// Leaves the WaveWorks batch, answers still in flight are dropped.
+	void Unregister();
+
+	// Grid spacing (cm), zero samples every point. Seconds between requests while the points stay inside the grid.
+	void SetQuality(float gridSpacing, float requestInterval);
+
+	// Sends a request for this tick's points when the interval is up or they left the grid.
+	void Request(const float* x, const float* y, int32 count, double time);
+
+	// Takes in the samples that arrived since the last call.
+	void Update();
+
+	// Heights (cm) under the points at time, from the samples taken in by the last Update.
+	// False until samples that fit the points have arrived.
+	bool Evaluate(const float* x, const float* y, int32 count, double time, float* outHeights);
+
+	// Node heights (cm) of the whole grid at time, for users that work on the grid itself. Valid until the next
+	// Evaluate or EvaluateGrid. False like Evaluate, and for per point sampling.
+	bool EvaluateGrid(double time, HullKernel::FHeightGridLayout& outLayout, const float*& outNodeHeights);
+
+	bool IsSynchronous() const { return mOcean->IsSynchronous(); }
+
+private:
+	// Called on the render thread with the displacements of the grid nodes.
+	void OnDisplacements(const FVector4* displacements, int32 num, uint32 serial);
+
+	struct FPendingRequest
+	{
+		uint32 Serial;
+		HullKernel::FHeightGridLayout Layout;
+		double Time;
+
+		// GFrameCounter when the request went out, for the readback latency stat.
+		uint64 Frame;
+	};
+
+	// More than the batcher can have in flight, so an answer always finds its request.
+	static const int32 PendingRequestSlots = 16;
+
+	// The WaveWorks callback hands over the heights of the nodes followed by their horizontal displacements X and Y.
+	static const int32 HandoffChannels = 3;
+
+	TSharedPtr<IOceanQuery> mOcean;
+	TSharedPtr<FOceanSampleBatcher, ESPMode::ThreadSafe> mBatcher;
+	int32 mBatcherHandle;
+
+	float mGridSpacing;
+	float mRequestInterval;
+
+	// Grid the requests currently go out for.
+	HullKernel::FHeightGridLayout mLayout;
+	bool mHasLayout;
+	double mLastRequestTime;
+
+	FPendingRequest mPendingRequests[PendingRequestSlots];
+
+	// Node heights from the WaveWorks callback, tagged with the serial of their request.
+	HullKernel::FHeightHandoff mHandoff;
+	uint64 mLastSequence;
+
+	// Offsets (m) the WaveWorks requests of the current layout sample the nodes at.
+	HullKernel::FDisplacementInversion mInversion;
+
+	HullKernel::FHeightGridHistory mHistory;
+
+	TArray<float> mNodeX;
+	TArray<float> mNodeY;
+	TArray<float> mNodeHeights;
+
+	// Node heights at the time of the last Evaluate, apart from the request buffers so both can run in one frame.
+	TArray<float> mEvaluatedHeights;
+};
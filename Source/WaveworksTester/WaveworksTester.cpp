@@ -1,5 +1,5 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#include "WaveworksTester.h"
-
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, WaveworksTester, "WaveworksTester" );
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WaveworksTester.h"
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, WaveworksTester, "WaveworksTester" );